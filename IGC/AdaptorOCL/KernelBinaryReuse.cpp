@@ -0,0 +1,650 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "AdaptorOCL/KernelBinaryReuse.hpp"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataApi/MetaDataApi.h"
+#include "common/MDFrameWork.h"
+#include "common/igc_regkeys.hpp"
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include "Probe/Assertion.h"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+namespace
+{
+    // Process-wide store of kernel binaries, evicted in insertion order.
+    class KernelBinaryStore
+    {
+    public:
+        static KernelBinaryStore& Get()
+        {
+            static KernelBinaryStore store;
+            return store;
+        }
+
+        bool Find(const KernelBinaryReuse::Fingerprint& key,
+            std::vector<KernelBinaryReuse::StoredBinary>& binaries)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            if (it == m_entries.end())
+            {
+                return false;
+            }
+            binaries = it->second;
+            return true;
+        }
+
+        void Insert(const KernelBinaryReuse::Fingerprint& key,
+            std::vector<KernelBinaryReuse::StoredBinary>&& binaries)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_entries.emplace(key, std::move(binaries)).second)
+            {
+                return;
+            }
+            m_order.push_back(key);
+            while (m_order.size() > IGC_GET_FLAG_VALUE(KernelBinaryReuseCapacity))
+            {
+                m_entries.erase(m_order.front());
+                m_order.pop_front();
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::map<KernelBinaryReuse::Fingerprint, std::vector<KernelBinaryReuse::StoredBinary>> m_entries;
+        std::list<KernelBinaryReuse::Fingerprint> m_order;
+    };
+
+    // Hashes IR and metadata without anything that depends on the order in
+    // which the module was built, such as metadata slot numbers or the
+    // numbering of custom metadata kinds, so that an unchanged kernel keeps
+    // its fingerprint when other kernels of the program change.
+    class FingerprintBuilder
+    {
+    public:
+        // Everything hashed is also written to dump, if given.
+        explicit FingerprintBuilder(const Module& M, raw_ostream* dump = nullptr)
+            : m_dump(dump)
+        {
+            M.getContext().getMDKindNames(m_mdKindNames);
+        }
+
+        void Add(StringRef S)
+        {
+            uint64_t size = S.size();
+            m_hash.update(ArrayRef<uint8_t>((const uint8_t*)&size, sizeof(size)));
+            m_hash.update(S);
+            if (m_dump)
+            {
+                *m_dump << S << "\n";
+            }
+        }
+
+        void Add(const Metadata* MD)
+        {
+            DenseMap<const MDNode*, unsigned> visited;
+            AddMetadata(MD, visited);
+        }
+
+        // Prints F or GV and drops the metadata and attribute group slot
+        // references from the text. Attachments and attributes are hashed by
+        // content instead, and so are the bodies of the named struct types,
+        // which the text only refers to by name.
+        void Add(const GlobalObject& GO)
+        {
+            std::string text;
+            raw_string_ostream os(text);
+            GO.print(os);
+            os.flush();
+
+            std::string stripped;
+            stripped.reserve(text.size());
+            for (size_t i = 0, e = text.size(); i < e; ++i)
+            {
+                stripped.push_back(text[i]);
+                if ((text[i] == '!' || text[i] == '#') &&
+                    i + 1 < e && isdigit((unsigned char)text[i + 1]))
+                {
+                    while (i + 1 < e && isdigit((unsigned char)text[i + 1]))
+                    {
+                        ++i;
+                    }
+                }
+            }
+            Add(stripped);
+
+            SmallVector<std::pair<unsigned, MDNode*>, 4> MDs;
+            GO.getAllMetadata(MDs);
+            AddAttachments(MDs);
+            AddStructBodies(GO.getValueType());
+            if (auto* GV = dyn_cast<GlobalVariable>(&GO))
+            {
+                Add(GV->getAttributes().getAsString());
+                if (GV->hasInitializer())
+                {
+                    AddStructBodies(GV->getInitializer());
+                }
+            }
+            else if (auto* F = dyn_cast<Function>(&GO))
+            {
+                // Parameter and return attributes are printed inline.
+                Add(F->getAttributes().getAsString(AttributeList::FunctionIndex));
+                for (auto& I : instructions(*F))
+                {
+                    MDs.clear();
+                    I.getAllMetadata(MDs);
+                    AddAttachments(MDs);
+                    if (auto* CI = dyn_cast<CallInst>(&I))
+                    {
+                        Add(CI->getAttributes().getAsString(AttributeList::FunctionIndex));
+                    }
+                    AddStructBodies(&I);
+                }
+            }
+        }
+
+        KernelBinaryReuse::Fingerprint Final()
+        {
+            MD5::MD5Result result;
+            m_hash.final(result);
+            return std::make_pair(result.high(), result.low());
+        }
+
+    private:
+        // Hashes the body of every named struct type reachable from Ty the
+        // first time it is seen.
+        void AddStructBodies(Type* Ty)
+        {
+            if (!m_visitedTypes.insert(Ty).second)
+            {
+                return;
+            }
+            auto* ST = dyn_cast<StructType>(Ty);
+            if (ST && !ST->isLiteral())
+            {
+                std::string text;
+                raw_string_ostream os(text);
+                ST->print(os);
+                Add(os.str());
+            }
+            for (Type* subtype : Ty->subtypes())
+            {
+                AddStructBodies(subtype);
+            }
+        }
+
+        // Looks at the types of V and of its operands, through constant
+        // expressions, including the types that only GEPs and allocas name.
+        void AddStructBodies(const User* V)
+        {
+            AddStructBodies(V->getType());
+            if (auto* GEP = dyn_cast<GEPOperator>(V))
+            {
+                AddStructBodies(GEP->getSourceElementType());
+            }
+            else if (auto* AI = dyn_cast<AllocaInst>(V))
+            {
+                AddStructBodies(AI->getAllocatedType());
+            }
+            for (auto& Op : V->operands())
+            {
+                AddStructBodies(Op->getType());
+                auto* C = dyn_cast<Constant>(Op.get());
+                if (C && !isa<GlobalValue>(C) && m_visitedConstants.insert(C).second)
+                {
+                    AddStructBodies(C);
+                }
+            }
+        }
+
+        void AddAttachments(ArrayRef<std::pair<unsigned, MDNode*>> MDs)
+        {
+            uint64_t count = MDs.size();
+            m_hash.update(ArrayRef<uint8_t>((const uint8_t*)&count, sizeof(count)));
+            for (auto& KindAndNode : MDs)
+            {
+                Add(KindAndNode.first < m_mdKindNames.size() ?
+                    m_mdKindNames[KindAndNode.first] : StringRef("?"));
+                Add(KindAndNode.second);
+            }
+        }
+
+        void AddMetadata(const Metadata* MD, DenseMap<const MDNode*, unsigned>& visited)
+        {
+            if (MD == nullptr)
+            {
+                Add("null");
+            }
+            else if (auto* S = dyn_cast<MDString>(MD))
+            {
+                Add("S");
+                Add(S->getString());
+            }
+            else if (auto* V = dyn_cast<ValueAsMetadata>(MD))
+            {
+                Add("V");
+                AddValue(V->getValue());
+            }
+            else if (auto* N = dyn_cast<MDNode>(MD))
+            {
+                // Back-references by visiting order keep cycles finite.
+                auto it = visited.find(N);
+                if (it != visited.end())
+                {
+                    Add("R");
+                    Add(std::to_string(it->second));
+                    return;
+                }
+                unsigned id = visited.size();
+                visited[N] = id;
+                Add("N");
+                Add(std::to_string(N->getNumOperands()));
+                for (auto& Op : N->operands())
+                {
+                    AddMetadata(Op.get(), visited);
+                }
+            }
+            else
+            {
+                Add("?");
+            }
+        }
+
+        void AddValue(const Value* V)
+        {
+            if (auto* GV = dyn_cast<GlobalValue>(V))
+            {
+                Add(GV->getName());
+                return;
+            }
+            std::string text;
+            raw_string_ostream os(text);
+            V->print(os);
+            Add(os.str());
+        }
+
+        MD5 m_hash;
+        SmallVector<StringRef, 32> m_mdKindNames;
+        SmallPtrSet<Type*, 16> m_visitedTypes;
+        SmallPtrSet<const Constant*, 16> m_visitedConstants;
+        raw_ostream* m_dump;
+    };
+
+    // Collects the functions and global variables referenced from V, looking
+    // through constant expressions and aggregates.
+    void CollectGlobals(const Value* V, SetVector<const GlobalObject*>& globals,
+        SmallPtrSetImpl<const Constant*>& visitedConstants)
+    {
+        auto* C = dyn_cast<Constant>(V);
+        if (!C || !visitedConstants.insert(C).second)
+        {
+            return;
+        }
+        if (auto* GO = dyn_cast<GlobalObject>(C))
+        {
+            globals.insert(GO);
+            return;
+        }
+        for (auto& Op : C->operands())
+        {
+            CollectGlobals(Op.get(), globals, visitedConstants);
+        }
+    }
+
+    // Collects the kernel and everything it references, in visiting order.
+    void CollectClosure(const Function* kernel, SetVector<const GlobalObject*>& globals)
+    {
+        SmallPtrSet<const Constant*, 32> visitedConstants;
+        globals.insert(kernel);
+        for (unsigned i = 0; i < globals.size(); ++i)
+        {
+            auto* F = dyn_cast<Function>(globals[i]);
+            if (F == nullptr)
+            {
+                if (auto* GV = dyn_cast<GlobalVariable>(globals[i]))
+                {
+                    if (GV->hasInitializer())
+                    {
+                        CollectGlobals(GV->getInitializer(), globals, visitedConstants);
+                    }
+                }
+                continue;
+            }
+            for (auto& I : instructions(*F))
+            {
+                for (auto& Op : I.operands())
+                {
+                    CollectGlobals(Op.get(), globals, visitedConstants);
+                }
+            }
+        }
+    }
+}
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-print-kernel-fingerprints"
+#define PASS_DESCRIPTION "Print what the kernel binary reuse hashes for the IR of each kernel"
+#define PASS_CFG_ONLY true
+#define PASS_ANALYSIS true
+IGC_INITIALIZE_PASS_BEGIN(PrintKernelFingerprints, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_END(PrintKernelFingerprints, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+#undef PASS_ANALYSIS
+#undef PASS_CFG_ONLY
+#undef PASS_DESCRIPTION
+#undef PASS_FLAG
+
+char PrintKernelFingerprints::ID = 0;
+
+PrintKernelFingerprints::PrintKernelFingerprints() : ModulePass(ID)
+{
+    initializePrintKernelFingerprintsPass(*PassRegistry::getPassRegistry());
+}
+
+bool PrintKernelFingerprints::runOnModule(Module& M)
+{
+    for (auto& F : M)
+    {
+        if (F.getCallingConv() != CallingConv::SPIR_KERNEL)
+        {
+            continue;
+        }
+        SetVector<const GlobalObject*> globals;
+        CollectClosure(&F, globals);
+
+        outs() << "kernel " << F.getName() << "\n";
+        FingerprintBuilder kernelHash(M, &outs());
+        for (const GlobalObject* GO : globals)
+        {
+            kernelHash.Add(*GO);
+        }
+        KernelBinaryReuse::Fingerprint fingerprint = kernelHash.Final();
+        outs() << "fingerprint " << format_hex_no_prefix(fingerprint.first, 16)
+            << format_hex_no_prefix(fingerprint.second, 16) << "\n";
+    }
+    return false;
+}
+
+KernelBinaryReuse::KernelBinaryReuse(StringRef options, StringRef internalOptions)
+    : m_options(options.str()), m_internalOptions(internalOptions.str())
+{
+    // The zebin writer and binary overrides work on the compiled kernels
+    // themselves, so they would not see stored ones.
+    m_enabled = IGC_IS_FLAG_ENABLED(EnableKernelBinaryReuse) &&
+        IGC_IS_FLAG_DISABLED(EnableZEBinary) &&
+        IGC_IS_FLAG_DISABLED(ShaderOverride);
+}
+
+void KernelBinaryReuse::RemoveStoredKernels(OpenCLProgramContext& ctx)
+{
+    m_kernels.clear();
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    Module* M = ctx.getModule();
+    MetaDataUtils* pMdUtils = ctx.getMetaDataUtils();
+    ModuleMetaData* modMD = ctx.getModuleMetaData();
+
+    // Debug info refers to the whole program, GTPin instruments every kernel
+    // it is given, and the symbol table of indirectly called functions is
+    // emitted with one of the kernels.
+    if (ctx.m_InternalOptions.KernelDebugEnable || ctx.gtpin_init ||
+        M->getNamedMetadata("llvm.dbg.cu"))
+    {
+        m_enabled = false;
+        return;
+    }
+    // Program-scope globals are laid out after optimization, so their
+    // offsets in a stored binary could be stale once other kernels change.
+    for (auto& GV : M->globals())
+    {
+        if (GV.getType()->getAddressSpace() != ADDRESS_SPACE_LOCAL && !GV.use_empty())
+        {
+            m_enabled = false;
+            return;
+        }
+    }
+    std::vector<Function*> kernels;
+    for (auto& F : *M)
+    {
+        if (F.hasFnAttribute("IndirectlyCalled"))
+        {
+            m_enabled = false;
+            return;
+        }
+        if (isEntryFunc(pMdUtils, &F))
+        {
+            kernels.push_back(&F);
+        }
+    }
+    if (kernels.empty())
+    {
+        return;
+    }
+
+    // The unique entry carries the program's symbol table, so it is always
+    // compiled. Resolve it before hashing since this may update FuncMD.
+    Function* uniqueEntry = getUniqueEntryFunc(pMdUtils, modMD);
+
+    pMdUtils->save(M->getContext());
+    Module scratch("KernelBinaryReuse", M->getContext());
+    serialize(*modMD, &scratch, true);
+    MDNode* moduleMDNode = scratch.getNamedMetadata("IGCMetadata")->getOperand(0);
+
+    // Everything in ModuleMetaData but FuncMD is program wide.
+    FingerprintBuilder programHash(*M);
+    programHash.Add(m_options);
+    programHash.Add(m_internalOptions);
+    programHash.Add(StringRef((const char*)&ctx.platform, sizeof(ctx.platform)));
+    programHash.Add(M->getDataLayoutStr());
+    std::map<const Function*, const MDNode*> funcMD;
+    for (unsigned i = 1, e = moduleMDNode->getNumOperands(); i < e; ++i)
+    {
+        auto* field = dyn_cast_or_null<MDNode>(moduleMDNode->getOperand(i).get());
+        auto* fieldName = field ? dyn_cast_or_null<MDString>(field->getOperand(0).get()) : nullptr;
+        if (fieldName && fieldName->getString() == "FuncMD")
+        {
+            // Key and value nodes alternate after the name.
+            for (unsigned j = 1; j + 1 < field->getNumOperands(); j += 2)
+            {
+                auto* key = cast<MDNode>(field->getOperand(j).get());
+                auto* F = cast<Function>(cast<ValueAsMetadata>(key->getOperand(1).get())->getValue());
+                funcMD[F] = cast<MDNode>(field->getOperand(j + 1).get());
+            }
+            continue;
+        }
+        programHash.Add(field);
+    }
+    Fingerprint programKey = programHash.Final();
+
+    std::map<const Function*, const MDNode*> funcInfo;
+    if (NamedMDNode* functionsInfo = M->getNamedMetadata("igc.functions"))
+    {
+        for (MDNode* entry : functionsInfo->operands())
+        {
+            auto* V = dyn_cast_or_null<ValueAsMetadata>(entry->getOperand(0).get());
+            if (V)
+            {
+                funcInfo[cast<Function>(V->getValue())] = entry;
+            }
+        }
+    }
+
+    std::vector<Function*> toRemove;
+    for (Function* kernel : kernels)
+    {
+        SetVector<const GlobalObject*> globals;
+        CollectClosure(kernel, globals);
+
+        FingerprintBuilder kernelHash(*M);
+        kernelHash.Add(StringRef((const char*)&programKey, sizeof(programKey)));
+        for (const GlobalObject* GO : globals)
+        {
+            kernelHash.Add(*GO);
+            if (auto* F = dyn_cast<Function>(GO))
+            {
+                auto md = funcMD.find(F);
+                kernelHash.Add(md != funcMD.end() ? md->second : nullptr);
+                auto info = funcInfo.find(F);
+                kernelHash.Add(info != funcInfo.end() ? info->second : nullptr);
+            }
+        }
+
+        Kernel K;
+        K.name = kernel->getName().str();
+        K.fingerprint = kernelHash.Final();
+        K.reused = kernel != uniqueEntry && kernel->use_empty() &&
+            KernelBinaryStore::Get().Find(K.fingerprint, K.binaries);
+        if (K.reused)
+        {
+            toRemove.push_back(kernel);
+        }
+        m_kernels.push_back(std::move(K));
+    }
+
+    for (Function* F : toRemove)
+    {
+        auto info = pMdUtils->findFunctionsInfoItem(F);
+        if (info != pMdUtils->end_FunctionsInfo())
+        {
+            pMdUtils->eraseFunctionsInfoItem(info);
+        }
+        modMD->FuncMD.erase(F);
+        F->eraseFromParent();
+    }
+    pMdUtils->save(M->getContext());
+}
+
+void KernelBinaryReuse::MergeKernelBinaries(OpenCLProgramContext& ctx)
+{
+    if (!m_enabled || m_kernels.empty())
+    {
+        return;
+    }
+
+    std::vector<iOpenCL::KernelData>& kernelBinaries = ctx.m_programOutput.m_KernelBinaries;
+    // Stored binaries carry the hash code of the program they were built for.
+    // The header checksum only covers what follows the header.
+    const uint64_t shaderHashCode = ctx.hash.getAsmHash();
+    // Kernels compiled with cheaper settings to meet a compile-time budget
+    // are not stored, so later builds without that pressure compile them
+    // in full.
+    const bool degraded =
+        ctx.m_programOutput.m_compileTimeDegradations != COMPILE_TIME_DEGRADE_NONE;
+
+    std::map<std::string, std::vector<size_t>> compiled;
+    for (size_t i = 0; i < kernelBinaries.size(); ++i)
+    {
+        compiled[kernelBinaries[i].kernelName].push_back(i);
+    }
+
+    std::vector<iOpenCL::KernelData> merged;
+    std::vector<bool> taken(kernelBinaries.size(), false);
+    for (Kernel& K : m_kernels)
+    {
+        if (K.reused)
+        {
+            for (StoredBinary& stored : K.binaries)
+            {
+                iOpenCL::KernelData data;
+                data.kernelName = K.name;
+                data.kernelBinary = new Util::BinaryStream();
+                data.kernelBinary->Write(stored.binary.data(), stored.binary.size());
+                data.kernelBinary->WriteAt(shaderHashCode,
+                    offsetof(iOpenCL::SKernelBinaryHeader, ShaderHashCode));
+                if (!stored.debugData.empty())
+                {
+                    data.kernelDebugData = new Util::BinaryStream();
+                    data.kernelDebugData->Write(stored.debugData.data(), stored.debugData.size());
+                }
+                merged.push_back(data);
+            }
+            continue;
+        }
+
+        auto it = compiled.find(K.name);
+        if (it == compiled.end())
+        {
+            continue;
+        }
+        std::vector<StoredBinary> binaries;
+        for (size_t i : it->second)
+        {
+            iOpenCL::KernelData& data = kernelBinaries[i];
+            merged.push_back(data);
+            taken[i] = true;
+            if (degraded)
+            {
+                continue;
+            }
+            StoredBinary stored;
+            const char* bin = data.kernelBinary->GetLinearPointer();
+            stored.binary.assign(bin, bin + data.kernelBinary->Size());
+            if (data.kernelDebugData && data.kernelDebugData->Size() > 0)
+            {
+                const char* dbg = data.kernelDebugData->GetLinearPointer();
+                stored.debugData.assign(dbg, dbg + data.kernelDebugData->Size());
+            }
+            binaries.push_back(std::move(stored));
+        }
+        if (!degraded)
+        {
+            KernelBinaryStore::Get().Insert(K.fingerprint, std::move(binaries));
+        }
+    }
+
+    // Anything the fingerprinting did not see keeps its position at the end.
+    for (size_t i = 0; i < kernelBinaries.size(); ++i)
+    {
+        if (!taken[i])
+        {
+            merged.push_back(kernelBinaries[i]);
+        }
+    }
+    kernelBinaries.swap(merged);
+}
@@ -0,0 +1,114 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+#include "Compiler/CodeGenPublic.h"
+#include "AdaptorOCL/OCL/sp/spp_g8.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace IGC
+{
+    // Reuses the patch-token binaries of kernels that have not changed since an
+    // earlier build in this process.
+    //
+    // After unification every kernel gets a fingerprint of its IR and the IR of
+    // its callees, the globals they reference, their function metadata, the
+    // program-wide metadata, the build options and the platform. Kernels whose
+    // fingerprint has a stored binary are dropped from the module before
+    // optimization and code generation; their binaries are spliced back in
+    // program order once the remaining kernels are compiled, and the newly
+    // compiled kernels are stored for later builds.
+    class KernelBinaryReuse
+    {
+    public:
+        KernelBinaryReuse(llvm::StringRef options, llvm::StringRef internalOptions);
+
+        // Fingerprints the kernels of the unified module and removes those
+        // with a stored binary. Called once per retry iteration.
+        void RemoveStoredKernels(OpenCLProgramContext& ctx);
+
+        // Merges the stored binaries into the freshly created kernel binaries
+        // in program order and stores the new ones, unless they were compiled
+        // under compile-time budget degradations.
+        void MergeKernelBinaries(OpenCLProgramContext& ctx);
+
+        typedef std::pair<uint64_t, uint64_t> Fingerprint;
+
+        struct StoredBinary
+        {
+            std::vector<char> binary;
+            std::vector<char> debugData;
+        };
+
+    private:
+        struct Kernel
+        {
+            std::string name;
+            Fingerprint fingerprint;
+            bool reused = false;
+            std::vector<StoredBinary> binaries;
+        };
+
+        bool m_enabled;
+        std::string m_options;
+        std::string m_internalOptions;
+        // Kernels of the program in module order
+        std::vector<Kernel> m_kernels;
+    };
+
+    /*
+    Prints, for every kernel of the module, everything its fingerprint hashes
+    from the IR and the resulting fingerprint of that part. Only used by
+    igc_opt.
+    */
+    class PrintKernelFingerprints : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+
+        PrintKernelFingerprints();
+
+        ~PrintKernelFingerprints() {}
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "PrintKernelFingerprints";
+        }
+
+        virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
+        {
+            AU.setPreservesAll();
+        }
+
+        virtual bool runOnModule(llvm::Module& M) override;
+    };
+}
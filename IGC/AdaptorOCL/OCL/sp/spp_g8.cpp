@@ -328,6 +328,7 @@ void CGen8OpenCLProgram::CreateKernelBinaries()
 
             // Create the kernel binary streams
             KernelData data;
+            data.kernelName = kernel->m_kernelInfo.m_kernelName;
             data.kernelBinary = new Util::BinaryStream();
 
             m_StateProcessor.CreateKernelBinary(
@@ -56,6 +56,7 @@ struct KernelData
 {
     Util::BinaryStream* kernelBinary = nullptr;
     Util::BinaryStream* kernelDebugData = nullptr;
+    std::string kernelName;
 };
 
 // This is the base class to create an OpenCL ELF binary with patch tokens.
@@ -83,6 +84,9 @@ public:
 
     USC::SSystemThreadKernelOutput* m_pSystemThreadKernelOutput = nullptr;
 
+    // CompileTimeDegradation mask the program was compiled with
+    unsigned m_compileTimeDegradations = 0;
+
     PLATFORM getPlatform() const { return m_Platform; }
 
 public:
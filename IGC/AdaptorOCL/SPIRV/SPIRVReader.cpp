@@ -74,6 +74,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/IntrinsicInst.h>
 #include "libSPIRV/SPIRVDebugInfoExt.h"
 #include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Analysis/ConstantFolding.h"
+#include "llvm/IR/InstIterator.h"
 #include "common/LLVMWarningsPop.hpp"
 #include "libSPIRV/SPIRVAsm.h"
 #include "llvm/IR/InlineAsm.h"
@@ -97,6 +99,10 @@ using namespace llvm;
 namespace spv{
 // Prefix for placeholder global variable name.
 const char* kPlaceholderPrefix = "placeholder.";
+// Prefix and SpecId metadata of the globals standing in for specialization
+// constants in a module from ReadSPIRVUnspecialized().
+const char* kSpecConstantPrefix = "spirv.SpecConstant.";
+const char* kSpecConstantIdMD = "spirv.SpecId";
 
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
 // Save the translated LLVM before validation for debugging purpose.
@@ -1164,6 +1170,12 @@ public:
 
   Value *getTranslatedValue(SPIRVValue *BV);
 
+  /// Translate specialization constants to placeholders instead of their
+  /// values; see ReadSPIRVUnspecialized().
+  void setSpecConstantPlaceholders(bool Enable) {
+    UseSpecConstantPlaceholders = Enable;
+  }
+
 private:
   IGCLLVM::Module *M;
   BuiltinVarMap BuiltinGVMap;
@@ -1177,6 +1189,9 @@ private:
   GlobalVariable *m_NamedBarrierVar;
   GlobalVariable *m_named_barrier_id;
   DICompileUnit* compileUnit = nullptr;
+  bool UseSpecConstantPlaceholders = false;
+
+  Constant *transSpecConstantPlaceholder(SPIRVValue *BV, Constant *Default);
 
   Type *mapType(SPIRVType *BT, Type *T) {
     TypeMap[BT] = T;
@@ -1341,6 +1356,32 @@ SPIRVToLLVM::getTranslatedValue(SPIRVValue *BV){
   return nullptr;
 }
 
+// The placeholder has to stay a Constant wherever the translator expects one
+// (composites, global initializers), so it is the address of a global cast to
+// the constant's type. Constant folding must not learn anything about that
+// address, or e.g. `X & 3` would fold to 0 before X is known. An extern_weak
+// declaration with alignment 1 may be null, unaligned and equal to any other
+// placeholder, so nothing folds. Its metadata holds the SpecId and the default
+// value; SpecializeConstants() replaces the casts with the final value.
+Constant *
+SPIRVToLLVM::transSpecConstantPlaceholder(SPIRVValue *BV, Constant *Default) {
+  SPIRVWord SpecId = *BV->getDecorate(DecorationSpecId).begin();
+  auto GV = new GlobalVariable(*M, Default->getType(), true,
+      GlobalValue::ExternalWeakLinkage, nullptr,
+      kSpecConstantPrefix + std::to_string(SpecId));
+  GV->setAlignment(MaybeAlign(1));
+  Metadata *MD[] = {
+      ConstantAsMetadata::get(ConstantInt::get(Type::getInt32Ty(*Context), SpecId)),
+      ConstantAsMetadata::get(Default),
+  };
+  GV->setMetadata(kSpecConstantIdMD, MDNode::get(*Context, MD));
+  Type *IntTy = Type::getIntNTy(*Context, Default->getType()->getScalarSizeInBits());
+  Constant *C = ConstantExpr::getPtrToInt(GV, IntTy);
+  if (Default->getType() != IntTy)
+    C = ConstantExpr::getBitCast(C, Default->getType());
+  return C;
+}
+
 void
 SPIRVToLLVM::setAttrByCalledFunc(CallInst *Call) {
   Function *F = Call->getCalledFunction();
@@ -2214,11 +2255,13 @@ SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
       if(BM->isSpecConstantSpecialized(specid))
         V = BM->getSpecConstant(specid);
     }
+    Constant *C = nullptr;
     switch(BT->getOpCode()) {
     case OpTypeBool:
     case OpTypeInt:
-      return mapValue(BV, ConstantInt::get(LT, V,
-        static_cast<SPIRVTypeInt*>(BT)->isSigned()));
+      C = ConstantInt::get(LT, V,
+        static_cast<SPIRVTypeInt*>(BT)->isSigned());
+      break;
     case OpTypeFloat: {
       const llvm::fltSemantics *FS = nullptr;
       switch (BT->getFloatBitWidth()) {
@@ -2235,18 +2278,25 @@ SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
         IGC_ASSERT_EXIT(0 && "invalid float type");
         break;
       }
-      return mapValue(BV, ConstantFP::get(*Context, APFloat(*FS,
-          APInt(BT->getFloatBitWidth(), V))));
+      C = ConstantFP::get(*Context, APFloat(*FS,
+          APInt(BT->getFloatBitWidth(), V)));
+      break;
     }
     default:
       llvm_unreachable("Not implemented");
       return NULL;
     }
+    if (UseSpecConstantPlaceholders && BV->hasDecorate(DecorationSpecId))
+      return mapValue(BV, transSpecConstantPlaceholder(BV, C));
+    return mapValue(BV, C);
   }
   break;
 
   case OpSpecConstantTrue:
     if (BV->hasDecorate(DecorationSpecId)) {
+      if (UseSpecConstantPlaceholders)
+        return mapValue(BV, transSpecConstantPlaceholder(BV,
+          ConstantInt::getTrue(*Context)));
       SPIRVWord specid = *BV->getDecorate(DecorationSpecId).begin();
       if (BM->isSpecConstantSpecialized(specid)) {
         if (BM->getSpecConstant(specid))
@@ -2262,6 +2312,9 @@ SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
 
   case OpSpecConstantFalse:
     if (BV->hasDecorate(DecorationSpecId)) {
+      if (UseSpecConstantPlaceholders)
+        return mapValue(BV, transSpecConstantPlaceholder(BV,
+          ConstantInt::getFalse(*Context)));
       SPIRVWord specid = *BV->getDecorate(DecorationSpecId).begin();
       if (BM->isSpecConstantSpecialized(specid)) {
         if (BM->getSpecConstant(specid))
@@ -3983,15 +4036,17 @@ __attr_unused static void dumpSPIRVBC(const char* fname, const char* data, unsig
     }
 }
 
-bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
+static bool ReadSPIRVImpl(LLVMContext &C, std::istream &IS, Module *&M,
     std::string &ErrMsg,
-    std::unordered_map<uint32_t, uint64_t> *specConstants) {
+    std::unordered_map<uint32_t, uint64_t> *specConstants,
+    bool specConstantPlaceholders) {
   std::unique_ptr<SPIRVModule> BM( SPIRVModule::createSPIRVModule() );
   BM->setSpecConstantMap(specConstants);
   IS >> *BM;
   BM->resolveUnknownStructFields();
   M = new Module( "",C );
   SPIRVToLLVM BTL( M,BM.get() );
+  BTL.setSpecConstantPlaceholders(specConstantPlaceholders);
   bool Succeed = true;
   if(!BTL.translate()) {
     BM->getError( ErrMsg );
@@ -4014,4 +4069,72 @@ bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
   return Succeed;
 }
 
+bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
+    std::string &ErrMsg,
+    std::unordered_map<uint32_t, uint64_t> *specConstants) {
+  return ReadSPIRVImpl(C, IS, M, ErrMsg, specConstants, false);
+}
+
+bool ReadSPIRVUnspecialized(LLVMContext &C, std::istream &IS, Module *&M,
+    std::string &ErrMsg) {
+  return ReadSPIRVImpl(C, IS, M, ErrMsg, nullptr, true);
+}
+
+bool SpecializeConstants(Module &M,
+    const std::unordered_map<uint32_t, uint64_t> *specConstants) {
+  SmallVector<GlobalVariable *, 8> Placeholders;
+  for (auto &GV : M.globals())
+    if (GV.getMetadata(kSpecConstantIdMD))
+      Placeholders.push_back(&GV);
+
+  for (auto GV : Placeholders) {
+    MDNode *MD = GV->getMetadata(kSpecConstantIdMD);
+    auto SpecId = mdconst::extract<ConstantInt>(MD->getOperand(0))->getZExtValue();
+    Constant *Default = mdconst::extract<Constant>(MD->getOperand(1));
+    APInt Bits = isa<ConstantFP>(Default) ?
+        cast<ConstantFP>(Default)->getValueAPF().bitcastToAPInt() :
+        cast<ConstantInt>(Default)->getValue();
+    if (specConstants) {
+      auto It = specConstants->find(static_cast<uint32_t>(SpecId));
+      if (It != specConstants->end())
+        Bits = Bits.getBitWidth() == 1 ?
+            APInt(1, It->second != 0) : APInt(Bits.getBitWidth(), It->second);
+    }
+
+    // Constant folding during translation may have narrowed a cast, so each
+    // use takes the value at its own width, as ptrtoint would.
+    while (!GV->use_empty()) {
+      auto CE = dyn_cast<ConstantExpr>(GV->user_back());
+      if (!CE || CE->getOpcode() != Instruction::PtrToInt)
+        return false;
+      unsigned Width = CE->getType()->getScalarSizeInBits();
+      CE->replaceAllUsesWith(ConstantInt::get(M.getContext(), Bits.zextOrTrunc(Width)));
+      CE->destroyConstant();
+    }
+    GV->eraseFromParent();
+  }
+
+  // Replacing an operand does not refold the constant expressions built on
+  // top of it (e.g. the casts of OpSpecConstantOp), so fold them here the way
+  // translating the final value would have.
+  if (!Placeholders.empty()) {
+    const DataLayout &DL = M.getDataLayout();
+    for (auto &GV : M.globals()) {
+      if (GV.hasInitializer())
+        if (Constant *C = ConstantFoldConstant(GV.getInitializer(), DL))
+          GV.setInitializer(C);
+    }
+    for (auto &F : M) {
+      for (auto &I : instructions(F)) {
+        for (Use &Op : I.operands()) {
+          if (isa<ConstantExpr>(Op) || isa<ConstantAggregate>(Op))
+            if (Constant *C = ConstantFoldConstant(cast<Constant>(Op), DL))
+              Op.set(C);
+        }
+      }
+    }
+  }
+  return true;
+}
+
 }
@@ -49,5 +49,17 @@ bool ReadSPIRV(llvm::LLVMContext &C, std::istream &IS, llvm::Module *&M,
     std::string &ErrMsg,
     std::unordered_map<uint32_t, uint64_t> *specConstants);
 
+// Like ReadSPIRV, but translates every specialization constant with a SpecId
+// to a placeholder, so that the result can be specialized any number of
+// times with SpecializeConstants().
+bool ReadSPIRVUnspecialized(llvm::LLVMContext &C, std::istream &IS,
+    llvm::Module *&M, std::string &ErrMsg);
+
+// Replaces the specialization constant placeholders of M with the values in
+// specConstants, or their defaults. Returns false if a placeholder is used in
+// a way it cannot be replaced; M must be discarded then.
+bool SpecializeConstants(llvm::Module &M,
+    const std::unordered_map<uint32_t, uint64_t> *specConstants);
+
 }
 #endif
@@ -0,0 +1,84 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "SpecializeSPIRVConstants.h"
+#include "SPIRV/SPIRVconsum.h"
+#include "Compiler/IGCPassSupport.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/ErrorHandling.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+static cl::list<std::string> SpecConstantValues(
+    "igc-spec-constant", cl::CommaSeparated, cl::ZeroOrMore, cl::Hidden,
+    cl::desc("Specialization constant values as <SpecId>:<value>"));
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-specialize-spirv-constants"
+#define PASS_DESCRIPTION "Replace SPIR-V specialization constant placeholders with their values"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(SpecializeSPIRVConstants, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_END(SpecializeSPIRVConstants, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+#undef PASS_ANALYSIS
+#undef PASS_CFG_ONLY
+#undef PASS_DESCRIPTION
+#undef PASS_FLAG
+
+char SpecializeSPIRVConstants::ID = 0;
+
+SpecializeSPIRVConstants::SpecializeSPIRVConstants() : ModulePass(ID)
+{
+    initializeSpecializeSPIRVConstantsPass(*PassRegistry::getPassRegistry());
+}
+
+bool SpecializeSPIRVConstants::runOnModule(llvm::Module &M)
+{
+    std::unordered_map<uint32_t, uint64_t> specConstants;
+    for (const std::string &value : SpecConstantValues)
+    {
+        StringRef id, bits;
+        std::tie(id, bits) = StringRef(value).split(':');
+        uint32_t specId = 0;
+        uint64_t specValue = 0;
+        if (id.getAsInteger(0, specId) || bits.getAsInteger(0, specValue))
+        {
+            report_fatal_error(Twine("invalid -igc-spec-constant value: ") + value);
+        }
+        specConstants[specId] = specValue;
+    }
+
+    if (!spv::SpecializeConstants(M, &specConstants))
+    {
+        report_fatal_error("specialization constant placeholder can not be replaced");
+    }
+    return true;
+}
@@ -252,6 +252,17 @@ static void CommonOCLBasedPasses(
     CompilerOpts.PreferBindlessImages =
         pContext->m_InternalOptions.PreferBindlessImages;
 
+    CompilerOpts.CompileTimeBudgetMs =
+        pContext->m_InternalOptions.CompileTimeBudgetMs;
+
+    if (pContext->m_InternalOptions.IntelFastCompilation)
+    {
+        // Fast tier of a tiered translation: the optimized binary is compiled
+        // separately, so take every cheaper setting right away.
+        CompilerOpts.FastCompilation = true;
+        pContext->m_retryManager.ApplyCompileTimeDegradations(COMPILE_TIME_DEGRADE_ALL);
+    }
+
     if (CompilerOpts.PreferBindlessImages) {
         pContext->getModuleMetaData()->UseBindlessImage = true;
     }
@@ -40,6 +40,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
 
 #include "AdaptorOCL/UnifyIROCL.hpp"
+#include "AdaptorOCL/KernelBinaryReuse.hpp"
 #include "AdaptorOCL/DriverInfoOCL.hpp"
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
@@ -77,6 +78,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <sstream>
 #include <iomanip>
+#include <list>
+#include <map>
+#include <mutex>
 #include "Probe/Assertion.h"
 
 //In case of use GT_SYSTEM_INFO in GlobalData.h from inc/umKmInc/sharedata.h
@@ -140,6 +144,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Format.h>
+#include <llvm/Support/MD5.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 #include "common/LLVMWarningsPop.hpp"
@@ -172,6 +177,17 @@ bool TranslateBuild(
     const IGC::CPlatform& IGCPlatform,
     float profilingTimerResolution);
 
+// IGC keeps process-wide state (registry flags, function statics, the vISA
+// lexer and parser, interned strings), so translations within one process,
+// including background ones, must run one at a time. The same goes for the
+// kernels of one program: giving each its own LLVMContext and CodeGenContext
+// would not make the vISA builder and finalizer safe to run side by side.
+std::mutex &GetTranslationMutex()
+{
+    static std::mutex translationMutex;
+    return translationMutex;
+}
+
 bool CIGCTranslationBlock::ProcessElfInput(
   STB_TranslateInputArgs &InputArgs,
   STB_TranslateOutputArgs &OutputArgs,
@@ -232,6 +248,8 @@ bool CIGCTranslationBlock::Translate(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs )
 {
+    std::lock_guard<std::mutex> translationLock(GetTranslationMutex());
+
   // Create a copy of input arguments that can be modified
     STB_TranslateInputArgs InputArgsCopy = *pInputArgs;
 
@@ -624,6 +642,109 @@ bool ProcessElfInput(
   return success;
 }
 
+#if defined(IGC_SPIRV_ENABLED)
+// SPIR-V programs translated with placeholders for their specialization
+// constants, kept as bitcode since every build has its own LLVMContext.
+// Building a program again with other specialization values then only parses
+// the bitcode and substitutes the values instead of translating the SPIR-V.
+class UnspecializedIRCache
+{
+public:
+    typedef std::pair<uint64_t, uint64_t> Key;
+
+    static UnspecializedIRCache& Get()
+    {
+        static UnspecializedIRCache cache;
+        return cache;
+    }
+
+    bool Find(const Key& key, std::string& bitcode)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return false;
+        }
+        bitcode = it->second;
+        return true;
+    }
+
+    void Insert(const Key& key, const std::string& bitcode)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_entries.emplace(key, bitcode).second)
+        {
+            return;
+        }
+        m_order.push_back(key);
+        while (m_order.size() > IGC_GET_FLAG_VALUE(SpecConstantIRCacheCapacity))
+        {
+            m_entries.erase(m_order.front());
+            m_order.pop_front();
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::map<Key, std::string> m_entries;
+    std::list<Key> m_order;
+};
+
+// Produces the module for spirv specialized with specConstants from the
+// cached unspecialized IR, translating and caching it first on a miss.
+// Returns false if the caller has to translate the SPIR-V itself.
+static bool ReadSPIRVFromUnspecializedIR(
+    llvm::LLVMContext& C,
+    llvm::StringRef spirv,
+    llvm::Module*& M,
+    const std::unordered_map<uint32_t, uint64_t>& specConstants)
+{
+    llvm::MD5 hash;
+    hash.update(spirv);
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    UnspecializedIRCache::Key key = std::make_pair(result.high(), result.low());
+
+    M = nullptr;
+    std::string bitcode;
+    if (UnspecializedIRCache::Get().Find(key, bitcode))
+    {
+        std::unique_ptr<llvm::MemoryBuffer> Buf =
+            llvm::MemoryBuffer::getMemBuffer(bitcode, "<spec-constant-ir>", false);
+        llvm::Expected<std::unique_ptr<llvm::Module>> MOE =
+            llvm::parseBitcodeFile(Buf->getMemBufferRef(), C);
+        if (!MOE)
+        {
+            llvm::consumeError(MOE.takeError());
+            return false;
+        }
+        M = MOE->release();
+    }
+    else
+    {
+        std::istringstream IS(spirv.str());
+        std::string stringErrMsg;
+        if (!spv::ReadSPIRVUnspecialized(C, IS, M, stringErrMsg))
+        {
+            return false;
+        }
+        llvm::raw_string_ostream OS(bitcode);
+        IGCLLVM::WriteBitcodeToFile(M, OS);
+        OS.flush();
+        UnspecializedIRCache::Get().Insert(key, bitcode);
+    }
+
+    if (!spv::SpecializeConstants(*M, &specConstants))
+    {
+        delete M;
+        M = nullptr;
+        return false;
+    }
+    return true;
+}
+#endif // defined(IGC_SPIRV_ENABLED)
+
 bool ParseInput(
     llvm::Module*& pKernelModule,
     const STB_TranslateInputArgs* pInputArgs,
@@ -695,7 +816,15 @@ bool ParseInput(
                                                                             pInputArgs->pSpecConstantsIds,
                                                                             pInputArgs->pSpecConstantsValues,
                                                                             pInputArgs->SpecConstantsSize);
-        bool success = spv::ReadSPIRV(oclContext, IS, pKernelModule, stringErrMsg, &specIDToSpecValueMap);
+        bool success = false;
+        if (pInputArgs->SpecConstantsSize > 0 && IGC_IS_FLAG_ENABLED(EnableSpecConstantIRCache))
+        {
+            success = ReadSPIRVFromUnspecializedIR(oclContext, strInput, pKernelModule, specIDToSpecValueMap);
+        }
+        if (!success)
+        {
+            success = spv::ReadSPIRV(oclContext, IS, pKernelModule, stringErrMsg, &specIDToSpecValueMap);
+        }
         // handle OpenCL Compiler Options
         GenerateCompilerOptionsMD(
             oclContext,
@@ -927,9 +1056,11 @@ bool TranslateBuild(
     }
 
     oclContext.setModule(pKernelModule);
-    if (oclContext.isSPIRV())
+    if (oclContext.isSPIRV() &&
+        !deserialize(*oclContext.getModuleMetaData(), pKernelModule))
     {
-        deserialize(*oclContext.getModuleMetaData(), pKernelModule);
+        SetErrorMessage("ModuleMetaData blob was written by a different compiler!", *pOutputArgs);
+        return false;
     }
 
     oclContext.hash = inputShHash;
@@ -949,7 +1080,15 @@ bool TranslateBuild(
 
     /// set retry manager
     bool retry = false;
-    oclContext.m_retryManager.Enable();
+    // The fast tier of a tiered translation takes the first binary it gets;
+    // spilling kernels are fixed up by the optimized translation.
+    if (!oclContext.m_InternalOptions.IntelFastCompilation)
+    {
+        oclContext.m_retryManager.Enable();
+    }
+    KernelBinaryReuse kernelReuse(
+        llvm::StringRef(pInputArgs->pOptions, pInputArgs->OptionsSize),
+        llvm::StringRef(pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize));
     do
     {
         std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
@@ -1080,6 +1219,9 @@ bool TranslateBuild(
             oclContext.m_floatDenormMode32 = FLOAT_DENORM_FLUSH_TO_ZERO;
         }
 
+        // Kernels unchanged since an earlier build are not compiled again.
+        kernelReuse.RemoveStoredKernels(oclContext);
+
         // Optimize the IR. This happens once for each program, not per-kernel.
         IGC::OptimizeIR(&oclContext);
 
@@ -1106,6 +1248,9 @@ bool TranslateBuild(
         }
     } while (retry);
 
+    oclContext.m_programOutput.m_compileTimeDegradations =
+        oclContext.m_retryManager.GetCompileTimeDegradations();
+
     // Prepare and set program binary
     unsigned int pointerSizeInBytes = (PtrSzInBits == 64) ? 8 : 4;
 
@@ -1117,6 +1262,7 @@ bool TranslateBuild(
         Util::BinaryStream programBinary;
         // Patch token based binary format
         oclContext.m_programOutput.CreateKernelBinaries();
+        kernelReuse.MergeKernelBinaries(oclContext);
         oclContext.m_programOutput.GetProgramBinary(programBinary, pointerSizeInBytes);
         binarySize = static_cast<int>(programBinary.Size());
         binaryOutput = new char[binarySize];
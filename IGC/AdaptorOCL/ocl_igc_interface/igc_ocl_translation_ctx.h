@@ -128,6 +128,58 @@ protected:
                                                   void *gtPinInput);
 };
 
+CIF_DEFINE_INTERFACE_VER_WITH_COMPATIBILITY(IgcOclTranslationCtx, 4, 3) {
+  using IgcOclTranslationCtx<3>::TranslateImpl;
+  using IgcOclTranslationCtx<3>::Translate;
+
+  CIF_INHERIT_CONSTRUCTOR();
+
+  // Two-tier translation. Returns a quickly compiled binary (reduced LLVM optimizations,
+  // no SIMD32, local register allocation) and keeps translating the same input with
+  // full optimizations on a background thread. outHandle receives the handle of the
+  // background translation or 0 if none was started (e.g. translation failed or
+  // GTPin is attached). Translations within a process never overlap, so a pending
+  // background translation delays the next Translate call until it completes.
+  template <typename OclTranslationOutputInterface = OclTranslationOutputTagOCL>
+  CIF::RAII::UPtr_t<OclTranslationOutputInterface> TranslateTiered(CIF::Builtins::BufferSimple *src,
+                                                                   CIF::Builtins::BufferSimple *specConstantsIds,
+                                                                   CIF::Builtins::BufferSimple *specConstantsValues,
+                                                                   CIF::Builtins::BufferSimple *options,
+                                                                   CIF::Builtins::BufferSimple *internalOptions,
+                                                                   CIF::Builtins::BufferSimple *tracingOptions,
+                                                                   uint32_t tracingOptionsCount,
+                                                                   void *gtPinInput,
+                                                                   uint64_t *outHandle) {
+      auto p = TranslateTieredImpl(OclTranslationOutputInterface::GetVersion(), src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput, outHandle);
+      return CIF::RAII::Pack<OclTranslationOutputInterface>(p);
+  }
+
+  // Returns true once the optimized binary for handle can be taken without blocking.
+  virtual bool IsOptimizedTranslationReady(uint64_t handle);
+
+  // Returns the optimized translation for handle, waiting for it if needed. Must be
+  // requested with the same output interface as TranslateTiered. Each handle can be
+  // taken only once; returns nullptr for unknown handles.
+  template <typename OclTranslationOutputInterface = OclTranslationOutputTagOCL>
+  CIF::RAII::UPtr_t<OclTranslationOutputInterface> TakeOptimizedTranslation(uint64_t handle) {
+      auto p = TakeOptimizedTranslationImpl(OclTranslationOutputInterface::GetVersion(), handle);
+      return CIF::RAII::Pack<OclTranslationOutputInterface>(p);
+  }
+
+protected:
+  virtual OclTranslationOutputBase *TranslateTieredImpl(CIF::Version_t outVersion,
+                                                        CIF::Builtins::BufferSimple *src,
+                                                        CIF::Builtins::BufferSimple *specConstantsIds,
+                                                        CIF::Builtins::BufferSimple *specConstantsValues,
+                                                        CIF::Builtins::BufferSimple *options,
+                                                        CIF::Builtins::BufferSimple *internalOptions,
+                                                        CIF::Builtins::BufferSimple *tracingOptions,
+                                                        uint32_t tracingOptionsCount,
+                                                        void *gtPinInput,
+                                                        uint64_t *outHandle);
+  virtual OclTranslationOutputBase *TakeOptimizedTranslationImpl(CIF::Version_t outVersion, uint64_t handle);
+};
+
 CIF_GENERATE_VERSIONS_LIST_AND_DECLARE_INTERFACE_DEPENDENCIES(IgcOclTranslationCtx, IGC::OclTranslationOutput, CIF::Builtins::Buffer);
 CIF_MARK_LATEST_VERSION(IgcOclTranslationCtxLatest, IgcOclTranslationCtx);
 using IgcOclTranslationCtxTagOCL = IgcOclTranslationCtxLatest; // Note : can tag with different version for
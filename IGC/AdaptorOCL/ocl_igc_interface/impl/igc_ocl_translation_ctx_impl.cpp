@@ -72,6 +72,31 @@ OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 3)::Tran
     return CIF_GET_PIMPL()->Translate(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
 }
 
+
+OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 4)::TranslateTieredImpl(
+                                                 CIF::Version_t outVersion,
+                                                 CIF::Builtins::BufferSimple *src,
+                                                 CIF::Builtins::BufferSimple *specConstantsIds,
+                                                 CIF::Builtins::BufferSimple *specConstantsValues,
+                                                 CIF::Builtins::BufferSimple *options,
+                                                 CIF::Builtins::BufferSimple *internalOptions,
+                                                 CIF::Builtins::BufferSimple *tracingOptions,
+                                                 uint32_t tracingOptionsCount,
+                                                 void *gtPinInput,
+                                                 uint64_t *outHandle) {
+    return CIF_GET_PIMPL()->TranslateTiered(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput, outHandle);
+}
+
+bool CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 4)::IsOptimizedTranslationReady(uint64_t handle) {
+    return CIF_GET_PIMPL()->IsOptimizedTranslationReady(handle);
+}
+
+OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 4)::TakeOptimizedTranslationImpl(
+                                                 CIF::Version_t outVersion,
+                                                 uint64_t handle) {
+    return CIF_GET_PIMPL()->TakeOptimizedTranslation(outVersion, handle);
+}
+
 }
 
 #include "cif/macros/disable.h"
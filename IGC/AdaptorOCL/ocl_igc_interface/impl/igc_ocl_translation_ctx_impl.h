@@ -29,7 +29,13 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "ocl_igc_interface/igc_ocl_translation_ctx.h"
 #include "ocl_igc_interface/impl/igc_ocl_device_ctx_impl.h"
 
+#include <chrono>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "cif/builtins/memory/buffer/impl/buffer_impl.h"
 #include "cif/helpers/error.h"
@@ -69,6 +75,8 @@ bool ReadSpecConstantsFromSPIRV(
     std::istream &IS,
     std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo);
 
+std::mutex &GetTranslationMutex();
+
 }
 
 bool enableSrcLine(void*);
@@ -195,21 +203,181 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         }
         inputArgs.GTPinInput = gtPinInput;
 
-        IGC::CPlatform igcPlatform = this->globalState.GetIgcCPlatform();
-        CIF::Sanity::NotNullOrAbort(this->globalState.GetPlatformImpl());
-        auto platform = this->globalState.GetPlatformImpl()->p;
+        std::lock_guard<std::mutex> translationLock{TC::GetTranslationMutex()};
+        LoadRegistryKeysFromOptions(inputArgs.pOptions, *outputInterface);
 
-        USC::SShaderStageBTLayout zeroLayout = USC::g_cZeroShaderStageBTLayout;
-        IGC::COCLBTILayout oclLayout(&zeroLayout);
+        if(TranslateArgs(inputArgs, *outputInterface) == false){
+            return nullptr; // OOM
+        }
 
-        TC::STB_TranslateOutputArgs output;
-        CIF::SafeZeroOut(output);
+        return outputInterface.release();
+    }
+
+    // Two-tier translation : returns a quickly compiled binary right away and
+    // starts the full-quality translation of the same input on a background
+    // thread. *outHandle is set to the handle of the background translation,
+    // or to 0 if the input was translated only once.
+    OclTranslationOutputBase *TranslateTiered(CIF::Version_t outVersion,
+                                              CIF::Builtins::BufferSimple *src,
+                                              CIF::Builtins::BufferSimple *specConstantsIds,
+                                              CIF::Builtins::BufferSimple *specConstantsValues,
+                                              CIF::Builtins::BufferSimple *options,
+                                              CIF::Builtins::BufferSimple *internalOptions,
+                                              CIF::Builtins::BufferSimple *tracingOptions,
+                                              uint32_t tracingOptionsCount,
+                                              void *gtPinInput,
+                                              uint64_t *outHandle) {
+        if(outHandle != nullptr){
+            *outHandle = 0;
+        }
+
+        // GTPin instruments the binary the runtime sees first, so it can not be
+        // swapped later. Other outputs are not executable at all.
+        if((outHandle == nullptr) || (gtPinInput != nullptr) || (this->outType != CodeType::oclGenBin)){
+            return Translate(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
+        }
+
+        // Caller owns the buffers only for the duration of this call
+        auto optimizedInput = std::make_shared<TranslationInputCopy>(src, specConstantsIds, specConstantsValues, options, internalOptions);
+        TranslationInputCopy fastInput = *optimizedInput;
+        fastInput.internalOptions += " -intel-fast-compile";
+
+        auto fastOutput = CIF::RAII::UPtr(Translate(outVersion, fastInput, tracingOptions, tracingOptionsCount));
+        if((fastOutput == nullptr) || (fastOutput->GetImpl()->Successful() == false)){
+            // Don't spend the background thread on an input that doesn't build
+            return fastOutput.release();
+        }
+
+        std::lock_guard<std::mutex> lock{this->optimizedTranslationsMutex};
+        uint64_t handle = ++this->lastOptimizedTranslationHandle;
+        OptimizedTranslation &optimized = this->optimizedTranslations[handle];
+        optimized.outVersion = outVersion;
+        // The background translation takes the process-wide translation lock
+        // like any other, so it only runs between foreground translations.
+        optimized.result = std::async(std::launch::async, [this, outVersion, optimizedInput]() {
+            return CIF::RAII::UPtr(this->Translate(outVersion, *optimizedInput, nullptr, 0));
+        });
+        *outHandle = handle;
+
+        return fastOutput.release();
+    }
+
+    bool IsOptimizedTranslationReady(uint64_t handle) {
+        std::lock_guard<std::mutex> lock{this->optimizedTranslationsMutex};
+        auto it = this->optimizedTranslations.find(handle);
+        if(it == this->optimizedTranslations.end()){
+            return false;
+        }
+        return it->second.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    // Waits for the background translation and hands its output over to the
+    // caller. Each handle can be taken only once.
+    OclTranslationOutputBase *TakeOptimizedTranslation(CIF::Version_t outVersion, uint64_t handle) {
+        std::future<CIF::RAII::UPtr_t<OclTranslationOutputBase>> result;
+        {
+            std::lock_guard<std::mutex> lock{this->optimizedTranslationsMutex};
+            auto it = this->optimizedTranslations.find(handle);
+            if((it == this->optimizedTranslations.end()) || (it->second.outVersion != outVersion)){
+                return nullptr;
+            }
+            result = std::move(it->second.result);
+            this->optimizedTranslations.erase(it);
+        }
+        return result.get().release();
+    }
+
+protected:
+    // Owning copy of the translation input that can outlive the caller's buffers
+    struct TranslationInputCopy {
+        TranslationInputCopy(CIF::Builtins::BufferSimple *src,
+                             CIF::Builtins::BufferSimple *specConstantsIds,
+                             CIF::Builtins::BufferSimple *specConstantsValues,
+                             CIF::Builtins::BufferSimple *options,
+                             CIF::Builtins::BufferSimple *internalOptions) {
+            if(src != nullptr){
+                this->src.assign(src->GetMemory<char>(), src->GetMemory<char>() + src->GetSizeRaw());
+            }
+            if(options != nullptr){
+                this->options.assign(options->GetMemory<char>(), options->GetSizeRaw());
+                StripTrailingNulls(this->options);
+            }
+            if(internalOptions != nullptr){
+                this->internalOptions.assign(internalOptions->GetMemory<char>(), internalOptions->GetSizeRaw());
+                StripTrailingNulls(this->internalOptions);
+            }
+            if(specConstantsIds != nullptr && specConstantsValues != nullptr){
+                size_t count = specConstantsIds->GetSizeRaw() / sizeof(uint32_t);
+                this->specConstantsIds.assign(specConstantsIds->GetMemory<uint32_t>(), specConstantsIds->GetMemory<uint32_t>() + count);
+                this->specConstantsValues.assign(specConstantsValues->GetMemory<uint64_t>(), specConstantsValues->GetMemory<uint64_t>() + count);
+            }
+        }
+
+        static void StripTrailingNulls(std::string &str) {
+            while((str.empty() == false) && (str.back() == '\0')){
+                str.pop_back();
+            }
+        }
+
+        std::vector<char> src;
+        std::string options;
+        std::string internalOptions;
+        std::vector<uint32_t> specConstantsIds;
+        std::vector<uint64_t> specConstantsValues;
+    };
 
+    struct OptimizedTranslation {
+        CIF::Version_t outVersion = 0;
+        std::future<CIF::RAII::UPtr_t<OclTranslationOutputBase>> result;
+    };
+
+    OclTranslationOutputBase *Translate(CIF::Version_t outVersion,
+                                        TranslationInputCopy &input,
+                                        CIF::Builtins::BufferSimple *tracingOptions,
+                                        uint32_t tracingOptionsCount) const{
+        auto outputInterface = CIF::RAII::UPtr(CIF::InterfaceCreator<OclTranslationOutput>::CreateInterfaceVer(outVersion, this->outType));
+        if(outputInterface == nullptr){
+            return nullptr; // OOM
+        }
+
+        TC::STB_TranslateInputArgs inputArgs;
+        if(input.src.empty() == false){
+            inputArgs.pInput = input.src.data();
+            inputArgs.InputSize = static_cast<uint32_t>(input.src.size());
+        }
+        inputArgs.pOptions = input.options.c_str();
+        inputArgs.OptionsSize = static_cast<uint32_t>(input.options.size());
+        inputArgs.pInternalOptions = input.internalOptions.c_str();
+        inputArgs.InternalOptionsSize = static_cast<uint32_t>(input.internalOptions.size());
+        if(tracingOptions != nullptr){
+            inputArgs.pTracingOptions = tracingOptions->GetMemoryRawWriteable();
+        }
+        inputArgs.TracingOptionsCount = tracingOptionsCount;
+        if(input.specConstantsIds.empty() == false){
+            inputArgs.pSpecConstantsIds = input.specConstantsIds.data();
+            inputArgs.SpecConstantsSize = static_cast<uint32_t>(input.specConstantsIds.size());
+            inputArgs.pSpecConstantsValues = input.specConstantsValues.data();
+        }
+
+        // Every translation, foreground or background, applies the -igc_opts
+        // of its own copied options while holding the translation lock
+        std::lock_guard<std::mutex> translationLock{TC::GetTranslationMutex()};
+        LoadRegistryKeysFromOptions(inputArgs.pOptions, *outputInterface);
+
+        if(TranslateArgs(inputArgs, *outputInterface) == false){
+            return nullptr; // OOM
+        }
+
+        return outputInterface.release();
+    }
+
+    // Applies registry flags passed as -igc_opts '<flags>' in the build options
+    void LoadRegistryKeysFromOptions(const char *pOptions, OclTranslationOutputBase &outputInterface) const{
         std::string RegKeysFlagsFromOptions = "";
-        if (inputArgs.pOptions != NULL)
+        if (pOptions != NULL)
         {
             const std::string& igc_optsName = "-igc_opts";
-            const std::string& optionsWithFlags = (const char*)inputArgs.pOptions;
+            const std::string& optionsWithFlags = pOptions;
             std::size_t found = optionsWithFlags.find(igc_optsName);
             if (found != std::string::npos)
             {
@@ -224,7 +392,20 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         }
         bool RegFlagNameError = 0;
         LoadRegistryKeys(RegKeysFlagsFromOptions, &RegFlagNameError);
-        if(RegFlagNameError) outputInterface->GetImpl()->SetError(TranslationErrorType::Unused, "Invalid registry flag name in -igc_opts, at least one flag has been ignored");
+        if(RegFlagNameError) outputInterface.GetImpl()->SetError(TranslationErrorType::Unused, "Invalid registry flag name in -igc_opts, at least one flag has been ignored");
+    }
+
+    // Returns false only if the results could not be copied to outputInterface
+    bool TranslateArgs(TC::STB_TranslateInputArgs &inputArgs, OclTranslationOutputBase &outputInterface) const{
+        IGC::CPlatform igcPlatform = this->globalState.GetIgcCPlatform();
+        CIF::Sanity::NotNullOrAbort(this->globalState.GetPlatformImpl());
+        auto platform = this->globalState.GetPlatformImpl()->p;
+
+        USC::SShaderStageBTLayout zeroLayout = USC::g_cZeroShaderStageBTLayout;
+        IGC::COCLBTILayout oclLayout(&zeroLayout);
+
+        TC::STB_TranslateOutputArgs output;
+        CIF::SafeZeroOut(output);
 
         bool success = false;
         if (this->inType == CodeType::elf)
@@ -255,7 +436,7 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
             }
             else
             {
-                outputInterface->GetImpl()->SetError(TranslationErrorType::UnhandledInput, "Unhandled inType");
+                outputInterface.GetImpl()->SetError(TranslationErrorType::UnhandledInput, "Unhandled inType");
                 success = false;
             }
         }
@@ -266,24 +447,25 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
 
         bool dataCopiedSuccessfuly = true;
         if(success){
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->AddWarning(output.pErrorString, output.ErrorStringSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->CloneDebugData(output.pDebugData, output.DebugDataSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetSuccessfulAndCloneOutput(output.pOutput, output.OutputSize);
+            dataCopiedSuccessfuly &= outputInterface.GetImpl()->AddWarning(output.pErrorString, output.ErrorStringSize);
+            dataCopiedSuccessfuly &= outputInterface.GetImpl()->CloneDebugData(output.pDebugData, output.DebugDataSize);
+            dataCopiedSuccessfuly &= outputInterface.GetImpl()->SetSuccessfulAndCloneOutput(output.pOutput, output.OutputSize);
         }else{
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetError(TranslationErrorType::FailedCompilation, output.pErrorString);
-        }
-
-        if(dataCopiedSuccessfuly == false){
-            return nullptr; // OOM
+            dataCopiedSuccessfuly &= outputInterface.GetImpl()->SetError(TranslationErrorType::FailedCompilation, output.pErrorString);
         }
 
-        return outputInterface.release();
+        return dataCopiedSuccessfuly;
     }
 
-protected:
     CIF_PIMPL(IgcOclDeviceCtx) &globalState;
     CodeType::CodeType_t inType;
     CodeType::CodeType_t outType;
+
+    // Background full-quality translations started by TranslateTiered. Pending
+    // futures are joined when the context is destroyed.
+    std::mutex optimizedTranslationsMutex;
+    uint64_t lastOptimizedTranslationHandle = 0;
+    std::map<uint64_t, OptimizedTranslation> optimizedTranslations;
 };
 
 CIF_DEFINE_INTERFACE_TO_PIMPL_FORWARDING_CTOR_DTOR(IgcOclTranslationCtx);
@@ -1798,203 +1798,19 @@ DEFN_ARITH_OPERATIONS(double)
 DEFN_ARITH_OPERATIONS(half)
 #endif // defined(cl_khr_fp16)
 
-#define DEFN_WORK_GROUP_REDUCE(type, op, identity, X)                                       \
-{                                                                                          \
-    GET_MEMPOOL_PTR(data, type, true, 0)                                                     \
-    uint lid = __spirv_BuiltInLocalInvocationIndex();                                        \
-    uint lsize = __spirv_WorkgroupSize();                                                 \
-    data[lid] = X;                                                                       \
-    __builtin_spirv_OpControlBarrier_i32_i32_i32(Execution, 0, AcquireRelease | WorkgroupMemory);         \
-    uint mask = 1 << ( ((8 * sizeof(uint)) - __builtin_spirv_OpenCL_clz_i32(lsize - 1)) - 1) ;  \
-    while( mask > 0 )                                                                    \
-    {                                                                                    \
-        uint c = lid ^ mask;                                                             \
-        type other = ( c < lsize ) ? data[ c ] : identity;                                  \
-        X = op( other, X );                                                                 \
-        __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);     \
-        data[lid] = X;                                                              \
-        __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);     \
-        mask >>= 1;                                                                      \
-    }                                                                                    \
-    type ret = data[0];                                                                  \
-    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
-    return ret;                                                                           \
-}
-
-
-#define DEFN_WORK_GROUP_SCAN_INCL(type, op, identity, X)                                   \
-{                                                                                          \
-    GET_MEMPOOL_PTR(data, type, true, 0)                                                     \
-    uint lid = __spirv_BuiltInLocalInvocationIndex();                                         \
-    uint lsize = __spirv_WorkgroupSize();                                                 \
-    data[lid] = X;                                                                       \
-    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0,AcquireRelease |  WorkgroupMemory);         \
-    uint offset = 1;                                                                      \
-    while( offset < lsize )                                                              \
-    {                                                                                    \
-        type other = ( lid >= offset ) ?                                                  \
-                     data[ lid - offset ] :                                               \
-                     identity;                                                            \
-        X = op( X, other );                                                              \
-        __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);     \
-        data[lid] = X;                                                                   \
-        __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);     \
-        offset <<= 1;                                                                     \
-    }                                                                                    \
-    return X;                                                                            \
-}
-
-
-#define DEFN_WORK_GROUP_SCAN_EXCL(type, op, identity, X)                                   \
-{                                                                                         \
-    GET_MEMPOOL_PTR(data, type, true, 1)                                                 \
-    uint lid = __spirv_BuiltInLocalInvocationIndex();                                         \
-    uint lsize = __spirv_WorkgroupSize();                                                 \
-    data[0] = identity;                                                                  \
-    data[lid + 1] = X;                                                                   \
-    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
-    X = data[lid];                                                                       \
-    uint offset = 1;                                                                      \
-    while( offset < lsize )                                                              \
-    {                                                                                    \
-        type other = ( lid >= offset ) ?                                                  \
-                     data[ lid - offset ] :                                               \
-                     identity;                                                            \
-        X = op( X, other );                                                              \
-        __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);       \
-        data[lid] = X;                                                                   \
-        __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);       \
-        offset <<= 1;                                                                    \
-    }                                                                                    \
-    return X;                                                                            \
-}
-
-#define DEFN_SUB_GROUP_REDUCE(type, type_abbr, op, identity, X)                             \
-{                                                                                         \
-    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                 \
-    if(sgsize == 8)    \
-    {    \
-        X = op((type)intel_sub_group_shuffle( X, 0 ),    \
-                op((type)intel_sub_group_shuffle( X, 1 ),    \
-                op((type)intel_sub_group_shuffle( X, 2 ),    \
-                op((type)intel_sub_group_shuffle( X, 3 ),    \
-                op((type)intel_sub_group_shuffle( X, 4 ),    \
-                op((type)intel_sub_group_shuffle( X, 5 ),    \
-                op((type)intel_sub_group_shuffle( X, 6 ),(type)intel_sub_group_shuffle( X, 7 )    \
-                )))))));    \
-    }    \
-    else if(sgsize == 16)    \
-    {    \
-        X = op((type)intel_sub_group_shuffle( X, 0 ),    \
-                op((type)intel_sub_group_shuffle( X, 1 ),    \
-                op((type)intel_sub_group_shuffle( X, 2 ),    \
-                op((type)intel_sub_group_shuffle( X, 3 ),    \
-                op((type)intel_sub_group_shuffle( X, 4 ),    \
-                op((type)intel_sub_group_shuffle( X, 5 ),    \
-                op((type)intel_sub_group_shuffle( X, 6 ),    \
-                op((type)intel_sub_group_shuffle( X, 7 ),    \
-                op((type)intel_sub_group_shuffle( X, 8 ),    \
-                op((type)intel_sub_group_shuffle( X, 9 ),    \
-                op((type)intel_sub_group_shuffle( X, 10 ),    \
-                op((type)intel_sub_group_shuffle( X, 11 ),    \
-                op((type)intel_sub_group_shuffle( X, 12 ),    \
-                op((type)intel_sub_group_shuffle( X, 13 ),    \
-                op((type)intel_sub_group_shuffle( X, 14 ),(type)intel_sub_group_shuffle( X, 15 )    \
-                )))))))))))))));    \
-    }    \
-    else if(sgsize == 32)    \
-    {    \
-        X = op((type)intel_sub_group_shuffle( X, 0 ),    \
-                op((type)intel_sub_group_shuffle( X, 1 ),    \
-                op((type)intel_sub_group_shuffle( X, 2 ),    \
-                op((type)intel_sub_group_shuffle( X, 3 ),    \
-                op((type)intel_sub_group_shuffle( X, 4 ),    \
-                op((type)intel_sub_group_shuffle( X, 5 ),    \
-                op((type)intel_sub_group_shuffle( X, 6 ),    \
-                op((type)intel_sub_group_shuffle( X, 7 ),    \
-                op((type)intel_sub_group_shuffle( X, 8 ),    \
-                op((type)intel_sub_group_shuffle( X, 9 ),    \
-                op((type)intel_sub_group_shuffle( X, 10 ),    \
-                op((type)intel_sub_group_shuffle( X, 11 ),    \
-                op((type)intel_sub_group_shuffle( X, 12 ),    \
-                op((type)intel_sub_group_shuffle( X, 13 ),    \
-                op((type)intel_sub_group_shuffle( X, 14 ),    \
-                op((type)intel_sub_group_shuffle( X, 15 ),    \
-                op((type)intel_sub_group_shuffle( X, 16 ),    \
-                op((type)intel_sub_group_shuffle( X, 17 ),    \
-                op((type)intel_sub_group_shuffle( X, 18 ),    \
-                op((type)intel_sub_group_shuffle( X, 19 ),    \
-                op((type)intel_sub_group_shuffle( X, 20 ),    \
-                op((type)intel_sub_group_shuffle( X, 21 ),    \
-                op((type)intel_sub_group_shuffle( X, 22 ),    \
-                op((type)intel_sub_group_shuffle( X, 23 ),    \
-                op((type)intel_sub_group_shuffle( X, 24 ),    \
-                op((type)intel_sub_group_shuffle( X, 25 ),    \
-                op((type)intel_sub_group_shuffle( X, 26 ),    \
-                op((type)intel_sub_group_shuffle( X, 27 ),    \
-                op((type)intel_sub_group_shuffle( X, 28 ),    \
-                op((type)intel_sub_group_shuffle( X, 29 ),    \
-                op((type)intel_sub_group_shuffle( X, 30 ),(type)intel_sub_group_shuffle( X, 31 )    \
-                )))))))))))))))))))))))))))))));    \
-    }    \
-    else    \
-    {    \
-        uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                     \
-        uint mask = 1 << ( ((8 * sizeof(uint)) - __builtin_spirv_OpenCL_clz_i32(sgsize - 1)) - 1 ); \
-        while( mask > 0 )                                                                    \
-        {                                                                                    \
-            uint c = sglid ^ mask;                                                            \
-            type other = ( c < sgsize ) ?                                                      \
-                            intel_sub_group_shuffle( X, c ):                                       \
-                            identity;                                                            \
-            X = op( other, X );                                                                 \
-            mask >>= 1;                                                                      \
-        }    \
-    }    \
-    uint3 vec3;                                                                              \
-    vec3.s0 = 0;                                                                           \
-    return __builtin_spirv_OpGroupBroadcast_i32_##type_abbr##_v3i32(Subgroup, X, vec3 ); \
-}
-
-
-#define DEFN_SUB_GROUP_SCAN_INCL(type, type_abbr, op, identity, X)                        \
-{                                                                                         \
-    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                 \
-    uint offset = 1;                                                                      \
-    while( offset < sgsize )                                                             \
-    {                                                                                    \
-        type other = intel_sub_group_shuffle_up( (type)identity, X, offset );              \
-        X = op( X, other );                                                              \
-        offset <<= 1;                                                                    \
-    }                                                                                    \
-    return X;                                                                            \
-}
-
-#define DEFN_SUB_GROUP_SCAN_EXCL(type, type_abbr, op, identity, X)                        \
-{                                                                                         \
-    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                 \
-    X = intel_sub_group_shuffle_up( (type)identity, X, 1 );                              \
-    uint offset = 1;                                                                      \
-    while( offset < sgsize )                                                             \
-    {                                                                                    \
-        type other = intel_sub_group_shuffle_up( (type)identity, X, offset );              \
-        X = op( X, other );                                                              \
-        offset <<= 1;                                                                    \
-    }                                                                                    \
-    return X;                                                                            \
-}
-
-#define WORK_GROUP_SWITCH(type, op, identity, X, Operation)                                 \
+#include "include/group_collectives.cl"
+
+#define WORK_GROUP_SWITCH(type, op, identity, X, Operation, sg_func)                        \
 {                                                                                         \
     switch(Operation){                                                                     \
         case GroupOperationReduce:                                                         \
-            DEFN_WORK_GROUP_REDUCE(type, op, identity, X)                                 \
+            DEFN_WORK_GROUP_REDUCE(type, op, identity, X, sg_func)                        \
             break;                                                                         \
         case GroupOperationInclusiveScan:                                                 \
-            DEFN_WORK_GROUP_SCAN_INCL(type, op, identity, X)                             \
+            DEFN_WORK_GROUP_SCAN_INCL(type, op, identity, X, sg_func)                    \
             break;                                                                         \
         case GroupOperationExclusiveScan:                                                 \
-            DEFN_WORK_GROUP_SCAN_EXCL(type, op, identity, X)                             \
+            DEFN_WORK_GROUP_SCAN_EXCL(type, op, identity, X, sg_func)                    \
             break;                                                                         \
         default:                                                                         \
             return 0;                                                                    \
@@ -2021,33 +1837,37 @@ DEFN_ARITH_OPERATIONS(half)
 }
 
 #define DEFN_UNIFORM_GROUP_FUNC(func, type, type_abbr, op, identity)                             \
-type  __builtin_spirv_OpGroup##func##_i32_i32_##type_abbr(uint Execution, uint Operation, type X)       \
+static type __intel_sub_group_##func##_##type_abbr(uint Operation, type X)                       \
+{                                                                                                \
+    if (sizeof(X) < 8 || __UseNative64BitSubgroupBuiltin)                                        \
+    {                                                                                            \
+        if (Operation == GroupOperationReduce)                                                   \
+        {                                                                                        \
+            return __builtin_IB_sub_group_reduce_##func##_##type_abbr(X);                        \
+        }                                                                                        \
+        else if (Operation == GroupOperationInclusiveScan)                                       \
+        {                                                                                        \
+            return op(X, __builtin_IB_sub_group_scan_##func##_##type_abbr(X));                   \
+        }                                                                                        \
+        else if (Operation == GroupOperationExclusiveScan)                                       \
+        {                                                                                        \
+            return __builtin_IB_sub_group_scan_##func##_##type_abbr(X);                          \
+        }                                                                                        \
+    }                                                                                            \
+    else {                                                                                       \
+        SUB_GROUP_SWITCH(type, type_abbr, op, identity, X, Operation)                            \
+    }                                                                                            \
+    return 0;                                                                                    \
+}                                                                                                \
+type  __builtin_spirv_OpGroup##func##_i32_i32_##type_abbr(uint Execution, uint Operation, type X)\
 {                                                                                                \
     if (Execution == Workgroup)                                                                  \
     {                                                                                            \
-        WORK_GROUP_SWITCH(type, op, identity, X, Operation)                                      \
+        WORK_GROUP_SWITCH(type, op, identity, X, Operation, __intel_sub_group_##func##_##type_abbr)\
     }                                                                                            \
     else if (Execution == Subgroup)                                                              \
-    {                                                                                             \
-        if (sizeof(X) < 8 || __UseNative64BitSubgroupBuiltin)                                            \
-        {                                                                                        \
-            if (Operation == GroupOperationReduce)                                                     \
-            {                                                                                         \
-                return __builtin_IB_sub_group_reduce_##func##_##type_abbr(X);                         \
-            }                                                                                         \
-            else if (Operation == GroupOperationInclusiveScan)                                         \
-            {                                                                                         \
-                return op(X, __builtin_IB_sub_group_scan_##func##_##type_abbr(X));                     \
-            }                                                                                         \
-            else if (Operation == GroupOperationExclusiveScan)                                         \
-            {                                                                                         \
-                return __builtin_IB_sub_group_scan_##func##_##type_abbr(X);                           \
-            }                                                                                         \
-        }                                                                                         \
-        else {                                                                                     \
-            SUB_GROUP_SWITCH(type, type_abbr, op, identity, X, Operation)                         \
-        }                                                                                         \
-        return 0;                                                                                 \
+    {                                                                                            \
+        return __intel_sub_group_##func##_##type_abbr(Operation, X);                             \
     }                                                                                            \
     else                                                                                         \
     {                                                                                            \
@@ -2095,90 +1915,6 @@ DEFN_UNIFORM_GROUP_FUNC(SMax, int,    i32, __builtin_spirv_OpenCL_s_max_i32_i32,
 DEFN_UNIFORM_GROUP_FUNC(SMax, long,   i64, __builtin_spirv_OpenCL_s_max_i64_i64, LONG_MIN)
 
 #if defined(cl_khr_subgroup_non_uniform_arithmetic) || defined(cl_khr_subgroup_clustered_reduce)
-#define DEFN_SUB_GROUP_REDUCE_NON_UNIFORM(type, type_abbr, op, identity, X)                         \
-{                                                                                                   \
-    uint activeChannels = __builtin_IB_WaveBallot(true);                                            \
-    uint firstActive = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                              \
-                                                                                                    \
-    type result = identity;                                                                         \
-    while (activeChannels)                                                                          \
-    {                                                                                               \
-        uint activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                             \
-                                                                                                    \
-        type value = intel_sub_group_shuffle(X, activeId);                                          \
-        result = op(value, result);                                                                 \
-                                                                                                    \
-        uint disable = 1 << activeId;                                                               \
-        activeChannels ^= disable;                                                                  \
-    }                                                                                               \
-                                                                                                    \
-    uint3 vec3;                                                                                     \
-    vec3.s0 = firstActive;                                                                          \
-    X = __builtin_spirv_OpGroupBroadcast_i32_##type_abbr##_v3i32(Subgroup, result, vec3);           \
-}
-
-#define DEFN_SUB_GROUP_SCAN_INCL_NON_UNIFORM(type, type_abbr, op, identity, X)                      \
-{                                                                                                   \
-    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                                \
-    uint activeChannels = __builtin_IB_WaveBallot(true);                                            \
-    uint activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                                 \
-    activeChannels ^= 1 << activeId;                                                                \
-    while (activeChannels)                                                                          \
-    {                                                                                               \
-        type value = intel_sub_group_shuffle(X, activeId);                                          \
-        activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                                  \
-        if (sglid == activeId)                                                                      \
-            X = op(value, X);                                                                       \
-        activeChannels ^= 1 << activeId;                                                            \
-    }                                                                                               \
-}
-
-#define DEFN_SUB_GROUP_SCAN_EXCL_NON_UNIFORM(type, type_abbr, op, identity, X)                       \
-{                                                                                                    \
-    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                                 \
-    uint activeChannels = __builtin_IB_WaveBallot(true);                                             \
-    type result = identity;                                                                          \
-    while (activeChannels)                                                                           \
-    {                                                                                                \
-        uint activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                              \
-        if (sglid == activeId)                                                                       \
-        {                                                                                            \
-            type value = X;                                                                          \
-            X = result;                                                                              \
-            result = op(result, value);                                                              \
-        }                                                                                            \
-        result = sub_group_shuffle(result, activeId);                                                \
-        activeChannels ^= 1 << activeId;                                                             \
-    }                                                                                                \
-}
-
-#define DEFN_SUB_GROUP_CLUSTERED_REDUCE(type, type_abbr, op, identity, X, ClusterSize)                         \
-{                                                                                                              \
-    uint clusterIndex = 0;                                                                                     \
-    uint activeChannels = __builtin_IB_WaveBallot(true);                                                       \
-    uint numActive = __builtin_spirv_OpenCL_popcount_i32(activeChannels);                                      \
-    uint numClusters = numActive / ClusterSize;                                                                \
-                                                                                                               \
-    for (uint clusterIndex = 0; clusterIndex < numClusters; clusterIndex++)                                    \
-    {                                                                                                          \
-        uint Counter = ClusterSize;                                                                            \
-        uint Ballot = activeChannels;                                                                          \
-        uint clusterBallot = 0;                                                                                \
-        while (Counter--)                                                                                      \
-        {                                                                                                      \
-            uint trailingOne = 1 << __builtin_spirv_OpenCL_ctz_i32(Ballot);                                    \
-            clusterBallot |= trailingOne;                                                                      \
-            Ballot ^= trailingOne;                                                                             \
-        }                                                                                                      \
-        uint active = __builtin_spirv_OpGroupNonUniformInverseBallot_i32_v4i32(Subgroup, clusterBallot);       \
-        if (active)                                                                                            \
-        {                                                                                                      \
-            DEFN_SUB_GROUP_REDUCE_NON_UNIFORM(type, type_abbr, op, identity, X)                                \
-        }                                                                                                      \
-        activeChannels ^= clusterBallot;                                                                       \
-    }                                                                                                          \
-}
-
 #define SUB_GROUP_SWITCH_NON_UNIFORM(type, type_abbr, op, identity, X, Operation, ClusterSize) \
 {                                                                                              \
     switch (Operation){                                                                        \
@@ -0,0 +1,282 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Algorithms behind the work-group collectives and the uniform and non-uniform
+// sub-group collectives. They only rely on the sub-group builtins, so the same
+// definitions can be exercised on the host by the collective emulation tests in
+// IGC/Compiler/tests/BiFGroup.
+
+#ifndef __GROUP_COLLECTIVES_CL__
+#define __GROUP_COLLECTIVES_CL__
+
+// Work-group collectives are built on the sub-group ones: every sub-group
+// reduces/scans its own items, publishes a single partial per sub-group to SLM,
+// and after one barrier each sub-group folds the partials it needs with one more
+// sub-group reduction. The trailing barrier only protects the SLM pool from the
+// next collective. sg_func(Operation, X) is the sub-group implementation.
+// The trailing sub-group may be partial, so the partials are strided by the lane
+// count of the folding sub-group rather than by the maximum sub-group size.
+#define DEFN_WORK_GROUP_REDUCE(type, op, identity, X, sg_func)                              \
+{                                                                                           \
+    GET_MEMPOOL_PTR(data, type, true, 0)                                                    \
+    uint sgid = __builtin_spirv_BuiltInSubgroupId();                                        \
+    uint numsg = __builtin_spirv_BuiltInNumSubgroups();                                     \
+    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                        \
+    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                    \
+    X = sg_func(GroupOperationReduce, X);                                                   \
+    if (numsg == 1)                                                                         \
+        return X;                                                                           \
+    if (sglid == 0)                                                                         \
+        data[sgid] = X;                                                                     \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);\
+    X = identity;                                                                           \
+    for (uint i = sglid; i < numsg; i += sgsize)                                            \
+        X = op(X, data[i]);                                                                 \
+    X = sg_func(GroupOperationReduce, X);                                                   \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);\
+    return X;                                                                               \
+}
+
+
+#define DEFN_WORK_GROUP_SCAN_INCL(type, op, identity, X, sg_func)                           \
+{                                                                                           \
+    GET_MEMPOOL_PTR(data, type, true, 0)                                                    \
+    uint sgid = __builtin_spirv_BuiltInSubgroupId();                                        \
+    uint numsg = __builtin_spirv_BuiltInNumSubgroups();                                     \
+    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                        \
+    uint sgmax = __builtin_spirv_BuiltInSubgroupMaxSize();                                  \
+    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                    \
+    type scan = sg_func(GroupOperationInclusiveScan, X);                                    \
+    if (numsg == 1)                                                                         \
+        return scan;                                                                        \
+    /* only full sub-groups have successors, so their last lane holds the total */          \
+    if (sglid == sgmax - 1)                                                                 \
+        data[sgid] = scan;                                                                  \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);\
+    type carry = identity;                                                                  \
+    for (uint i = sglid; i < sgid; i += sgsize)                                             \
+        carry = op(carry, data[i]);                                                         \
+    carry = sg_func(GroupOperationReduce, carry);                                           \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);\
+    return op(carry, scan);                                                                 \
+}
+
+
+#define DEFN_WORK_GROUP_SCAN_EXCL(type, op, identity, X, sg_func)                           \
+{                                                                                           \
+    GET_MEMPOOL_PTR(data, type, true, 0)                                                    \
+    uint sgid = __builtin_spirv_BuiltInSubgroupId();                                        \
+    uint numsg = __builtin_spirv_BuiltInNumSubgroups();                                     \
+    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                        \
+    uint sgmax = __builtin_spirv_BuiltInSubgroupMaxSize();                                  \
+    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                    \
+    type scan = sg_func(GroupOperationExclusiveScan, X);                                    \
+    if (numsg == 1)                                                                         \
+        return scan;                                                                        \
+    /* only full sub-groups have successors, so their last lane holds the total */          \
+    if (sglid == sgmax - 1)                                                                 \
+        data[sgid] = op(scan, X);                                                           \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);\
+    type carry = identity;                                                                  \
+    for (uint i = sglid; i < sgid; i += sgsize)                                             \
+        carry = op(carry, data[i]);                                                         \
+    carry = sg_func(GroupOperationReduce, carry);                                           \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);\
+    return op(carry, scan);                                                                 \
+}
+
+// Power-of-two sub-groups reduce with a log2(sgsize) xor-shuffle butterfly, after
+// which every channel holds the full result.  Other sizes pad the missing partners
+// with the identity, so only channel 0 is guaranteed to be exact and is broadcast.
+// Every channel shuffles on every step, since sub-group functions must be reached
+// by the whole sub-group; the ones without a partner fold in the identity instead.
+#define DEFN_SUB_GROUP_REDUCE(type, type_abbr, op, identity, X)                             \
+{                                                                                         \
+    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                 \
+    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                     \
+    if ((sgsize & (sgsize - 1)) == 0)                                                    \
+    {                                                                                    \
+        for (uint mask = sgsize >> 1; mask > 0; mask >>= 1)                              \
+        {                                                                                \
+            X = op( X, (type)intel_sub_group_shuffle( X, sglid ^ mask ) );               \
+        }                                                                                \
+        return X;                                                                        \
+    }                                                                                    \
+    uint mask = 1 << ( ((8 * sizeof(uint)) - __builtin_spirv_OpenCL_clz_i32(sgsize - 1)) - 1 ); \
+    while( mask > 0 )                                                                    \
+    {                                                                                    \
+        uint c = sglid ^ mask;                                                            \
+        type other = intel_sub_group_shuffle( X, ( c < sgsize ) ? c : sglid );            \
+        X = op( ( c < sgsize ) ? other : (type)identity, X );                             \
+        mask >>= 1;                                                                      \
+    }                                                                                    \
+    uint3 vec3;                                                                              \
+    vec3.s0 = 0;                                                                           \
+    return __builtin_spirv_OpGroupBroadcast_i32_##type_abbr##_v3i32(Subgroup, X, vec3 ); \
+}
+
+#define DEFN_SUB_GROUP_SCAN_INCL(type, type_abbr, op, identity, X)                        \
+{                                                                                         \
+    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                 \
+    uint offset = 1;                                                                      \
+    while( offset < sgsize )                                                             \
+    {                                                                                    \
+        type other = intel_sub_group_shuffle_up( (type)identity, X, offset );              \
+        X = op( X, other );                                                              \
+        offset <<= 1;                                                                    \
+    }                                                                                    \
+    return X;                                                                            \
+}
+
+#define DEFN_SUB_GROUP_SCAN_EXCL(type, type_abbr, op, identity, X)                        \
+{                                                                                         \
+    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                 \
+    X = intel_sub_group_shuffle_up( (type)identity, X, 1 );                              \
+    uint offset = 1;                                                                      \
+    while( offset < sgsize )                                                             \
+    {                                                                                    \
+        type other = intel_sub_group_shuffle_up( (type)identity, X, offset );              \
+        X = op( X, other );                                                              \
+        offset <<= 1;                                                                    \
+    }                                                                                    \
+    return X;                                                                            \
+}
+
+// Reduces X within aligned groups of ClusterSize channels using log2(ClusterSize)
+// xor-shuffle steps.  Only valid when every channel of the sub-group is active,
+// since inactive channels would not carry their partial results forward.
+#define DEFN_SUB_GROUP_BUTTERFLY_REDUCE(type, op, X, ClusterSize)                                  \
+{                                                                                                   \
+    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                                \
+    for (uint mask = (ClusterSize) >> 1; mask > 0; mask >>= 1)                                      \
+    {                                                                                               \
+        X = op(X, (type)intel_sub_group_shuffle(X, sglid ^ mask));                                  \
+    }                                                                                               \
+}
+
+// Non-zero when the whole sub-group is active and its size is a power of two.
+#define SUB_GROUP_IS_FULL_POW2(activeChannels, sgsize)                                              \
+    (((sgsize) & ((sgsize) - 1)) == 0 &&                                                            \
+     (activeChannels) == ((sgsize) == 32 ? 0xFFFFFFFF : ((1u << (sgsize)) - 1)))
+
+#define DEFN_SUB_GROUP_REDUCE_NON_UNIFORM(type, type_abbr, op, identity, X)                         \
+{                                                                                                   \
+    uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                            \
+    uint activeChannels = __builtin_IB_WaveBallot(true);                                            \
+    if (SUB_GROUP_IS_FULL_POW2(activeChannels, sgsize))                                             \
+    {                                                                                               \
+        DEFN_SUB_GROUP_BUTTERFLY_REDUCE(type, op, X, sgsize)                                        \
+    }                                                                                               \
+    else                                                                                            \
+    {                                                                                               \
+        uint firstActive = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                          \
+                                                                                                    \
+        type result = identity;                                                                     \
+        while (activeChannels)                                                                      \
+        {                                                                                           \
+            uint activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                         \
+                                                                                                    \
+            type value = intel_sub_group_shuffle(X, activeId);                                      \
+            result = op(value, result);                                                             \
+                                                                                                    \
+            uint disable = 1 << activeId;                                                           \
+            activeChannels ^= disable;                                                              \
+        }                                                                                           \
+                                                                                                    \
+        uint3 vec3;                                                                                 \
+        vec3.s0 = firstActive;                                                                      \
+        X = __builtin_spirv_OpGroupBroadcast_i32_##type_abbr##_v3i32(Subgroup, result, vec3);       \
+    }                                                                                               \
+}
+
+#define DEFN_SUB_GROUP_SCAN_INCL_NON_UNIFORM(type, type_abbr, op, identity, X)                      \
+{                                                                                                   \
+    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                                \
+    uint activeChannels = __builtin_IB_WaveBallot(true);                                            \
+    uint activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                                 \
+    activeChannels ^= 1 << activeId;                                                                \
+    while (activeChannels)                                                                          \
+    {                                                                                               \
+        type value = intel_sub_group_shuffle(X, activeId);                                          \
+        activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                                  \
+        if (sglid == activeId)                                                                      \
+            X = op(value, X);                                                                       \
+        activeChannels ^= 1 << activeId;                                                            \
+    }                                                                                               \
+}
+
+#define DEFN_SUB_GROUP_SCAN_EXCL_NON_UNIFORM(type, type_abbr, op, identity, X)                       \
+{                                                                                                    \
+    uint sglid = __builtin_spirv_BuiltInSubgroupLocalInvocationId();                                 \
+    uint activeChannels = __builtin_IB_WaveBallot(true);                                             \
+    type result = identity;                                                                          \
+    while (activeChannels)                                                                           \
+    {                                                                                                \
+        uint activeId = __builtin_spirv_OpenCL_ctz_i32(activeChannels);                              \
+        if (sglid == activeId)                                                                       \
+        {                                                                                            \
+            type value = X;                                                                          \
+            X = result;                                                                              \
+            result = op(result, value);                                                              \
+        }                                                                                            \
+        result = sub_group_shuffle(result, activeId);                                                \
+        activeChannels ^= 1 << activeId;                                                             \
+    }                                                                                                \
+}
+
+#define DEFN_SUB_GROUP_CLUSTERED_REDUCE(type, type_abbr, op, identity, X, ClusterSize)                         \
+{                                                                                                              \
+    uint clusterIndex = 0;                                                                                     \
+    uint activeChannels = __builtin_IB_WaveBallot(true);                                                       \
+    if (SUB_GROUP_IS_FULL_POW2(activeChannels, __builtin_spirv_BuiltInSubgroupSize()))                        \
+    {                                                                                                          \
+        DEFN_SUB_GROUP_BUTTERFLY_REDUCE(type, op, X, ClusterSize)                                              \
+        return X;                                                                                              \
+    }                                                                                                          \
+    uint numActive = __builtin_spirv_OpenCL_popcount_i32(activeChannels);                                      \
+    uint numClusters = numActive / ClusterSize;                                                                \
+                                                                                                               \
+    for (uint clusterIndex = 0; clusterIndex < numClusters; clusterIndex++)                                    \
+    {                                                                                                          \
+        uint Counter = ClusterSize;                                                                            \
+        uint Ballot = activeChannels;                                                                          \
+        uint clusterBallot = 0;                                                                                \
+        while (Counter--)                                                                                      \
+        {                                                                                                      \
+            uint trailingOne = 1 << __builtin_spirv_OpenCL_ctz_i32(Ballot);                                    \
+            clusterBallot |= trailingOne;                                                                      \
+            Ballot ^= trailingOne;                                                                             \
+        }                                                                                                      \
+        uint active = __builtin_spirv_OpGroupNonUniformInverseBallot_i32_v4i32(Subgroup, clusterBallot);       \
+        if (active)                                                                                            \
+        {                                                                                                      \
+            DEFN_SUB_GROUP_REDUCE_NON_UNIFORM(type, type_abbr, op, identity, X)                                \
+        }                                                                                                      \
+        activeChannels ^= clusterBallot;                                                                       \
+    }                                                                                                          \
+}
+
+#endif // __GROUP_COLLECTIVES_CL__
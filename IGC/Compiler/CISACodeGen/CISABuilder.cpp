@@ -3924,6 +3924,8 @@ namespace IGC
             // Check if preRA scheduler is disabled from input.
             if (isOptDisabled)
                 return false;
+            if (context->DegradeForCompileTime(COMPILE_TIME_DEGRADE_PRE_RA_SCHED))
+                return false;
             if (context->type == ShaderType::OPENCL_SHADER) {
                 auto ClContext = static_cast<OpenCLProgramContext*>(context);
                 if (!ClContext->m_InternalOptions.IntelEnablePreRAScheduling)
@@ -4008,7 +4010,15 @@ namespace IGC
             SaveOption(vISA_enablePreemption, true);
         }
 
-        if (IGC_IS_FLAG_ENABLED(forceGlobalRA))
+        // Under compile-time pressure stay with the linear-scan local RA and
+        // the cheap spill code generation instead of iterating global RA.
+        bool fastRA = context->DegradeForCompileTime(COMPILE_TIME_DEGRADE_FAST_RA);
+        if (fastRA)
+        {
+            SaveOption(vISA_FastSpill, true);
+        }
+
+        if (IGC_IS_FLAG_ENABLED(forceGlobalRA) && !fastRA)
         {
             SaveOption(vISA_LocalRA, false);
             SaveOption(vISA_LocalBankConflictReduction, false);
@@ -4348,24 +4358,25 @@ namespace IGC
 
         llvm::SmallVector<const char*, 10> params;
         llvm::SmallVector<std::unique_ptr< char, std::function<void(char*)>>, 10> params2;
-        if (!m_hasInlineAsm)
+        InitBuildParams(params2);
+        for (size_t i = 0; i < params2.size(); i++)
         {
-            // Asm text writer mode doesnt need dump params
-            InitBuildParams(params2);
-            for (size_t i = 0; i < params2.size(); i++)
-            {
-                params.push_back((params2[i].get()));
-            }
+            params.push_back((params2[i].get()));
         }
 
         COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISACompile);
         bool enableVISADump = IGC_IS_FLAG_ENABLED(EnableVISASlowpath) || IGC_IS_FLAG_ENABLED(ShaderDumpEnable);
-        auto builderMode = m_hasInlineAsm ? vISA_ASM_WRITER : vISA_3D;
-        auto builderOpt = (enableVISADump || m_hasInlineAsm) ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
-        V(CreateVISABuilder(vbuilder, builderMode, builderOpt, VISAPlatform, params.size(), params.data(),
+        auto builderOpt = enableVISADump ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
+        V(CreateVISABuilder(vbuilder, vISA_3D, builderOpt, VISAPlatform, params.size(), params.data(),
             &m_vISAWaTable));
 
         InitVISABuilderOptions(VISAPlatform, canAbortOnSpill, hasStackCall, builderOpt == VISA_BUILDER_BOTH);
+        if (m_hasInlineAsm)
+        {
+            // Inline asm is parsed straight into vKernel by EmitInlineAsm,
+            // so declarations must be reachable by name.
+            SaveOption(vISA_DirectInlineAsm, true);
+        }
 
         // Pass all build options to builder
         SetBuilderOptions(vbuilder);
@@ -4924,13 +4935,9 @@ namespace IGC
             }
         }
 
-        // Compile generated VISA text string for inlineAsm
-        if (m_hasInlineAsm || visaAsmOverride)
+        // Compile the override visaasm in place of the generated kernel
+        if (visaAsmOverride)
         {
-            // Finalize the text builder by writing the header
-            if (m_hasInlineAsm)
-                V(vbuilder->WriteVISAHeader());
-
             llvm::SmallVector<const char*, 10> params;
             llvm::SmallVector<std::unique_ptr< char, std::function<void( char*)>>, 10> params2;
             InitBuildParams(params2);
@@ -4946,23 +4953,14 @@ namespace IGC
             // Use the same build options as before
             SetBuilderOptions(vAsmTextBuilder);
 
-            // Parse the generated VISA text
-            if (visaAsmOverride)
-            {
-                // Manually set the asm file path instead of using the path provided in the override shader file
-                std::string asmName = GetDumpFileName("");
-                asmName.pop_back();
-                vAsmTextBuilder->SetOption(VISA_AsmFileNameUser, true);
-                vAsmTextBuilder->SetOption(VISA_AsmFileName, asmName.c_str());
-                V(vAsmTextBuilder->ParseVISAText(visaAsmOverrideFile));
-                asmName = asmName + ".visaasm";
-                appendToShaderOverrideLogFile(asmName, "OVERRIDEN: ");
-            }
-            else
-            {
-                std::string parseTextFile = m_enableVISAdump ? GetDumpFileName("inline.visaasm") : "";
-                V(vAsmTextBuilder->ParseVISAText(vbuilder->GetAsmTextHeaderStream().str(), vbuilder->GetAsmTextStream().str(), parseTextFile));
-            }
+            // Manually set the asm file path instead of using the path provided in the override shader file
+            std::string asmName = GetDumpFileName("");
+            asmName.pop_back();
+            vAsmTextBuilder->SetOption(VISA_AsmFileNameUser, true);
+            vAsmTextBuilder->SetOption(VISA_AsmFileName, asmName.c_str());
+            V(vAsmTextBuilder->ParseVISAText(visaAsmOverrideFile));
+            asmName = asmName + ".visaasm";
+            appendToShaderOverrideLogFile(asmName, "OVERRIDEN: ");
 
             pMainKernel = vAsmTextBuilder->GetVISAKernel();
             vIsaCompile = vAsmTextBuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
@@ -112,11 +112,30 @@ void CShader::InitEncoder(SIMDMode simdSize, bool canAbortOnSpill, ShaderDispatc
     symbolMapping.clear();
     ccTupleMapping.clear();
     ConstantPool.clear();
+    ReserveSymbolTables(entry);
     setup.clear();
     patchConstantSetup.clear();
     encoder.SetProgram(this);
 }
 
+// GetSymbol looks up symbolMapping for nearly every operand emitted, and the
+// table otherwise grows by rehashing while the function is translated. Size it
+// for one entry per argument and instruction, the same numbering
+// TranslationTable uses, keeping the load factor below 75%.
+void CShader::ReserveSymbolTables(llvm::Function* F)
+{
+    if (!F)
+    {
+        return;
+    }
+    unsigned numValues = (unsigned)F->arg_size();
+    for (auto& BB : *F)
+    {
+        numValues += (unsigned)BB.size();
+    }
+    symbolMapping.reserve(symbolMapping.size() + numValues);
+}
+
 // Pre-analysis pass to be executed before call to visa builder so we can pass scratch space offset
 void CShader::PreAnalysisPass()
 {
@@ -2107,6 +2126,7 @@ void CShader::BeginFunction(llvm::Function* F)
         symbolMapping.clear();
     ccTupleMapping.clear();
     ConstantPool.clear();
+    ReserveSymbolTables(F);
 
     bool useStackCall = m_FGA && m_FGA->useStackCall(F);
     if (useStackCall)
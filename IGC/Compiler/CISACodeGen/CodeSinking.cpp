@@ -283,61 +283,70 @@ namespace IGC {
         return everMadeChange || changed;
     }
 
+    // Return true if inst has a use outside blk, ignoring uses by skipUser.
+    // PHI nodes use the operand in the predecessor block, not the block with
+    // the PHI.
+    static bool IsUsedOutside(Instruction* inst, BasicBlock* blk, Instruction* skipUser = nullptr)
+    {
+        for (Value::user_iterator useI = inst->user_begin(), useE = inst->user_end();
+            useI != useE; ++useI)
+        {
+            Instruction* useInst = cast<Instruction>(*useI);
+            if (useInst == skipUser || useInst->getParent() == blk)
+                continue;
+            if (PHINode * PN = dyn_cast<PHINode>(useInst))
+            {
+                Use& U = useI.getUse();
+                unsigned num = PHINode::getIncomingValueNumForOperand(U.getOperandNo());
+                if (PN->getIncomingBlock(num) == blk)
+                    continue;
+            }
+            return true;
+        }
+        return false;
+    }
+
     static uint EstimateLiveOutPressure(BasicBlock* blk, const DataLayout* DL)
     {
-        // Walk the basic block bottom-up.  Remember if we saw a store.
         uint pressure = 0;
-        BasicBlock::iterator I = blk->end();
-        --I;
-        bool processedBegin = false;
-        do {
-            Instruction* inst = &(*I);  // The instruction to sink.
-
-            // Predecrement I (if it's not begin) so that it isn't invalidated by sinking.
-            processedBegin = (I == blk->begin());
-            if (!processedBegin)
-                --I;
-
-            if (isa<DbgInfoIntrinsic>(inst))
-                continue;
+        for (auto& I : *blk)
+        {
             // intrinsic like discard has no explicit use, get skipped here
-            if (inst->use_empty())
+            if (isa<DbgInfoIntrinsic>(&I) || I.use_empty())
                 continue;
 
-            bool useOutside = false;
-            for (Value::user_iterator useI = inst->user_begin(), useE = inst->user_end();
-                !useOutside && useI != useE; ++useI)
+            // estimate register usage by value
+            if (IsUsedOutside(&I, blk))
             {
-                // Determine the block of the use.
-                Instruction* useInst = cast<Instruction>(*useI);
-                BasicBlock* useBlock = useInst->getParent();
-                if (useBlock != blk)
-                {
-                    if (PHINode * PN = dyn_cast<PHINode>(useInst))
-                    {
-                        // PHI nodes use the operand in the predecessor block,
-                        // not the block with the PHI.
-                        Use& U = useI.getUse();
-                        unsigned num = PHINode::getIncomingValueNumForOperand(U.getOperandNo());
-                        if (PN->getIncomingBlock(num) != blk)
-                        {
-                            useOutside = true;
-                        }
-                    }
-                    else
-                    {
-                        useOutside = true;
-                    }
-                }
+                pressure += (uint)(DL->getTypeAllocSize(I.getType()));
             }
+        }
+        return pressure;
+    }
 
-            // estimate register usage by value
-            if (useOutside)
+    // Update the live-out pressure of blk after inst has been sunk out of it.
+    // Only inst and its operands defined in blk can change their live-out
+    // status, so there is no need to rescan the block.
+    static uint UpdateLiveOutPressure(uint pressure, Instruction* inst, BasicBlock* blk, const DataLayout* DL)
+    {
+        // inst no longer lives in blk
+        if (IsUsedOutside(inst, blk))
+        {
+            pressure -= (uint)(DL->getTypeAllocSize(inst->getType()));
+        }
+
+        // operands in blk now have a use outside of it
+        SmallPtrSet<Instruction*, 4> seen;
+        for (Value* opnd : inst->operands())
+        {
+            Instruction* opndInst = dyn_cast<Instruction>(opnd);
+            if (!opndInst || opndInst->getParent() != blk || !seen.insert(opndInst).second)
+                continue;
+            if (!IsUsedOutside(opndInst, blk, inst))
             {
-                pressure += (uint)(DL->getTypeAllocSize(inst->getType()));
+                pressure += (uint)(DL->getTypeAllocSize(opndInst->getType()));
             }
-            // If we just processed the first instruction in the block, we're done.
-        } while (!processedBegin);
+        }
         return pressure;
     }
 
@@ -349,10 +358,12 @@ namespace IGC {
         uint32_t registerPressureThreshold = CTX->getNumGRFPerThread();
 
         uint pressure0 = 0;
+        uint pressure1 = 0;
         if (generalCodeSinking && registerPressureThreshold)
         {
             // estimate live-out register pressure for this blk
             pressure0 = EstimateLiveOutPressure(&blk, DL);
+            pressure1 = pressure0;
 
             // Track the highest-pressure BB within a loop
             if (pressure0 > m_fatBBPressure && LI->getLoopFor(&blk)) {
@@ -398,6 +409,10 @@ namespace IGC {
                 // diagnosis code:    continue;
                 if (SinkInstruction(inst, stores, false))
                 {
+                    if (generalCodeSinking && registerPressureThreshold)
+                    {
+                        pressure1 = UpdateLiveOutPressure(pressure1, inst, &blk, DL);
+                    }
                     madeChange = true;
                     movedInsts.push_back(inst);
                     undoLocas.push_back(undoLoca);
@@ -411,8 +426,7 @@ namespace IGC {
         {
             if (madeChange)
             {
-                // measure the live-out register pressure again
-                uint pressure1 = EstimateLiveOutPressure(&blk, DL);
+                // pressure1 has been kept up to date while sinking
                 if (pressure1 > pressure0 + registerPressureThreshold)
                 {
                     // undo code motion
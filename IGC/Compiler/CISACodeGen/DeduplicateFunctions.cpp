@@ -0,0 +1,174 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "Compiler/CISACodeGen/DeduplicateFunctions.h"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "AdaptorCommon/ImplicitArgs.hpp"
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/FunctionComparator.h"
+#include "common/LLVMWarningsPop.hpp"
+#include "Probe/Assertion.h"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+char DeduplicateFunctions::ID = 0;
+
+IGC_INITIALIZE_PASS_BEGIN(DeduplicateFunctions, "DeduplicateFunctions", "DeduplicateFunctions", false, false)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(DeduplicateFunctions, "DeduplicateFunctions", "DeduplicateFunctions", false, false)
+
+llvm::ModulePass* IGC::createDeduplicateFunctionsPass()
+{
+    initializeDeduplicateFunctionsPass(*PassRegistry::getPassRegistry());
+    return new DeduplicateFunctions;
+}
+
+DeduplicateFunctions::DeduplicateFunctions() : llvm::ModulePass(ID)
+{
+    initializeDeduplicateFunctionsPass(*PassRegistry::getPassRegistry());
+}
+
+void DeduplicateFunctions::getAnalysisUsage(AnalysisUsage& AU) const
+{
+    AU.addRequired<MetaDataUtilsWrapper>();
+}
+
+// Only internal subroutines that are reached exclusively through direct calls
+// can be replaced without anyone observing the function's identity. Kernels
+// are looked up by name at runtime and each gets its own binary whose header
+// carries that name; KernelBinaryReuse only splices a binary back under the
+// kernel it was compiled for, so there is nothing that could stand in for a
+// folded kernel.
+static bool isCandidate(MetaDataUtils* pMdUtils, Function& F)
+{
+    if (F.isDeclaration() || !F.hasLocalLinkage() || isEntryFunc(pMdUtils, &F))
+        return false;
+    if (F.hasFnAttribute("IndirectlyCalled") || F.getSubprogram())
+        return false;
+
+    for (auto U : F.users())
+    {
+        CallInst* CI = dyn_cast<CallInst>(U);
+        if (!CI || CI->getCalledFunction() != &F)
+            return false;
+    }
+    return !F.use_empty();
+}
+
+// FunctionComparator only looks at the IR; the implicit arguments appended by
+// AddImplicitArgs are described in metadata and must agree as well.
+static bool haveSameImplicitArgs(MetaDataUtils* pMdUtils, Function* F1, Function* F2)
+{
+    bool HasInfo1 = pMdUtils->findFunctionsInfoItem(F1) != pMdUtils->end_FunctionsInfo();
+    bool HasInfo2 = pMdUtils->findFunctionsInfoItem(F2) != pMdUtils->end_FunctionsInfo();
+    if (HasInfo1 != HasInfo2)
+        return false;
+    if (!HasInfo1)
+        return true;
+
+    ImplicitArgs IA1(*F1, pMdUtils);
+    ImplicitArgs IA2(*F2, pMdUtils);
+    if (IA1.size() != IA2.size())
+        return false;
+    for (unsigned i = 0, e = IA1.size(); i < e; ++i)
+    {
+        if (IA1.getArgType(i) != IA2.getArgType(i))
+            return false;
+    }
+    return true;
+}
+
+bool DeduplicateFunctions::runOnModule(Module& M)
+{
+    MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+    GlobalNumberState GlobalNumbers;
+    bool Changed = false;
+
+    // Merging callees can make their callers identical, so repeat until
+    // nothing else folds.
+    bool LocalChanged = true;
+    while (LocalChanged)
+    {
+        LocalChanged = false;
+
+        DenseMap<FunctionComparator::FunctionHash, SmallVector<Function*, 4>> Buckets;
+        for (auto& F : M)
+        {
+            if (isCandidate(pMdUtils, F))
+                Buckets[FunctionComparator::functionHash(F)].push_back(&F);
+        }
+
+        SmallVector<Function*, 16> Dead;
+        for (auto& Bucket : Buckets)
+        {
+            SmallVector<Function*, 4>& Funcs = Bucket.second;
+            for (unsigned i = 0; i < Funcs.size(); ++i)
+            {
+                Function* Rep = Funcs[i];
+                if (!Rep)
+                    continue;
+                for (unsigned j = i + 1; j < Funcs.size(); ++j)
+                {
+                    Function* Dup = Funcs[j];
+                    if (!Dup ||
+                        FunctionComparator(Rep, Dup, &GlobalNumbers).compare() != 0 ||
+                        !haveSameImplicitArgs(pMdUtils, Rep, Dup))
+                        continue;
+
+                    Dup->replaceAllUsesWith(Rep);
+                    Dead.push_back(Dup);
+                    Funcs[j] = nullptr;
+                }
+            }
+        }
+
+        for (Function* F : Dead)
+        {
+            auto Info = pMdUtils->findFunctionsInfoItem(F);
+            if (Info != pMdUtils->end_FunctionsInfo())
+                pMdUtils->eraseFunctionsInfoItem(Info);
+            if (modMD)
+                modMD->FuncMD.erase(F);
+            GlobalNumbers.erase(F);
+            F->eraseFromParent();
+        }
+        LocalChanged = !Dead.empty();
+        Changed |= LocalChanged;
+    }
+
+    if (Changed)
+        pMdUtils->save(M.getContext());
+    return Changed;
+}
@@ -0,0 +1,54 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#pragma once
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/Pass.h"
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC {
+
+    /// \brief Merge structurally identical subroutines.
+    ///
+    /// Template-heavy sources often produce helper functions that differ only
+    /// in their names. Each copy would otherwise be cloned into every function
+    /// group that calls it by GenXCodeGenModule and compiled separately. This
+    /// pass buckets the directly-called subroutines by structural hash, keeps
+    /// the first function of each equivalence class and redirects the calls
+    /// of the others to it. Kernels are never merged.
+    class DeduplicateFunctions : public llvm::ModulePass {
+    public:
+        static char ID;
+
+        DeduplicateFunctions();
+        virtual llvm::StringRef getPassName() const override { return "Deduplicate Functions"; }
+        void getAnalysisUsage(llvm::AnalysisUsage& AU) const override;
+        bool runOnModule(llvm::Module& M) override;
+    };
+
+    llvm::ModulePass* createDeduplicateFunctionsPass();
+
+} // namespace IGC
@@ -369,6 +369,10 @@ bool EmitPass::runOnFunction(llvm::Function& F)
     }
     m_moduleMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
 
+    // Uniformity does not depend on the dispatch width; keep it for the
+    // EmitPass of the other SIMD modes.
+    getAnalysis<WIAnalysis>().saveResults(m_pCtx, F);
+
     CreateKernelShaderMap(m_pCtx, pMdUtils, F);
 
     m_FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
@@ -699,6 +703,17 @@ bool EmitPass::runOnFunction(llvm::Function& F)
             m_currShader->ProgramOutput()->m_scratchSpaceUsedBySpills =
                 MAX(m_currShader->ProgramOutput()->m_scratchSpaceUsedBySpills, 8 * 1024);
         }
+        if (IGC_IS_FLAG_ENABLED(DumpSIMDPredictor) &&
+            m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER)
+        {
+            // Prediction vs outcome, for tuning SIMDPredictorSpillRatio.
+            Simd32ProfitabilityAnalysis& PA = getAnalysis<Simd32ProfitabilityAnalysis>();
+            IGC::Debug::ods() << "SIMD predictor: " << currHead->getName()
+                << " SIMD" << numLanes(m_SimdMode)
+                << " estimated " << PA.getEstimatedGRFs(m_SimdMode)
+                << " of " << m_pCtx->getNumGRFPerThread() << " GRFs"
+                << ", spill size " << m_currShader->m_spillSize << "\n";
+        }
     }
 
     if (destroyVISABuilder)
@@ -8125,7 +8140,6 @@ bool EmitPass::validateInlineAsmConstraints(llvm::CallInst* inst, SmallVector<St
 // Example: "mul (M1, 16) $0(0, 0)<1> $1(0, 0)<1;1,0> $2(0, 0)<1;1,0>", "=r,r,r"(float %6, float %7)
 void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
 {
-    std::stringstream& str = m_encoder->GetVISABuilder()->GetAsmTextStream();
     InlineAsm* IA = cast<InlineAsm>(inst->getCalledValue());
     string asmStr = IA->getAsmString();
     smallvector<CVariable*, 8> opnds;
@@ -8205,7 +8219,6 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         }
     }
 
-    str << endl << "/// Inlined ASM" << endl;
     // Look for variables to replace with the VISA variable
     size_t startPos = 0;
     while (startPos < asmStr.size())
@@ -8237,9 +8250,14 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         startPos = varPos + varName.size();
     }
 
-    str << asmStr;
-    if (asmStr.back() != '\n') str << endl;
-    str << "/// End Inlined ASM" << endl << endl;
+    if (asmStr.back() != '\n') asmStr += '\n';
+
+    // Parse the snippet straight into the kernel being built instead of
+    // round-tripping the whole shader through vISA text.
+    if (m_encoder->GetVISABuilder()->ParseVISAInlineAsm(m_encoder->GetVISAKernel(), asmStr) != 0)
+    {
+        IGC_ASSERT_MESSAGE(0, "Failed to parse inline assembly");
+    }
 }
 
 CVariable* EmitPass::Mul(CVariable* Src0, CVariable* Src1, const CVariable* DstPrototype)
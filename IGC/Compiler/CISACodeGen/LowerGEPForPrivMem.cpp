@@ -172,7 +172,6 @@ bool LowerGEPForPrivMem::runOnFunction(llvm::Function& F)
     m_pDL = &F.getParent()->getDataLayout();
     m_pRegisterPressureEstimate = &getAnalysis<RegisterPressureEstimate>();
     IGC_ASSERT(nullptr != m_pRegisterPressureEstimate);
-    m_pRegisterPressureEstimate->buildRPMapPerInstruction();
     m_allocasToPrivMem.clear();
 
     visit(F);
@@ -307,12 +306,8 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
 
     uint32_t maxGRFPressure = (uint32_t)(grfRatio * MAX_PRESSURE_GRF_NUM * 4);
 
-    unsigned int pressure = 0;
-    for (unsigned int i = lowestAssignedNumber; i <= highestAssignedNumber; i++)
-    {
-        pressure = std::max(
-            pressure, m_pRegisterPressureEstimate->getRegisterPressureForInstructionFromRPMap(i));
-    }
+    unsigned int pressure = m_pRegisterPressureEstimate->getMaxRegisterPressureFromRPMap(
+        lowestAssignedNumber, highestAssignedNumber);
 
     for (auto it : m_promotedLiveranges)
     {
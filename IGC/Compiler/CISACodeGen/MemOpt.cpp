@@ -61,7 +61,9 @@ DEBUG_COUNTER(MergeStoreCounter, "memopt-merge-store",
     "Controls count of merged stores");
 
 namespace {
-    // This pass merge consecutive loads/stores within a BB when it's safe:
+    // This pass merge consecutive loads/stores within a straight-line region,
+    // i.e. a chain of BBs where each one is the only successor of the previous
+    // one and has it as its only predecessor, when it's safe:
     // - Two loads (one of them is denoted as the leading load if it happens
     //   before the other one in the program order) are safe to be merged, i.e.
     //   the non-leading load is merged into the leading load, iff there's no
@@ -89,11 +91,16 @@ namespace {
         typedef DenseMap<unsigned int, SmallVector<unsigned, 4> > ProfitVectorLengthsMap;
         ProfitVectorLengthsMap ProfitVectorLengths;
 
-        // A list of memory references (within a BB) with the distance to a
-        // previous memory reference in this list.
+        // A list of memory references (within a straight-line region) with the
+        // distance to a previous memory reference in this list.
         typedef std::vector<std::pair<Instruction*, unsigned> > MemRefListTy;
         typedef std::vector<Instruction*> TrivialMemRefListTy;
 
+        // Positions in a MemRefListTy of the loads or stores (by opcode) sharing
+        // the same base pointer, in the ascending order.
+        typedef DenseMap<std::pair<const void*, unsigned>, SmallVector<unsigned, 8> >
+            MemRefIndexTy;
+
     public:
         static char ID;
 
@@ -118,6 +125,26 @@ namespace {
 
         void buildProfitVectorLengths(Function& F);
 
+        BasicBlock* getRegionSuccessor(BasicBlock* BB) const {
+            BasicBlock* Succ = BB->getSingleSuccessor();
+            if (Succ && Succ != BB && Succ->getSinglePredecessor() == BB)
+                return Succ;
+            return nullptr;
+        }
+
+        bool isRegionContinuation(BasicBlock* BB) const {
+            BasicBlock* Pred = BB->getSinglePredecessor();
+            return Pred && getRegionSuccessor(Pred) == BB;
+        }
+
+        bool optimizeRegion(BasicBlock* Head, SmallPtrSetImpl<BasicBlock*>& Visited);
+
+        void buildMemRefIndex(const MemRefListTy& MemRefs, MemRefIndexTy& Index,
+            SmallVectorImpl<std::pair<const void*, const void*> >& Bases) const;
+        bool hasMergeCandidate(unsigned Pos, unsigned Opcode,
+            const MemRefIndexTy& Index,
+            const SmallVectorImpl<std::pair<const void*, const void*> >& Bases) const;
+
         bool mergeLoad(LoadInst* LeadingLoad, MemRefListTy::iterator MI,
             MemRefListTy& MemRefs, TrivialMemRefListTy& ToOpt);
         bool mergeStore(StoreInst* LeadingStore, MemRefListTy::iterator MI,
@@ -421,13 +448,39 @@ bool MemOpt::runOnFunction(Function& F) {
 
     bool Changed = false;
 
-    for (Function::iterator BB = F.begin(), BBE = F.end(); BB != BBE; ++BB) {
-        // Find all instructions with memory reference. Remember the distance one
-        // by one.
-        MemRefListTy MemRefs;
-        TrivialMemRefListTy MemRefsToOptimize;
-        unsigned Distance = 0;
-        bool FirstMemRef = true;
+    SmallPtrSet<BasicBlock*, 32> Visited;
+    for (auto& BB : F) {
+        // Blocks continuing a straight-line region are handled with its head.
+        if (Visited.count(&BB) || isRegionContinuation(&BB))
+            continue;
+        Changed |= optimizeRegion(&BB, Visited);
+    }
+    // Straight-line chains forming an (unreachable) cycle have no head.
+    for (auto& BB : F) {
+        if (!Visited.count(&BB))
+            Changed |= optimizeRegion(&BB, Visited);
+    }
+
+    DL = nullptr;
+    AA = nullptr;
+    SE = nullptr;
+
+    return Changed;
+}
+
+bool MemOpt::optimizeRegion(BasicBlock* Head,
+    SmallPtrSetImpl<BasicBlock*>& Visited) {
+    bool Changed = false;
+
+    // Find all instructions with memory reference. Remember the distance one
+    // by one. As each block of the region is always entered from the previous
+    // one, they are scanned as if they were a single BB.
+    MemRefListTy MemRefs;
+    TrivialMemRefListTy MemRefsToOptimize;
+    unsigned Distance = 0;
+    bool FirstMemRef = true;
+    for (BasicBlock* BB = Head; BB && Visited.insert(BB).second;
+        BB = getRegionSuccessor(BB)) {
         for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI) {
             Instruction* I = &(*BI);
             Distance += FirstMemRef ? 0 : 1;
@@ -438,42 +491,102 @@ bool MemOpt::runOnFunction(Function& F) {
             Distance = 0;
             FirstMemRef = false;
         }
+    }
 
-        // Skip BB with no more than 2 loads/stores.
-        if (MemRefs.size() < 2)
-            continue;
+    // Skip region with no more than 2 loads/stores.
+    if (MemRefs.size() < 2)
+        return Changed;
 
-        // Canonicalize 64-bit GEP to help SCEV find constant offset by
-        // distributing `zext`/`sext` over safe expressions.
-        for (auto& M : MemRefs)
-            Changed |= canonicalizeGEP64(M.first);
+    // Canonicalize 64-bit GEP to help SCEV find constant offset by
+    // distributing `zext`/`sext` over safe expressions.
+    for (auto& M : MemRefs)
+        Changed |= canonicalizeGEP64(M.first);
 
-        for (auto MI = MemRefs.begin(), ME = MemRefs.end(); MI != ME; ++MI) {
-            Instruction* I = MI->first;
+    MemRefIndexTy Index;
+    SmallVector<std::pair<const void*, const void*>, 32> Bases;
+    buildMemRefIndex(MemRefs, Index, Bases);
 
-            // Skip already merged one.
-            if (!I)
-                continue;
+    for (auto MI = MemRefs.begin(), ME = MemRefs.end(); MI != ME; ++MI) {
+        Instruction* I = MI->first;
 
-            if (LoadInst * LI = dyn_cast<LoadInst>(I))
-                Changed |= mergeLoad(LI, MI, MemRefs, MemRefsToOptimize);
-            else if (StoreInst * SI = dyn_cast<StoreInst>(I))
-                Changed |= mergeStore(SI, MI, MemRefs, MemRefsToOptimize);
+        // Skip already merged one.
+        if (!I)
+            continue;
+
+        // Nothing to merge with if no later access shares its base pointer.
+        unsigned Pos = unsigned(MI - MemRefs.begin());
+        if ((isa<LoadInst>(I) || isa<StoreInst>(I)) &&
+            !hasMergeCandidate(Pos, I->getOpcode(), Index, Bases)) {
+            MemRefsToOptimize.push_back(I);
+            continue;
         }
 
-        // Optimize 64-bit GEP to reduce strength by factoring out `zext`/`sext`
-        // over safe expressions.
-        for (auto I : MemRefsToOptimize)
-            Changed |= optimizeGEP64(I);
+        if (LoadInst * LI = dyn_cast<LoadInst>(I))
+            Changed |= mergeLoad(LI, MI, MemRefs, MemRefsToOptimize);
+        else if (StoreInst * SI = dyn_cast<StoreInst>(I))
+            Changed |= mergeStore(SI, MI, MemRefs, MemRefsToOptimize);
     }
 
-    DL = nullptr;
-    AA = nullptr;
-    SE = nullptr;
+    // Optimize 64-bit GEP to reduce strength by factoring out `zext`/`sext`
+    // over safe expressions.
+    for (auto I : MemRefsToOptimize)
+        Changed |= optimizeGEP64(I);
 
     return Changed;
 }
 
+/// buildMemRefIndex() - index loads and stores by the base pointer found by
+/// SCEV and by the symbolic pointer decomposition. A constant distance, which
+/// merging requires, only exists between accesses sharing one of them.
+void MemOpt::buildMemRefIndex(const MemRefListTy& MemRefs, MemRefIndexTy& Index,
+    SmallVectorImpl<std::pair<const void*, const void*> >& Bases) const {
+    // Distinct null base pointers are treated as the same base.
+    static const char NullBase = 0;
+
+    Bases.assign(MemRefs.size(), std::make_pair(nullptr, nullptr));
+    for (unsigned i = 0, e = unsigned(MemRefs.size()); i != e; ++i) {
+        Instruction* I = MemRefs[i].first;
+        Value* Ptr = nullptr;
+        if (LoadInst * LI = dyn_cast<LoadInst>(I))
+            Ptr = LI->getPointerOperand();
+        else if (StoreInst * SI = dyn_cast<StoreInst>(I))
+            Ptr = SI->getPointerOperand();
+        if (!Ptr)
+            continue;
+
+        const SCEV* PtrSCEV = SE->getSCEV(Ptr);
+        if (!isa<SCEVCouldNotCompute>(PtrSCEV)) {
+            Bases[i].first = SE->getPointerBase(PtrSCEV);
+            Index[std::make_pair(Bases[i].first, I->getOpcode())].push_back(i);
+        }
+
+        SymbolicPointer SymPtr;
+        if (!SymbolicPointer::decomposePointer(Ptr, SymPtr, CGC) && SymPtr.BasePtr) {
+            Bases[i].second = isa<ConstantPointerNull>(SymPtr.BasePtr) ?
+                static_cast<const void*>(&NullBase) : SymPtr.BasePtr;
+            if (Bases[i].second != Bases[i].first)
+                Index[std::make_pair(Bases[i].second, I->getOpcode())].push_back(i);
+        }
+    }
+}
+
+bool MemOpt::hasMergeCandidate(unsigned Pos, unsigned Opcode,
+    const MemRefIndexTy& Index,
+    const SmallVectorImpl<std::pair<const void*, const void*> >& Bases) const {
+    for (const void* Base : { Bases[Pos].first, Bases[Pos].second }) {
+        if (!Base)
+            continue;
+        auto II = Index.find(std::make_pair(Base, Opcode));
+        if (II == Index.end())
+            continue;
+        const SmallVectorImpl<unsigned>& Positions = II->second;
+        if (std::upper_bound(Positions.begin(), Positions.end(), Pos) !=
+            Positions.end())
+            return true;
+    }
+    return false;
+}
+
 bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
     MemRefListTy::iterator MI, MemRefListTy& MemRefs,
     TrivialMemRefListTy& ToOpt) {
@@ -558,6 +671,11 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
     // List of instructions need dependency check.
     SmallVector<Instruction*, 8> CheckList;
 
+    // The leading pointer is decomposed once, on the first candidate needing it.
+    SymbolicPointer LeadingSymPtr;
+    bool LeadingSymPtrDecomposed = false;
+    bool LeadingSymPtrFailed = false;
+
     unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
     auto ME = MemRefs.end();
     for (++MI; Limit != 0 && MI != ME; Limit -= MI->second, ++MI) {
@@ -609,10 +727,13 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
         // Skip load with non-constant distance.
         if (!Offset) {
 
-            SymbolicPointer LeadingSymPtr;
+            if (!LeadingSymPtrDecomposed) {
+                LeadingSymPtrDecomposed = true;
+                LeadingSymPtrFailed = SymbolicPointer::decomposePointer(
+                    LeadingLoad->getPointerOperand(), LeadingSymPtr, CGC);
+            }
             SymbolicPointer NextSymPtr;
-            if (SymbolicPointer::decomposePointer(LeadingLoad->getPointerOperand(),
-                LeadingSymPtr, CGC) ||
+            if (LeadingSymPtrFailed ||
                 SymbolicPointer::decomposePointer(NextLoad->getPointerOperand(),
                     NextSymPtr, CGC) ||
                 NextSymPtr.getConstantOffset(LeadingSymPtr, Off)) {
@@ -898,6 +1019,11 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
     // List of instructions need dependency check.
     SmallVector<Instruction*, 8> CheckList;
 
+    // The leading pointer is decomposed once, on the first candidate needing it.
+    SymbolicPointer LeadingSymPtr;
+    bool LeadingSymPtrDecomposed = false;
+    bool LeadingSymPtrFailed = false;
+
     unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
     auto ME = MemRefs.end();
     for (++MI; Limit != 0 && MI != ME; Limit -= MI->second, ++MI) {
@@ -949,10 +1075,13 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
         // Skip store with non-constant distance.
         if (!Offset) {
 
-            SymbolicPointer LeadingSymPtr;
+            if (!LeadingSymPtrDecomposed) {
+                LeadingSymPtrDecomposed = true;
+                LeadingSymPtrFailed = SymbolicPointer::decomposePointer(
+                    LeadingStore->getPointerOperand(), LeadingSymPtr, CGC);
+            }
             SymbolicPointer NextSymPtr;
-            if (SymbolicPointer::decomposePointer(
-                LeadingStore->getPointerOperand(), LeadingSymPtr, CGC) ||
+            if (LeadingSymPtrFailed ||
                 SymbolicPointer::decomposePointer(NextStore->getPointerOperand(),
                     NextSymPtr, CGC) ||
                 NextSymPtr.getConstantOffset(LeadingSymPtr, Off))
@@ -223,8 +223,6 @@ bool MemOpt2::runOnFunction(Function& F) {
     if (!RPE->isAvailable())
         return false;
 
-    RPE->buildRPMapPerInstruction();
-
     bool Changed = false;
     for (auto& BB : F) {
         bool LocalChanged = false;
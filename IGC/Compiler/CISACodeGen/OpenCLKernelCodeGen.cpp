@@ -2409,6 +2409,21 @@ namespace IGC
                 {
                     return SIMDStatus::SIMD_PERF_FAIL;
                 }
+
+                // SIMD32 is optional here, so it is the first width to go when
+                // the compile-time budget is at risk.
+                if (pCtx->DegradeForCompileTime(COMPILE_TIME_DEGRADE_SIMD32))
+                {
+                    return SIMDStatus::SIMD_PERF_FAIL;
+                }
+            }
+
+            // A width that may abort on spill and is expected to spill heavily
+            // would only be finalized to be thrown away, so skip it up front.
+            if (EP.m_canAbortOnSpill &&
+                EP.getAnalysis<Simd32ProfitabilityAnalysis>().isPredictedToSpill(simdMode))
+            {
+                return SIMDStatus::SIMD_PERF_FAIL;
             }
         }
 
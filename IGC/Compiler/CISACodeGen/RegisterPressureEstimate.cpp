@@ -463,37 +463,60 @@ namespace IGC
 
     unsigned RegisterPressureEstimate::getRegisterPressureForInstructionFromRPMap(unsigned number) const
     {
-        auto Iter = m_pRegisterPressureByInstruction.find(number);
-        if (Iter != m_pRegisterPressureByInstruction.end())
+        buildRPMapPerInstruction();
+        if (number < m_pRegisterPressureByInstruction.size())
         {
-            return Iter->second;
+            return m_pRegisterPressureByInstruction[number];
         }
-        else
+        return 0;
+    }
+
+    unsigned RegisterPressureEstimate::getMaxRegisterPressureFromRPMap(unsigned Begin, unsigned End) const
+    {
+        buildRPMapPerInstruction();
+        unsigned Pressure = 0;
+        End = std::min(End + 1, (unsigned)m_pRegisterPressureByInstruction.size());
+        for (unsigned number = Begin; number < End; number++)
         {
-            return 0;
+            Pressure = std::max(Pressure, m_pRegisterPressureByInstruction[number]);
         }
+        return Pressure;
     }
 
-    void RegisterPressureEstimate::buildRPMapPerInstruction()
+    /// Each segment adds its value's size at Begin and removes it at End, so a
+    /// single prefix sum over the numbering gives the pressure everywhere.
+    void RegisterPressureEstimate::buildRPMapPerInstruction() const
     {
-        unsigned maxNumberOfInstructions = getMaxAssignedNumberForFunction();
-        for (unsigned number = 0; number < maxNumberOfInstructions; number++)
+        if (!m_pRegisterPressureByInstruction.empty())
+        {
+            return;
+        }
+
+        unsigned MaxNumber = 0;
+        for (auto& Item : m_pNumbers)
         {
-            m_pRegisterPressureByInstruction[number] = 0;
+            MaxNumber = std::max(MaxNumber, Item.second);
         }
 
-        // Segments are sorted.
+        // Segments end at most one past the last number.
+        std::vector<int> Delta(MaxNumber + 2, 0);
         for (auto I = m_pLiveRanges.begin(), E = m_pLiveRanges.end(); I != E; ++I)
         {
+            int Size = (int)(I->first->getType()->getPrimitiveSizeInBits() / 8);
             for (auto& Seg : I->second->Segments)
             {
-                for (unsigned number = Seg.Begin; number < Seg.End; number++)
-                {
-                    Value* V = I->first;
-                    m_pRegisterPressureByInstruction[number] = m_pRegisterPressureByInstruction[number] + (unsigned int)V->getType()->getPrimitiveSizeInBits() / 8;
-                }
+                Delta[Seg.Begin] += Size;
+                Delta[Seg.End] -= Size;
             }
         }
+
+        m_pRegisterPressureByInstruction.resize(MaxNumber + 1);
+        int Pressure = 0;
+        for (unsigned number = 0; number <= MaxNumber; number++)
+        {
+            Pressure += Delta[number];
+            m_pRegisterPressureByInstruction[number] = (unsigned)Pressure;
+        }
     }
 
     unsigned RegisterPressureEstimate::getRegisterPressure(Instruction* Inst) const
@@ -501,23 +524,7 @@ namespace IGC
         auto Iter = m_pNumbers.find(Inst);
         if (Iter != m_pNumbers.end())
         {
-            // Find the instruction location.
-            unsigned N = Iter->second;
-
-            // Now sum all intervals that contain this location.
-            unsigned Presssure = 0;
-
-            // Segments are sorted.
-            for (auto I = m_pLiveRanges.begin(), E = m_pLiveRanges.end(); I != E; ++I)
-            {
-                if (I->second->contains(N))
-                {
-                    Value* V = I->first;
-                    Presssure += (unsigned int)V->getType()->getPrimitiveSizeInBits() / 8;
-                }
-            }
-
-            return Presssure;
+            return getRegisterPressureForInstructionFromRPMap(Iter->second);
         }
 
         // ignore this instruction.
@@ -526,15 +533,11 @@ namespace IGC
 
     unsigned RegisterPressureEstimate::getRegisterPressure() const
     {
-        // TODO: Make this more efficient.
+        buildRPMapPerInstruction();
         unsigned MaxPressure = 0;
-        for (auto BI = m_pFunc->begin(), BE = m_pFunc->end(); BI != BE; ++BI)
+        for (unsigned Pressure : m_pRegisterPressureByInstruction)
         {
-            for (auto II = BI->begin(), IE = BI->end(); II != IE; ++II)
-            {
-                Instruction* Inst = &(*II);
-                MaxPressure = std::max(MaxPressure, getRegisterPressure(Inst));
-            }
+            MaxPressure = std::max(MaxPressure, Pressure);
         }
 
         return MaxPressure;
@@ -207,11 +207,17 @@ namespace IGC
             for (auto Item : m_pLiveRangePool)
                 delete Item;
             m_pLiveRangePool.clear();
+            m_pRegisterPressureByInstruction.clear();
         }
 
         unsigned getRegisterPressureForInstructionFromRPMap(unsigned number) const;
 
-        void buildRPMapPerInstruction();
+        /// \brief Return the max register pressure over numbers [Begin, End].
+        unsigned getMaxRegisterPressureFromRPMap(unsigned Begin, unsigned End) const;
+
+        /// \brief Compute the register pressure at every number once. The map
+        /// stays valid until live intervals are rebuilt or cleared.
+        void buildRPMapPerInstruction() const;
 
     private:
         /// \brief Return the register pressure at location specified by Inst.
@@ -242,6 +248,7 @@ namespace IGC
 
         std::vector<LiveRange*> m_pLiveRangePool;
 
-        llvm::DenseMap<unsigned, unsigned> m_pRegisterPressureByInstruction;
+        /// Live bytes at each number, built lazily from the live ranges.
+        mutable std::vector<unsigned> m_pRegisterPressureByInstruction;
     };
 } // namespace IGC
@@ -47,6 +47,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/ConstantCoalescing.hpp"
 #include "Compiler/CISACodeGen/CheckInstrTypes.hpp"
 #include "Compiler/CISACodeGen/EstimateFunctionSize.h"
+#include "Compiler/CISACodeGen/DeduplicateFunctions.h"
 #include "Compiler/CISACodeGen/PassTimer.hpp"
 #include "Compiler/CISACodeGen/FixAddrSpaceCast.h"
 #include "Compiler/CISACodeGen/FixupExtractValuePair.h"
@@ -245,7 +246,8 @@ namespace IGC
         if (IGC_IS_FLAG_DISABLED(DisablePreRAScheduler) &&
             ctx.type == ShaderType::PIXEL_SHADER &&
             ctx.m_retryManager.AllowPreRAScheduler() &&
-            !ctx.m_enableSubroutine)
+            !ctx.m_enableSubroutine &&
+            !ctx.DegradeForCompileTime(COMPILE_TIME_DEGRADE_PRE_RA_SCHED))
         {
             mpm.add(createPreRASchedulerPass());
         }
@@ -382,7 +384,8 @@ namespace IGC
 
             mpm.add(createBarrierNoopPass());
 
-            if (ctx.m_retryManager.AllowLICM() && IGC_IS_FLAG_ENABLED(allowLICM))
+            if (ctx.m_retryManager.AllowLICM() && IGC_IS_FLAG_ENABLED(allowLICM) &&
+                !ctx.DegradeForCompileTime(COMPILE_TIME_DEGRADE_LOOP_OPTS))
             {
                 mpm.add(llvm::createLICMPass());
             }
@@ -491,6 +494,12 @@ namespace IGC
         if  (ctx.enableFunctionCall()
             )
         {
+            // Fold identical subroutines before they get cloned into every
+            // function group that calls them.
+            if (!isOptDisabled && IGC_IS_FLAG_ENABLED(EnableFunctionDeduplication))
+            {
+                mpm.add(createDeduplicateFunctionsPass());
+            }
             // Sort functions if subroutine/indirect fcall is enabled.
             mpm.add(llvm::createGlobalDCEPass());
             mpm.add(new PurgeMetaDataUtils());
@@ -579,7 +588,8 @@ namespace IGC
             {
                 mpm.add(createEarlyCSEPass());
             }
-            if (!fastCompile && IGC_IS_FLAG_ENABLED(allowLICM) && ctx.m_retryManager.AllowLICM())
+            if (!fastCompile && IGC_IS_FLAG_ENABLED(allowLICM) && ctx.m_retryManager.AllowLICM() &&
+                !ctx.DegradeForCompileTime(COMPILE_TIME_DEGRADE_LOOP_OPTS))
             {
                 mpm.add(createLICMPass());
             }
@@ -947,7 +957,8 @@ namespace IGC
                     ctx->m_tempCount <= tempThreshold16;
 
                 bool cgSimd32 = maxSimdMode == SIMDMode::SIMD32 &&
-                    ctx->m_tempCount <= tempThreshold16;
+                    ctx->m_tempCount <= tempThreshold16 &&
+                    !ctx->DegradeForCompileTime(COMPILE_TIME_DEGRADE_SIMD32);
 
                 if (ctx->m_enableSubroutine || !cgSimd16)
                 {
@@ -976,7 +987,8 @@ namespace IGC
             {
                 AddCodeGenPasses(*ctx, shaders, PassMgr, SIMDMode::SIMD16,
                     !ctx->m_retryManager.IsLastTry());
-                if (!ctx->m_enableSubroutine && maxSimdMode == SIMDMode::SIMD32)
+                if (!ctx->m_enableSubroutine && maxSimdMode == SIMDMode::SIMD32 &&
+                    !ctx->DegradeForCompileTime(COMPILE_TIME_DEGRADE_SIMD32))
                 {
                     AddCodeGenPasses(*ctx, shaders, PassMgr, SIMDMode::SIMD32, true);
                 }
@@ -1053,6 +1065,10 @@ namespace IGC
             // function compilations.
             // Only SIMD16 and SIMD8 are supported.
 
+            // The IR does not change between the two pass managers, so the
+            // width-invariant analyses of the SIMD8 run are reused for SIMD16.
+            ctx->m_widthInvariantCache.enabled = true;
+
             // Run first pass for SIMD8
             AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD8, false);
             COMPILER_TIME_END(ctx, TIME_CG_Add_Passes);
@@ -1066,6 +1082,7 @@ namespace IGC
             Passes2.add(createGenXFunctionGroupAnalysisPass());
             AddCodeGenPasses(*ctx, kernels, Passes2, SIMDMode::SIMD16, false);
             Passes2.run(*(ctx->getModule()));
+            ctx->m_widthInvariantCache.clear();
 
             COMPILER_TIME_END(ctx, TIME_CodeGen);
             DumpLLVMIR(ctx, "codegen");
@@ -1156,7 +1173,8 @@ namespace IGC
             CShaderProgram* shaderProgram = kv.second;
             FillProgram(ctx, shaderProgram);
         }
-
+        ctx->programOutput.m_compileTimeDegradations =
+            ctx->m_retryManager.GetCompileTimeDegradations();
 
         destroyShaderMap(shaders);
     }
@@ -1188,6 +1206,8 @@ namespace IGC
 
         PSCodeGen(ctx, shaders, pSignature);
 
+        ctx->programOutput.m_compileTimeDegradations =
+            ctx->m_retryManager.GetCompileTimeDegradations();
     } // CodeGen(PixelShaderContext*, ...)
 
     void CodeGen(OpenCLProgramContext* ctx, CShaderProgram::KernelShaderMap& shaders)
@@ -1428,6 +1448,11 @@ namespace IGC
 
             if (pContext->m_instrTypes.hasMultipleBB)
             {
+                // Drop LICM and GVN first when the compile-time budget is at risk.
+                bool skipLoopOpts = pContext->DegradeForCompileTime(COMPILE_TIME_DEGRADE_LOOP_OPTS);
+                bool enableLICM = pContext->m_retryManager.AllowLICM() &&
+                    IGC_IS_FLAG_ENABLED(allowLICM) && !skipLoopOpts;
+
                 // disable loop unroll for excessive large shaders
                 if (pContext->m_instrTypes.hasLoop)
                 {
@@ -1439,7 +1464,7 @@ namespace IGC
                     mpm.add(llvm::createLCSSAPass());
                     mpm.add(llvm::createLoopSimplifyPass());
 
-                    if (pContext->m_retryManager.AllowLICM() && IGC_IS_FLAG_ENABLED(allowLICM))
+                    if (enableLICM)
                     {
                         mpm.add(llvm::createLICMPass());
                         mpm.add(llvm::createLICMPass());
@@ -1484,7 +1509,7 @@ namespace IGC
                     // LoopUnroll and LICM.
                     mpm.add(createBarrierNoopPass());
 
-                    if (pContext->m_retryManager.AllowLICM() && IGC_IS_FLAG_ENABLED(allowLICM))
+                    if (enableLICM)
                     {
                         mpm.add(llvm::createLICMPass());
                     }
@@ -1521,7 +1546,7 @@ namespace IGC
                     mpm.add(createReassociatePass());
                 }
 
-                if (IGC_IS_FLAG_ENABLED(EnableGVN))
+                if (IGC_IS_FLAG_ENABLED(EnableGVN) && !skipLoopOpts)
                 {
                     mpm.add(llvm::createGVNPass());
                 }
@@ -339,6 +339,8 @@ namespace IGC
 
         /// Initialize per function status.
         void BeginFunction(llvm::Function* F);
+        /// Size the per-function symbol tables for every value of F up front.
+        void ReserveSymbolTables(llvm::Function* F);
         /// This method is used to create the vISA variable for function F's formal return value
         CVariable* getOrCreateReturnSymbol(llvm::Function* F);
         /// This method is used to create the vISA variable for function F's formal argument
@@ -497,7 +499,9 @@ namespace IGC
         uint m_numBlocks;
         IGC::IGCMD::MetaDataUtils* m_pMdUtils;
 
-        llvm::BumpPtrAllocator Allocator;
+        // CVariables live until the shader is destroyed, and a kernel creates
+        // one per value, so use larger slabs than the default 4KB.
+        llvm::BumpPtrAllocatorImpl<llvm::MallocAllocator, 64 * 1024> Allocator;
 
         // Mapping from formal argument to its variable or from function to its
         // return variable. Per kernel mapping. Used when llvm functions are
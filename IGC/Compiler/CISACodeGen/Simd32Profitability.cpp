@@ -50,6 +50,7 @@ IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
 IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterPressureEstimate)
 IGC_INITIALIZE_PASS_END(Simd32ProfitabilityAnalysis, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char Simd32ProfitabilityAnalysis::ID = 0;
@@ -59,7 +60,8 @@ const unsigned BRANCHY_MINPATH = 8;
 Simd32ProfitabilityAnalysis::Simd32ProfitabilityAnalysis()
     : FunctionPass(ID), F(nullptr), PDT(nullptr), LI(nullptr),
     pMdUtils(nullptr), WI(nullptr), m_isSimd32Profitable(true),
-    m_isSimd16Profitable(true) {
+    m_isSimd16Profitable(true), m_estimatedGRFs16(0), m_estimatedGRFs32(0),
+    m_numGRF(0) {
     initializeSimd32ProfitabilityAnalysisPass(*PassRegistry::getPassRegistry());
 }
 
@@ -567,6 +569,7 @@ bool Simd32ProfitabilityAnalysis::runOnFunction(Function& F)
         pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
         m_isSimd16Profitable = checkSimd16Profitable(context);
         m_isSimd32Profitable = m_isSimd16Profitable && checkSimd32Profitable(context);
+        estimateLiveGRFs(context);
     }
     else if (context->type == ShaderType::PIXEL_SHADER)
     {
@@ -576,6 +579,73 @@ bool Simd32ProfitabilityAnalysis::runOnFunction(Function& F)
     return false;
 }
 
+/// Rough GRF pressure of F at SIMD16 and SIMD32, taken from the per-lane
+/// byte pressure RegisterPressureEstimate computes. Every value is counted
+/// once per lane, uniform ones included, so the estimate errs on the side of
+/// predicting a spill; it only has to tell whether a width is hopeless before
+/// the finalizer is run.
+void Simd32ProfitabilityAnalysis::estimateLiveGRFs(CodeGenContext* ctx)
+{
+    m_estimatedGRFs16 = m_estimatedGRFs32 = 0;
+    m_numGRF = ctx->getNumGRFPerThread();
+    if (IGC_GET_FLAG_VALUE(SIMDPredictorSpillRatio) == 0 &&
+        IGC_IS_FLAG_DISABLED(DumpSIMDPredictor))
+    {
+        return;
+    }
+
+    RegisterPressureEstimate& RPE = getAnalysis<RegisterPressureEstimate>();
+    if (!RPE.isAvailable())
+    {
+        return;
+    }
+    RPE.buildRPMapPerInstruction();
+    unsigned laneBytes = RPE.getMaxRegisterPressureFromRPMap(0, RPE.getMaxAssignedNumberForFunction());
+
+    unsigned grfSize = ctx->platform.getGRFSize();
+    m_estimatedGRFs16 = (laneBytes * 16 + grfSize - 1) / grfSize;
+    m_estimatedGRFs32 = (laneBytes * 32 + grfSize - 1) / grfSize;
+}
+
+unsigned Simd32ProfitabilityAnalysis::getEstimatedGRFs(SIMDMode simdMode) const
+{
+    switch (simdMode)
+    {
+    case SIMDMode::SIMD16:
+        return m_estimatedGRFs16;
+    case SIMDMode::SIMD32:
+        return m_estimatedGRFs32;
+    default:
+        return 0;
+    }
+}
+
+bool Simd32ProfitabilityAnalysis::isPredictedToSpill(SIMDMode simdMode) const
+{
+    unsigned ratio = IGC_GET_FLAG_VALUE(SIMDPredictorSpillRatio);
+    unsigned estimate = getEstimatedGRFs(simdMode);
+    return ratio != 0 && estimate != 0 && estimate * 100 > m_numGRF * ratio;
+}
+
+void Simd32ProfitabilityAnalysis::print(raw_ostream& OS, const Module*) const
+{
+    for (SIMDMode simdMode : { SIMDMode::SIMD16, SIMDMode::SIMD32 })
+    {
+        OS << "SIMD" << numLanes(simdMode) << ": ";
+        if (getEstimatedGRFs(simdMode) == 0)
+        {
+            OS << "not estimated\n";
+            continue;
+        }
+        OS << getEstimatedGRFs(simdMode) << " of " << m_numGRF << " GRFs";
+        if (isPredictedToSpill(simdMode))
+        {
+            OS << ", predicted to spill";
+        }
+        OS << "\n";
+    }
+}
+
 static bool isPayloadHeader(Value* V) {
     Argument* Arg = dyn_cast<Argument>(V);
     if (!Arg || !Arg->hasName())
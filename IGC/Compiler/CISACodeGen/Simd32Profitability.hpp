@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CISACodeGen/RegisterPressureEstimate.hpp"
 
 namespace IGC
 {
@@ -64,11 +65,25 @@ namespace IGC
             AU.addRequired<llvm::PostDominatorTreeWrapperPass>();
             AU.addRequired<MetaDataUtilsWrapper>();
             AU.addRequired<CodeGenContextWrapper>();
+            // Live ranges are only needed by the spill predictor.
+            if (IGC_GET_FLAG_VALUE(SIMDPredictorSpillRatio) != 0 ||
+                IGC_IS_FLAG_ENABLED(DumpSIMDPredictor))
+            {
+                AU.addRequired<RegisterPressureEstimate>();
+            }
         }
 
+        virtual void print(llvm::raw_ostream& OS, const llvm::Module*) const override;
+
         bool isSimd32Profitable() const { return m_isSimd32Profitable; }
         bool isSimd16Profitable() const { return m_isSimd16Profitable; }
 
+        /// Estimated number of GRFs needed at simdMode, 0 if not estimated.
+        unsigned getEstimatedGRFs(SIMDMode simdMode) const;
+        /// Return true if simdMode is expected to spill so much that a compile
+        /// allowed to abort on spill would be thrown away.
+        bool isPredictedToSpill(SIMDMode simdMode) const;
+
     private:
         llvm::Function* F;
         llvm::PostDominatorTree* PDT;
@@ -77,10 +92,14 @@ namespace IGC
         WIAnalysis* WI;
         bool m_isSimd32Profitable;
         bool m_isSimd16Profitable;
+        unsigned m_estimatedGRFs16;
+        unsigned m_estimatedGRFs32;
+        unsigned m_numGRF;
 
         unsigned getLoopCyclomaticComplexity();
         bool checkSimd32Profitable(CodeGenContext*);
         bool checkSimd16Profitable(CodeGenContext*);
+        void estimateLiveGRFs(CodeGenContext*);
 
         unsigned estimateLoopCount(llvm::Loop* L);
         unsigned estimateLoopCount_CASE1(llvm::Loop* L);
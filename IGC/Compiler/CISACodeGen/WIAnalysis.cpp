@@ -36,11 +36,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPush.hpp"
 #include <llvmWrapper/IR/Function.h>
 #include <llvm/IR/CFG.h>
+#include <llvm/ADT/PostOrderIterator.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/Debug.h>
 #include <llvm/IR/Constants.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
+#include <algorithm>
+#include <climits>
 #include <string>
 #include <stack>
 #include <sstream>
@@ -145,24 +148,6 @@ gep_conversion[WIAnalysis::NumDeps][WIAnalysis::NumDeps] = {
     /* RND */  {RND, RND, RND, RND, RND}
 };
 
-namespace IGC {
-    /// @Brief, given a conditional branch and its immediate post dominator,
-    /// find its influence-region and partial joins within the influence region
-    class BranchInfo
-    {
-    public:
-        BranchInfo(const IGCLLVM::TerminatorInst* inst, const llvm::BasicBlock* ipd);
-
-        void print(llvm::raw_ostream& OS) const;
-
-        const IGCLLVM::TerminatorInst* cbr;
-        const llvm::BasicBlock* full_join;
-        llvm::DenseSet<llvm::BasicBlock*> influence_region;
-        llvm::SmallPtrSet<llvm::BasicBlock*, 4> partial_joins;
-        llvm::BasicBlock* fork_blk;
-    };
-} // namespace IGC
-
 void WIAnalysisRunner::print(raw_ostream& OS, const Module*) const
 {
     DenseMap<BasicBlock*, int> BBIDs;
@@ -269,7 +254,9 @@ bool WIAnalysisRunner::run()
     m_changed2.clear();
     m_pChangedNew = &m_changed1;
     m_pChangedOld = &m_changed2;
+    m_inChangedNew.clear();
     m_ctrlBranches.clear();
+    m_branchInfo.clear();
 
     m_backwardList.clear();
     m_storeDepMap.clear();
@@ -279,14 +266,42 @@ bool WIAnalysisRunner::run()
 
     if (!IGC_IS_FLAG_ENABLED(DisableUniformAnalysis))
     {
-        // Compute the  first iteration of the WI-dep according to ordering
-        // instructions this ordering is generally good (as it ususally correlates
-        // well with dominance).
-        inst_iterator it = inst_begin(F);
-        inst_iterator  e = inst_end(F);
-        for (; it != e; ++it)
+        // Visit the blocks in reverse post-order so that, back-edges aside,
+        // operands get their WI-dep before their users. Blocks unreachable from
+        // the entry follow in layout order.
+        std::vector<BasicBlock*> blocks;
+        blocks.reserve(F.size());
+        ReversePostOrderTraversal<Function*> RPOT(&F);
+        blocks.insert(blocks.end(), RPOT.begin(), RPOT.end());
+        if (blocks.size() != F.size())
+        {
+            DenseSet<BasicBlock*> reached(blocks.begin(), blocks.end());
+            for (auto& BB : F)
+            {
+                if (!reached.count(&BB))
+                {
+                    blocks.push_back(&BB);
+                }
+            }
+        }
+
+        m_instOrder.clear();
+        unsigned order = 0;
+        for (auto* BB : blocks)
+        {
+            for (auto& I : *BB)
+            {
+                m_instOrder[&I] = order++;
+            }
+        }
+
+        // Compute the first iteration of the WI-dep.
+        for (auto* BB : blocks)
         {
-            calculate_dep(&*it);
+            for (auto& I : *BB)
+            {
+                calculate_dep(&I);
+            }
         }
 
         // Recursively check if WI-dep changes and if so reclaculates
@@ -313,9 +328,83 @@ bool WIAnalysis::runOnFunction(Function& F)
     auto* pTT = &getAnalysis<TranslationTable>();
 
     Runner.init(&F, PDT, MDUtils, CGCtx, ModMD, pTT);
+
+    // Results saved by an earlier code-gen pass manager are still valid, as
+    // nothing changes the IR between the per-SIMD compilations.
+    auto& Cache = CGCtx->m_widthInvariantCache;
+    auto CI = Cache.WI.find(&F);
+    if (Cache.enabled && CI != Cache.WI.end())
+    {
+        Runner.restoreResults(CI->second);
+        return false;
+    }
     return Runner.run();
 }
 
+void WIAnalysis::saveResults(CodeGenContext* ctx, llvm::Function& F)
+{
+    auto& Cache = ctx->m_widthInvariantCache;
+    if (Cache.enabled && Cache.WI.find(&F) == Cache.WI.end())
+    {
+        Runner.saveResults(Cache.WI[&F]);
+    }
+}
+
+void WIAnalysisRunner::saveResults(WidthInvariantAnalysisCache::WIResult& result)
+{
+    result.deps.clear();
+    result.ctrlBranches.clear();
+
+    auto saveDep = [&](const Value* V) {
+        auto Dep = m_depMap.GetAttributeWithoutCreating(V);
+        if (Dep != m_depMap.end())
+        {
+            result.deps.emplace_back(V, (uint8_t)Dep);
+        }
+    };
+    for (auto& Arg : m_func->args())
+    {
+        saveDep(&Arg);
+    }
+    for (auto& I : instructions(m_func))
+    {
+        saveDep(&I);
+    }
+
+    result.ctrlBranches.reserve(m_ctrlBranches.size());
+    for (auto& CB : m_ctrlBranches)
+    {
+        result.ctrlBranches.emplace_back(CB.first,
+            std::vector<const Instruction*>(CB.second.begin(), CB.second.end()));
+    }
+}
+
+void WIAnalysisRunner::restoreResults(const WidthInvariantAnalysisCache::WIResult& result)
+{
+    m_depMap.Initialize(m_TT);
+    m_TT->RegisterListener(&m_depMap);
+
+    m_changed1.clear();
+    m_changed2.clear();
+    m_pChangedNew = &m_changed1;
+    m_pChangedOld = &m_changed2;
+    m_inChangedNew.clear();
+    m_backwardList.clear();
+    m_storeDepMap.clear();
+    m_allocaDepMap.clear();
+
+    for (auto& D : result.deps)
+    {
+        m_depMap.SetAttribute(D.first, (WIBaseClass::WIDependancy)D.second);
+    }
+
+    m_ctrlBranches.clear();
+    for (auto& CB : result.ctrlBranches)
+    {
+        m_ctrlBranches[CB.first].insert(CB.second.begin(), CB.second.end());
+    }
+}
+
 void WIAnalysisRunner::updateDeps()
 {
     // As lonst as we have values to update
@@ -326,19 +415,35 @@ void WIAnalysisRunner::updateDeps()
         // clear the newChanged set so it will be filled with the users of
         // instruction which their WI-dep canged during the current iteration
         m_pChangedNew->clear();
+        m_inChangedNew.clear();
 
-        // update all changed values
-        std::vector<const Value*>::iterator it = m_pChangedOld->begin();
-        std::vector<const Value*>::iterator e = m_pChangedOld->end();
-        for (; it != e; ++it)
+        // update all changed values in reverse post-order, so that a value
+        // is usually settled before its users within the same iteration
+        std::vector<std::pair<unsigned, const Value*>> changed;
+        changed.reserve(m_pChangedOld->size());
+        for (const Value* V : *m_pChangedOld)
+        {
+            auto OI = m_instOrder.find(V);
+            changed.emplace_back(OI != m_instOrder.end() ? OI->second : UINT_MAX, V);
+        }
+        std::sort(changed.begin(), changed.end());
+
+        for (auto& C : changed)
         {
-            // remove first instruction
             // calculate its new dependencey value
-            calculate_dep(*it);
+            calculate_dep(C.second);
         }
     }
 }
 
+void WIAnalysisRunner::addToChanged(const Value* val)
+{
+    if (m_inChangedNew.insert(val).second)
+    {
+        m_pChangedNew->push_back(val);
+    }
+}
+
 bool WIAnalysisRunner::isInstructionSimple(const Instruction* inst)
 {
     // avoid changing cb load to sampler load, since sampler load
@@ -728,19 +833,26 @@ bool WIAnalysisRunner::isRegionInvariant(const llvm::Instruction* defi, BranchIn
 
 void WIAnalysisRunner::update_cf_dep(const IGCLLVM::TerminatorInst* inst)
 {
-    BasicBlock* blk = (BasicBlock*)(inst->getParent());
-    BasicBlock* ipd = PDT->getNode(blk)->getIDom()->getBlock();
-    // a branch can have NULL immediate post-dominator when a function
-    // has multiple exits in llvm-ir
-    // compute influence region and the partial-joins
-    BranchInfo br_info(inst, ipd);
+    // a branch is revisited whenever its WI-dep degrades further, but its
+    // influence region only depends on the CFG
+    std::unique_ptr<BranchInfo>& cachedInfo = m_branchInfo[inst];
+    if (!cachedInfo)
+    {
+        BasicBlock* blk = (BasicBlock*)(inst->getParent());
+        BasicBlock* ipd = PDT->getNode(blk)->getIDom()->getBlock();
+        // a branch can have NULL immediate post-dominator when a function
+        // has multiple exits in llvm-ir
+        // compute influence region and the partial-joins
+        cachedInfo.reset(new BranchInfo(inst, ipd));
+    }
+    BranchInfo& br_info = *cachedInfo;
     // debug: dump influence region and partial-joins
     // br_info.print(ods());
 
     // check dep-type for every phi in the full join
-    if (ipd)
+    if (br_info.full_join)
     {
-        updatePHIDepAtJoin(ipd, &br_info);
+        updatePHIDepAtJoin(const_cast<BasicBlock*>(br_info.full_join), &br_info);
     }
     // check dep-type for every phi in the partial-joins
     for (SmallPtrSet<BasicBlock*, 4>::iterator join_it = br_info.partial_joins.begin(),
@@ -891,14 +1003,14 @@ void WIAnalysisRunner::updateDepMap(const Instruction* inst, WIAnalysis::WIDepen
     Value::const_user_iterator e = inst->user_end();
     for (; it != e; ++it)
     {
-        m_pChangedNew->push_back(*it);
+        addToChanged(*it);
     }
     if (const StoreInst * st = dyn_cast<StoreInst>(inst))
     {
         auto it = m_storeDepMap.find(st);
         if (it != m_storeDepMap.end())
         {
-            m_pChangedNew->push_back(it->second);
+            addToChanged(it->second);
         }
     }
     // accumulate work-list for backward adjustment
@@ -936,7 +1048,7 @@ void WIAnalysisRunner::updateInsertElements(const InsertElementInst* inst)
         Value::user_iterator e = curInst->user_end();
         for (; it != e; ++it)
         {
-            m_pChangedNew->push_back(*it);
+            addToChanged(*it);
         }
     }
 }
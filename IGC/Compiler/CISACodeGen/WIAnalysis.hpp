@@ -27,6 +27,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/CodeGenPublic.h"
 #include "Compiler/CISACodeGen/TranslationTable.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
@@ -53,13 +54,29 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Logger.h"
 #endif
 
+#include <memory>
 #include <vector>
 
 namespace IGC
 {
-    class BranchInfo;
     class WIAnalysis;
 
+    /// @Brief, given a conditional branch and its immediate post dominator,
+    /// find its influence-region and partial joins within the influence region
+    class BranchInfo
+    {
+    public:
+        BranchInfo(const IGCLLVM::TerminatorInst* inst, const llvm::BasicBlock* ipd);
+
+        void print(llvm::raw_ostream& OS) const;
+
+        const IGCLLVM::TerminatorInst* cbr;
+        const llvm::BasicBlock* full_join;
+        llvm::DenseSet<llvm::BasicBlock*> influence_region;
+        llvm::SmallPtrSet<llvm::BasicBlock*, 4> partial_joins;
+        llvm::BasicBlock* fork_blk;
+    };
+
     //This is a trick, since we cannot forward-declare enums embedded in class definitions.
     // The better solution is to completely hoist-out the WIDependency enum into a separate enum class
     // (c++ 11) and have it separate from WIAnalysis pass class. Nevertheless, that would require
@@ -113,6 +130,11 @@ namespace IGC
 
         bool run();
 
+        /// @brief Copy the results of run() out, or back in instead of running the
+        /// analysis again on an unchanged function.
+        void saveResults(WidthInvariantAnalysisCache::WIResult& result);
+        void restoreResults(const WidthInvariantAnalysisCache::WIResult& result);
+
         /// @brief Returns the type of dependency the instruction has on
         /// the work-item
         /// @param val llvm::Value to test
@@ -142,6 +164,9 @@ namespace IGC
             m_ctrlBranches.clear();
             m_changed1.clear();
             m_changed2.clear();
+            m_inChangedNew.clear();
+            m_instOrder.clear();
+            m_branchInfo.clear();
             m_backwardList.clear();
             m_allocaDepMap.clear();
             m_storeDepMap.clear();
@@ -209,6 +234,9 @@ namespace IGC
 
         void updateDepMap(const llvm::Instruction* inst, WIBaseClass::WIDependancy dep);
 
+        /// @brief queue a value for recalculation in the next iteration
+        void addToChanged(const llvm::Value* val);
+
         /// @brief Provide known dependency type for requested value
         /// @param val llvm::Value to examine
         /// @return Dependency type. Returns Uniform for unknown type
@@ -267,6 +295,12 @@ namespace IGC
         /// ptr to m_changed1, m_changed2
         std::vector<const llvm::Value*>* m_pChangedOld;
         std::vector<const llvm::Value*>* m_pChangedNew;
+        /// values already queued in m_pChangedNew
+        llvm::DenseSet<const llvm::Value*> m_inChangedNew;
+        /// reverse post-order position of every instruction
+        llvm::DenseMap<const llvm::Value*, unsigned> m_instOrder;
+        /// influence region of each divergent branch, computed once
+        llvm::DenseMap<const llvm::Instruction*, std::unique_ptr<BranchInfo>> m_branchInfo;
 
         std::vector<const llvm::Instruction*> m_backwardList;
 
@@ -349,6 +383,10 @@ namespace IGC
         /// check if a value is defined inside divergent control-flow
         bool insideDivergentCF(const llvm::Value* val);
 
+        /// keep the results in the CodeGenContext so that a later code-gen pass
+        /// manager over the same function can reuse them
+        void saveResults(CodeGenContext* ctx, llvm::Function& F);
+
         void releaseMemory() override
         {
             Runner.releaseMemory();
@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
 #include "Compiler/CodeGenPublic.h"
 #include "Probe/Assertion.h"
+#include <iStdLib/Timestamp.h>
 
 namespace IGC
 {
@@ -56,6 +57,7 @@ namespace IGC
         firstStateId = IGC_GET_FLAG_VALUE(RetryManagerFirstStateId);
         stateId = firstStateId;
         IGC_ASSERT(stateId < getStateCnt());
+        compileStartTick = iSTD::GetTimestampCounter();
     }
 
     bool RetryManager::AdvanceState() {
@@ -174,6 +176,56 @@ namespace IGC
         }
     }
 
+    // Percentage of the compile-time budget that may be spent before a stage
+    // falls back to its cheaper mode. Earlier stages give up first since the
+    // time they save is multiplied by everything that runs after them.
+    static unsigned getCompileTimeRiskPercent(CompileTimeDegradation degradation)
+    {
+        switch (degradation)
+        {
+        case COMPILE_TIME_DEGRADE_LOOP_OPTS:    return 25;
+        case COMPILE_TIME_DEGRADE_PRE_RA_SCHED: return 40;
+        case COMPILE_TIME_DEGRADE_SIMD32:       return 40;
+        case COMPILE_TIME_DEGRADE_FAST_RA:      return 60;
+        default:
+            IGC_ASSERT(false);
+            return 100;
+        }
+    }
+
+    bool RetryManager::DegradeForCompileTime(CompileTimeDegradation degradation, unsigned budgetMs)
+    {
+        if (compileTimeDegradations & degradation)
+        {
+            return true;
+        }
+        if (budgetMs == 0)
+        {
+            return false;
+        }
+
+        uint64_t elapsedTicks = iSTD::GetTimestampCounter() - compileStartTick;
+        uint64_t frequency = iSTD::GetTimestampFrequency();
+        uint64_t elapsedMs = frequency ? (elapsedTicks * 1000) / frequency : 0;
+        if (elapsedMs * 100 < (uint64_t)budgetMs * getCompileTimeRiskPercent(degradation))
+        {
+            return false;
+        }
+
+        compileTimeDegradations |= degradation;
+        return true;
+    }
+
+    unsigned RetryManager::GetCompileTimeDegradations() const
+    {
+        return compileTimeDegradations;
+    }
+
+    void RetryManager::ApplyCompileTimeDegradations(unsigned degradations)
+    {
+        compileTimeDegradations |= degradations;
+    }
+
     unsigned RetryManager::getStateCnt()
     {
         return sizeof(RetryTable) / sizeof(RetryState);
@@ -657,6 +709,7 @@ namespace IGC
     {
         m_enableSubroutine = false;
         m_enableFunctionPointer = false;
+        m_widthInvariantCache.clear();
 
         delete modMD;
         delete m_pMdUtils;
@@ -726,6 +779,20 @@ namespace IGC
             "IGC::PositionOnlyVertexShader") != nullptr;
     }
 
+    unsigned CodeGenContext::getCompileTimeBudget() const
+    {
+        if (IGC_GET_FLAG_VALUE(CompileTimeBudgetMs) != 0)
+        {
+            return IGC_GET_FLAG_VALUE(CompileTimeBudgetMs);
+        }
+        return modMD ? modMD->compOpt.CompileTimeBudgetMs : 0;
+    }
+
+    bool CodeGenContext::DegradeForCompileTime(CompileTimeDegradation degradation)
+    {
+        return m_retryManager.DegradeForCompileTime(degradation, getCompileTimeBudget());
+    }
+
     void CodeGenContext::setFlagsPerCtx()
     {
         if (m_DriverInfo.DessaAliasLevel() != -1) {
@@ -302,6 +302,7 @@ namespace IGC
 
         bool         hasControlFlow = false;
         unsigned int bufferSlot = 0;
+        unsigned int m_compileTimeDegradations = 0; //<! CompileTimeDegradation mask the shader was compiled with
         unsigned int statelessCBPushedSize = 0;
 
 
@@ -651,6 +652,24 @@ namespace IGC
         USC::SShaderStageBTLayout* getModifiableLayout();
     };
 
+    /// Cheaper settings the pipeline may switch to once the compile-time
+    /// budget (CompOptions::CompileTimeBudgetMs) is at risk. The mask covers
+    /// the whole program and is reported back once code generation is done,
+    /// through SKernelProgram::m_compileTimeDegradations for shaders and
+    /// CGen8OpenCLProgramBase::m_compileTimeDegradations for OpenCL programs.
+    enum CompileTimeDegradation : unsigned
+    {
+        COMPILE_TIME_DEGRADE_NONE         = 0,
+        COMPILE_TIME_DEGRADE_LOOP_OPTS    = 1 << 0, // skip GVN and LICM
+        COMPILE_TIME_DEGRADE_PRE_RA_SCHED = 1 << 1, // skip IGC and vISA pre-RA scheduling
+        COMPILE_TIME_DEGRADE_SIMD32       = 1 << 2, // compile SIMD8/16 only
+        COMPILE_TIME_DEGRADE_FAST_RA      = 1 << 3, // local (linear-scan) RA and fast spill
+        COMPILE_TIME_DEGRADE_ALL          = COMPILE_TIME_DEGRADE_LOOP_OPTS |
+                                            COMPILE_TIME_DEGRADE_PRE_RA_SCHED |
+                                            COMPILE_TIME_DEGRADE_SIMD32 |
+                                            COMPILE_TIME_DEGRADE_FAST_RA,
+    };
+
     class RetryManager
     {
     public:
@@ -687,6 +706,15 @@ namespace IGC
         // programOutput.  If returning true, then stop the further retry.
         bool PickupKernels(CodeGenContext* cgCtx);
 
+        // Returns true if the given degradation is in effect, either because it
+        // was applied before or because the time spent since this compile
+        // started has crossed the risk threshold of that stage. Degradations
+        // are sticky so that retries do not pay for the expensive mode again.
+        bool DegradeForCompileTime(CompileTimeDegradation degradation, unsigned budgetMs);
+        unsigned GetCompileTimeDegradations() const;
+        // Applies the given degradations up front, independent of the budget.
+        void ApplyCompileTimeDegradations(unsigned degradations);
+
     private:
         unsigned stateId;
         // For debugging purposes, it can be useful to start on a particular
@@ -700,6 +728,9 @@ namespace IGC
 
         unsigned lastSpillSize = 0;
 
+        uint64_t compileStartTick = 0;
+        unsigned compileTimeDegradations = COMPILE_TIME_DEGRADE_NONE;
+
         // cache the compiled kernel during retry
         CShader* m_simdEntries[3];
 
@@ -713,6 +744,30 @@ namespace IGC
         bool PickupCS(ComputeShaderContext* cgCtx);
     };
 
+    /// Results of SIMD-width-invariant analyses, kept across the per-SIMD code-gen
+    /// pass managers of one module so that they are not recomputed for every
+    /// dispatch width. Only valid while the IR is unchanged, i.e. between the
+    /// first EmitPass and the end of code generation.
+    struct WidthInvariantAnalysisCache
+    {
+        /// WIAnalysis results of a single function
+        struct WIResult
+        {
+            std::vector<std::pair<const llvm::Value*, uint8_t>> deps;
+            std::vector<std::pair<const llvm::BasicBlock*, std::vector<const llvm::Instruction*>>> ctrlBranches;
+        };
+
+        /// set while the code-gen pass managers are allowed to share results
+        bool enabled = false;
+        llvm::DenseMap<const llvm::Function*, WIResult> WI;
+
+        void clear()
+        {
+            enabled = false;
+            WI.clear();
+        }
+    };
+
     /// this class adds intrinsic cache to LLVM context
     class LLVMContextWrapper : public llvm::LLVMContext
     {
@@ -770,6 +825,7 @@ namespace IGC
         llvm::AssemblyAnnotationWriter* annotater = nullptr;
 
         RetryManager m_retryManager;
+        WidthInvariantAnalysisCache m_widthInvariantCache;
 
         // shader stat for opt customization
         uint32_t     m_tempCount = 0;
@@ -892,6 +948,8 @@ namespace IGC
         virtual bool hasNoLocalToGenericCast() const;
         virtual int16_t getVectorCoalescingControl() const;
         bool isPOSH() const;
+        unsigned getCompileTimeBudget() const;
+        bool DegradeForCompileTime(CompileTimeDegradation degradation);
 
         CompilerStats& Stats()
         {
@@ -1145,6 +1203,19 @@ namespace IGC
                         }
                     }
                 }
+                if (strstr(options, "-intel-fast-compile"))
+                {
+                    IntelFastCompilation = true;
+                }
+                if (const char* O = strstr(options, "-intel-compile-time-budget"))
+                {
+                    // -intel-compile-time-budget=<milliseconds>
+                    const char* optionVal = O + strlen("-intel-compile-time-budget");
+                    if (*optionVal == '=' && isdigit(*(optionVal + 1)))
+                    {
+                        CompileTimeBudgetMs = (unsigned)atoi(optionVal + 1);
+                    }
+                }
             }
 
 
@@ -1168,6 +1239,11 @@ namespace IGC
             // 0-5: valid values set from the cmdline
             int16_t VectorCoalescingControl = -1;
 
+            // 0: no compile-time budget
+            unsigned CompileTimeBudgetMs = 0;
+            // first tier of a two-tier (fast, then optimized) translation
+            bool IntelFastCompilation = false;
+
         };
 
         class Options
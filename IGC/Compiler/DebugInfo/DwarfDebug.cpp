@@ -67,6 +67,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
 
+#include <algorithm>
+
 using namespace llvm;
 using namespace IGC;
 
@@ -2678,27 +2680,61 @@ void DwarfDebug::gatherDISubprogramNodes()
     m_pModule->setDISPToFuncMap(&DISPToFunction);
 }
 
-bool VISAModule::getVarInfo(std::string prefix, unsigned int vreg, DbgDecoder::VarInfo& var)
+bool VISAModule::getVarInfo(const std::string& prefix, unsigned int vreg, DbgDecoder::VarInfo& var)
 {
-    std::string name = prefix + std::to_string(vreg);
+    auto co = getCompileUnit();
+    if (!co)
+        return false;
+
+    auto makeKey = [](unsigned int prefixId, unsigned int regNum)
+    {
+        return ((uint64_t)prefixId << 32) | regNum;
+    };
+
     if (VirToPhyMap.size() == 0)
     {
-        // populate map one time
-        auto co = getCompileUnit();
-        if (co)
+        // populate map one time. Names are of the form <prefix><reg num>, as
+        // printed by std::to_string (no leading zeros).
+        for (unsigned int i = 0; i != co->Vars.size(); i++)
         {
-            for (auto& v : co->Vars)
-            {
-                VirToPhyMap.insert(std::make_pair(v.name, v));
-            }
+            const std::string& name = co->Vars[i].name;
+            auto numPos = name.find_last_not_of("0123456789") + 1;
+            auto numLen = name.size() - numPos;
+            if (numLen == 0 || numLen > 10 || (numLen > 1 && name[numPos] == '0'))
+                continue;
+            uint64_t regNum = std::stoull(name.substr(numPos));
+            if (regNum > UINT32_MAX)
+                continue;
+
+            auto prefixIt = std::find(VirRegPrefixes.begin(), VirRegPrefixes.end(), name.substr(0, numPos));
+            unsigned int prefixId = (unsigned int)(prefixIt - VirRegPrefixes.begin());
+            if (prefixIt == VirRegPrefixes.end())
+                VirRegPrefixes.push_back(name.substr(0, numPos));
+
+            VirToPhyMap.push_back(std::make_pair(makeKey(prefixId, (unsigned int)regNum), i));
         }
+        // Stable so the first variable with a given name wins.
+        std::stable_sort(VirToPhyMap.begin(), VirToPhyMap.end(),
+            [](const std::pair<uint64_t, unsigned int>& a, const std::pair<uint64_t, unsigned int>& b)
+            {
+                return a.first < b.first;
+            });
     }
 
-    auto it = VirToPhyMap.find(name);
-    if (it == VirToPhyMap.end())
+    auto prefixIt = std::find(VirRegPrefixes.begin(), VirRegPrefixes.end(), prefix);
+    if (prefixIt == VirRegPrefixes.end())
+        return false;
+
+    uint64_t key = makeKey((unsigned int)(prefixIt - VirRegPrefixes.begin()), vreg);
+    auto it = std::lower_bound(VirToPhyMap.begin(), VirToPhyMap.end(), key,
+        [](const std::pair<uint64_t, unsigned int>& a, uint64_t k)
+        {
+            return a.first < k;
+        });
+    if (it == VirToPhyMap.end() || it->first != key)
         return false;
 
-    var = (*it).second;
+    var = co->Vars[it->second];
     return true;
 }
 
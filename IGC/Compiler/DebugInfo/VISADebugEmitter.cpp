@@ -214,8 +214,6 @@ void DebugEmitter::Finalize(void*& pBuffer, unsigned int& size, bool finalize)
         // Emit src line mapping directly instead of
         // relying on dbgmerge. elf generated will have
         // text section and debug_line sections populated.
-        auto& VISAIndexToInst = m_pVISAModule->VISAIndexToInst;
-        auto& VISAIndexToSize = m_pVISAModule->VISAIndexToSize;
         std::vector<std::pair<unsigned int, unsigned int>> GenISAToVISAIndex;
         unsigned int subEnd = m_pVISAModule->GetCurrentVISAId();
         unsigned int prevLastGenOff = lastGenOff;
@@ -260,9 +258,9 @@ void DebugEmitter::Finalize(void*& pBuffer, unsigned int& size, bool finalize)
 
             pc = item.first;
 
-            auto instIt = VISAIndexToInst.end();
-            auto sizeIt = VISAIndexToSize.find(item.second);
-            if (sizeIt != VISAIndexToSize.end())
+            const llvm::Instruction* pInst = nullptr;
+            unsigned int startIdx = 0, numVISAInsts = 0;
+            if (m_pVISAModule->getVISAIndexGroup(item.second, startIdx, numVISAInsts))
             {
                 // Lookup all VISA instructions that may
                 // map to an llvm::Instruction. This is useful
@@ -271,23 +269,21 @@ void DebugEmitter::Finalize(void*& pBuffer, unsigned int& size, bool finalize)
                 // optimizes some of those away. Src line
                 // mapping for all VISA instructions is the
                 // same. So lookup any one that still exists.
-                auto startIdx = sizeIt->second.first;
-                auto numVISAInsts = sizeIt->second.second;
                 for (unsigned int visaId = startIdx;
                     visaId != (startIdx + numVISAInsts); visaId++)
                 {
-                    instIt = VISAIndexToInst.find(visaId);
+                    pInst = m_pVISAModule->getInstForVISAIndex(visaId);
                     // Loop till at least one VISA instruction
                     // is found.
-                    if (instIt != VISAIndexToInst.end())
+                    if (pInst)
                         break;
                 }
             }
 
             bool emptyLoc = true;
-            if (instIt != VISAIndexToInst.end())
+            if (pInst)
             {
-                auto loc = instIt->second->getDebugLoc();
+                auto loc = pInst->getDebugLoc();
                 if (loc)
                 {
                     if (loc != prevSrcLoc)
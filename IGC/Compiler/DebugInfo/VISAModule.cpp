@@ -44,6 +44,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "llvm/IR/Module.h"
 #include "llvm/IR/DebugInfo.h"
 #include "common/LLVMWarningsPop.hpp"
+#include <algorithm>
 #include <vector>
 #include "Probe/Assertion.h"
 
@@ -717,6 +718,10 @@ void VISAModule::Reset()
 
 void VISAModule::buildDirectElfMaps()
 {
+    // VISA index used by the debug info for Gen ISA instructions not mapped
+    // to any VISA instruction.
+    const unsigned int INVALID_VISA_INDEX = 0xffffffff;
+
     auto co = getCompileUnit();
     VISAIndexToInst.clear();
     VISAIndexToSize.clear();
@@ -729,46 +734,103 @@ void VISAModule::buildDirectElfMaps()
             continue;
 
         unsigned int currOffset = itr->second.m_offset;
-        VISAIndexToInst.insert(std::make_pair(currOffset, pInst));
         unsigned int currSize = itr->second.m_size;
+        if (VISAIndexToInst.size() <= currOffset)
+            VISAIndexToInst.resize(currOffset + 1, nullptr);
+        if (VISAIndexToSize.size() < currOffset + currSize)
+            VISAIndexToSize.resize(currOffset + currSize, std::make_pair(0, 0));
+
+        // Keep the first instruction mapped to a VISA index
+        if (!VISAIndexToInst[currOffset])
+            VISAIndexToInst[currOffset] = pInst;
         for (auto index = currOffset; index != (currOffset + currSize); index++)
-            VISAIndexToSize.insert(std::make_pair(index,
-                std::make_pair(currOffset, currSize)));
+        {
+            if (VISAIndexToSize[index].second == 0)
+                VISAIndexToSize[index] = std::make_pair(currOffset, currSize);
+        }
     }
 
     GenISAToVISAIndex.clear();
-    for (auto i = 0;
-        i != co->CISAIndexMap.size();
-        i++)
+    GenISAToVISAIndex.reserve(co->CISAIndexMap.size());
+    unsigned int numVISAIndices = 0;
+    for (auto& item : co->CISAIndexMap)
     {
-        auto& item = co->CISAIndexMap[i];
         GenISAToVISAIndex.push_back(std::make_pair(item.second, item.first));
+        if (item.first != INVALID_VISA_INDEX)
+            numVISAIndices = std::max(numVISAIndices, item.first + 1);
     }
 
-    // Compute all Gen ISA offsets corresponding to each VISA index
-    VISAIndexToAllGenISAOff.clear();
+    // Compute all Gen ISA offsets corresponding to each VISA index. Counting
+    // sort keeps offsets of each VISA index in CISAIndexMap order.
+    VISAIndexToGenISAOffStart.assign(numVISAIndices + 1, 0);
     for (auto& item : co->CISAIndexMap)
     {
-        auto VISAIndex = item.first;
-        auto GenISAOffset = item.second;
-        auto it = VISAIndexToAllGenISAOff.find(VISAIndex);
-        if (it != VISAIndexToAllGenISAOff.end())
-            it->second.push_back(GenISAOffset);
-        else
-        {
-            std::vector<unsigned int> vec;
-            vec.push_back(GenISAOffset);
-            VISAIndexToAllGenISAOff[VISAIndex] = vec;
-        }
+        if (item.first != INVALID_VISA_INDEX)
+            VISAIndexToGenISAOffStart[item.first + 1]++;
+    }
+    for (unsigned int i = 0; i != numVISAIndices; i++)
+        VISAIndexToGenISAOffStart[i + 1] += VISAIndexToGenISAOffStart[i];
+
+    GenISAOffsets.resize(VISAIndexToGenISAOffStart[numVISAIndices]);
+    std::vector<unsigned int> fillPos(VISAIndexToGenISAOffStart.begin(), VISAIndexToGenISAOffStart.end() - 1);
+    for (auto& item : co->CISAIndexMap)
+    {
+        if (item.first != INVALID_VISA_INDEX)
+            GenISAOffsets[fillPos[item.first]++] = item.second;
     }
 
     GenISAInstSizeBytes.clear();
-    for (auto i = 0; i != co->CISAIndexMap.size() - 1; i++)
+    if (GenISAToVISAIndex.empty())
+        return;
+
+    GenISAInstSizeBytes.reserve(GenISAToVISAIndex.size());
+    for (auto i = 0; i != GenISAToVISAIndex.size() - 1; i++)
     {
         unsigned int size = GenISAToVISAIndex[i + 1].first - GenISAToVISAIndex[i].first;
-        GenISAInstSizeBytes.insert(std::make_pair(GenISAToVISAIndex[i].first, size));
+        GenISAInstSizeBytes.push_back(std::make_pair(GenISAToVISAIndex[i].first, size));
     }
-    GenISAInstSizeBytes.insert(std::make_pair(GenISAToVISAIndex[GenISAToVISAIndex.size() - 1].first, 16));
+    GenISAInstSizeBytes.push_back(std::make_pair(GenISAToVISAIndex.back().first, 16));
+
+    // Sort by offset; the first entry recorded for an offset wins.
+    auto offsetLess = [](const std::pair<unsigned int, unsigned int>& a,
+        const std::pair<unsigned int, unsigned int>& b)
+    {
+        return a.first < b.first;
+    };
+    std::stable_sort(GenISAInstSizeBytes.begin(), GenISAInstSizeBytes.end(), offsetLess);
+    GenISAInstSizeBytes.erase(std::unique(GenISAInstSizeBytes.begin(), GenISAInstSizeBytes.end(),
+        [](const std::pair<unsigned int, unsigned int>& a, const std::pair<unsigned int, unsigned int>& b)
+        {
+            return a.first == b.first;
+        }), GenISAInstSizeBytes.end());
+}
+
+const llvm::Instruction* VISAModule::getInstForVISAIndex(unsigned int VISAIndex) const
+{
+    if (VISAIndex >= VISAIndexToInst.size())
+        return nullptr;
+    return VISAIndexToInst[VISAIndex];
+}
+
+bool VISAModule::getVISAIndexGroup(unsigned int VISAIndex, unsigned int& startIdx, unsigned int& numVISAInsts) const
+{
+    if (VISAIndex >= VISAIndexToSize.size() || VISAIndexToSize[VISAIndex].second == 0)
+        return false;
+    startIdx = VISAIndexToSize[VISAIndex].first;
+    numVISAInsts = VISAIndexToSize[VISAIndex].second;
+    return true;
+}
+
+unsigned int VISAModule::getGenISAInstSize(unsigned int GenISAOffset) const
+{
+    auto it = std::lower_bound(GenISAInstSizeBytes.begin(), GenISAInstSizeBytes.end(), GenISAOffset,
+        [](const std::pair<unsigned int, unsigned int>& a, unsigned int offset)
+        {
+            return a.first < offset;
+        });
+    if (it == GenISAInstSizeBytes.end() || it->first != GenISAOffset)
+        return 0;
+    return it->second;
 }
 
 std::vector<std::pair<unsigned int, unsigned int>> VISAModule::getGenISARange(const InsnRange& Range)
@@ -817,13 +879,14 @@ std::vector<std::pair<unsigned int, unsigned int>> VISAModule::getGenISARange(co
         for (unsigned int i = 0; i != VISASize; i++)
         {
             auto VISAIndex = startVISAOffset + i;
-            auto it = VISAIndexToAllGenISAOff.find(VISAIndex);
-            if (it != VISAIndexToAllGenISAOff.end())
+            if (VISAIndex + 1 < VISAIndexToGenISAOffStart.size())
             {
                 int lastEnd = -1;
-                for (auto& genInst : it->second)
+                for (auto genIdx = VISAIndexToGenISAOffStart[VISAIndex];
+                    genIdx != VISAIndexToGenISAOffStart[VISAIndex + 1]; genIdx++)
                 {
-                    unsigned int sizeGenInst = GenISAInstSizeBytes[genInst];
+                    unsigned int genInst = GenISAOffsets[genIdx];
+                    unsigned int sizeGenInst = getGenISAInstSize(genInst);
 
                     if (GenISARange.size() > 0)
                         lastEnd = GenISARange.back().second;
@@ -432,29 +432,39 @@ namespace IGC
         }
 
         bool isDirectElfInput = false;
-        // Store first VISA index->llvm::Instruction mapping
-        std::map<unsigned int, const llvm::Instruction*> VISAIndexToInst;
+        // The tables below are built by buildDirectElfMaps(). VISA indices are
+        // dense, so VISA index keyed tables are plain vectors indexed by VISA
+        // index; Gen ISA offset keyed tables are sorted arrays searched with
+        // binary search.
+
+        // Store first VISA index->llvm::Instruction mapping, nullptr if none.
+        std::vector<const llvm::Instruction*> VISAIndexToInst;
         // Store VISA index->[header VISA index, #VISA instructions] corresponding
         // to same llvm::Instruction. If llvm inst A generates VISA 3,4,5 then
         // this structure will have 3 entries:
         // 3 -> [3,3]
         // 4 -> [3,3]
         // 5 -> [3,3]
-        std::map<unsigned int, std::pair<unsigned int, unsigned int>> VISAIndexToSize;
+        // #VISA instructions is 0 for VISA indices not mapped to any instruction.
+        std::vector<std::pair<unsigned int, unsigned int>> VISAIndexToSize;
         std::vector<std::pair<unsigned int, unsigned int>> GenISAToVISAIndex;
-        std::map<unsigned int, std::vector<unsigned int>> VISAIndexToAllGenISAOff;
-        std::map<unsigned int, unsigned int> GenISAInstSizeBytes;
-        class comparer
-        {
-        public:
-            bool operator()(const std::string& v1, const std::string& v2) const
-            {
-                return v1.compare(v2) < 0;
-            }
-        };
-        std::map<std::string, DbgDecoder::VarInfo, comparer> VirToPhyMap;
-
-        bool getVarInfo(std::string prefix, unsigned int vreg, DbgDecoder::VarInfo& var);
+        // All Gen ISA offsets of VISA index i are
+        // GenISAOffsets[VISAIndexToGenISAOffStart[i] .. VISAIndexToGenISAOffStart[i + 1]).
+        std::vector<unsigned int> VISAIndexToGenISAOffStart;
+        std::vector<unsigned int> GenISAOffsets;
+        // [Gen ISA offset, size in bytes] sorted by offset.
+        std::vector<std::pair<unsigned int, unsigned int>> GenISAInstSizeBytes;
+        // Virtual register names are interned as [prefix id, register number]
+        // keys so lookups do not build strings. Sorted by key, maps to an index
+        // into the compile unit's Vars.
+        std::vector<std::string> VirRegPrefixes;
+        std::vector<std::pair<uint64_t, unsigned int>> VirToPhyMap;
+
+        const llvm::Instruction* getInstForVISAIndex(unsigned int VISAIndex) const;
+        bool getVISAIndexGroup(unsigned int VISAIndex, unsigned int& startIdx, unsigned int& numVISAInsts) const;
+        unsigned int getGenISAInstSize(unsigned int GenISAOffset) const;
+
+        bool getVarInfo(const std::string& prefix, unsigned int vreg, DbgDecoder::VarInfo& var);
         std::vector<DbgDecoder::SubroutineInfo>* getSubroutines() const;
         DbgDecoder::DbgInfoFormat* getCompileUnit() const;
 
@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include "llvmWrapper/Bitcode/BitcodeWriter.h"
+#include <llvm/Analysis/ConstantFolding.h>
 #include <llvm/Support/ScaledNumber.h>
 #include <llvm/Bitcode/BitcodeReader.h>
 #include "llvm/IR/DebugInfo.h"
@@ -46,6 +47,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Probe/Assertion.h"
 
 char IGC::GenUpdateCB::ID = 0;
+char IGC::GenUpdateCBEvaluate::ID = 0;
 
 using namespace llvm;
 using namespace IGC;
@@ -54,6 +56,9 @@ using namespace IGC;
 IGC_INITIALIZE_PASS_BEGIN(GenUpdateCB, "GenUpdateCB", "GenUpdateCB", false, false)
 IGC_INITIALIZE_PASS_END(GenUpdateCB, "GenUpdateCB", "GenUpdateCB", false, false)
 
+IGC_INITIALIZE_PASS_BEGIN(GenUpdateCBEvaluate, "GenUpdateCBEvaluate", "GenUpdateCBEvaluate", false, false)
+IGC_INITIALIZE_PASS_END(GenUpdateCBEvaluate, "GenUpdateCBEvaluate", "GenUpdateCBEvaluate", false, false)
+
 static bool isResInfo(GenIntrinsicInst* inst, unsigned& texId, unsigned& lod, bool& isUAV)
 {
     if (inst && inst->getIntrinsicID() == GenISAIntrinsic::GenISA_resinfoptr)
@@ -341,6 +346,286 @@ Instruction* GenUpdateCB::CreateModule(Module* M)
     return ret;
 }
 
+// Map an arithmetic instruction of the CB mini-shader to its bytecode opcode.
+// For fneg written as "fsub 0.0, x" the operand to negate is returned in negSrc.
+static bool getCBOpcode(Instruction* inst, CBBytecode::Opcode& op, Value*& negSrc)
+{
+    using namespace CBBytecode;
+    negSrc = nullptr;
+    if (CallInst* callI = dyn_cast<CallInst>(inst))
+    {
+        switch (GetOpCode(callI))
+        {
+        case llvm_cos:   op = OP_COS;   return true;
+        case llvm_sin:   op = OP_SIN;   return true;
+        case llvm_log:   op = OP_LOG;   return true;
+        case llvm_exp:   op = OP_EXP;   return true;
+        case llvm_sqrt:  op = OP_SQRT;  return true;
+        case llvm_floor: op = OP_FLOOR; return true;
+        case llvm_ceil:  op = OP_CEIL;  return true;
+        case llvm_fabs:  op = OP_FABS;  return true;
+        case llvm_pow:   op = OP_POW;   return true;
+        case llvm_max:   op = OP_MAX;   return true;
+        case llvm_min:   op = OP_MIN;   return true;
+        case llvm_rsq:   op = OP_RSQ;   return true;
+        case llvm_fsat:  op = OP_FSAT;  return true;
+        default:
+            return false;
+        }
+    }
+
+    switch (inst->getOpcode())
+    {
+    case Instruction::Add:  op = OP_ADD;  return true;
+    case Instruction::FAdd: op = OP_FADD; return true;
+    case Instruction::Sub:  op = OP_SUB;  return true;
+    case Instruction::FSub:
+        if (ConstantFP* C0 = dyn_cast<ConstantFP>(inst->getOperand(0)))
+        {
+            if (C0->isZero())
+            {
+                op = OP_FNEG;
+                negSrc = inst->getOperand(1);
+                return true;
+            }
+        }
+        op = OP_FSUB;
+        return true;
+    case Instruction::Mul:  op = OP_MUL;  return true;
+    case Instruction::FMul: op = OP_FMUL; return true;
+    case Instruction::UDiv: op = OP_UDIV; return true;
+    case Instruction::SDiv: op = OP_SDIV; return true;
+    case Instruction::FDiv: op = OP_FDIV; return true;
+    case Instruction::URem: op = OP_UREM; return true;
+    case Instruction::SRem: op = OP_SREM; return true;
+    case Instruction::Shl:  op = OP_SHL;  return true;
+    case Instruction::LShr: op = OP_LSHR; return true;
+    case Instruction::AShr: op = OP_ASHR; return true;
+    case Instruction::And:  op = OP_AND;  return true;
+    case Instruction::Or:   op = OP_OR;   return true;
+    case Instruction::Xor:  op = OP_XOR;  return true;
+    default:
+        return false;
+    }
+}
+
+static bool hasSecondCBSource(CBBytecode::Opcode op)
+{
+    using namespace CBBytecode;
+    return (op >= OP_ADD && op <= OP_XOR) ||
+        op == OP_POW || op == OP_MAX || op == OP_MIN;
+}
+
+// Lower the CB mini-shader to CBBytecode. Returns false if the module uses
+// anything the bytecode cannot express, in which case bitcode is shipped.
+//
+// Scalar operations with the same opcode and result type are packed into the
+// lanes of one instruction as long as no lane reads the result of another.
+// A pending instruction is emitted once it has MaxLanes lanes or once a later
+// operation needs one of its results, which keeps every source defined before
+// it is read and the outputs in store order.
+bool GenUpdateCB::EncodeBytecode(Module* M, SmallVectorImpl<char>& code)
+{
+    using namespace CBBytecode;
+
+    struct Pending
+    {
+        Inst inst;
+        Src srcs[MaxLanes];
+        Value* lanes[MaxLanes];
+    };
+
+    DenseMap<const Value*, uint32_t> regOf;
+    DenseMap<const Value*, unsigned> pendingOf;
+    SmallVector<Pending, 8> pending;
+    SmallVector<char, 256> records;
+    uint32_t numRegs = 0;
+    uint32_t numInsts = 0;
+
+    auto emit = [&](const Inst& inst, const Src* srcs)
+    {
+        records.append((const char*)&inst, (const char*)&inst + sizeof(inst));
+        records.append((const char*)srcs, (const char*)srcs + inst.numLanes * sizeof(Src));
+        numInsts++;
+    };
+    auto flush = [&](unsigned idx)
+    {
+        Pending& P = pending[idx];
+        if (P.inst.opcode != OP_OUTPUT)
+        {
+            P.inst.dst = (uint16_t)numRegs;
+            for (unsigned c = 0; c < P.inst.numLanes; c++)
+            {
+                regOf[P.lanes[c]] = numRegs++;
+            }
+        }
+        for (unsigned c = 0; c < P.inst.numLanes; c++)
+        {
+            pendingOf.erase(P.lanes[c]);
+        }
+        emit(P.inst, P.srcs);
+        pending.erase(pending.begin() + idx);
+        for (auto& it : pendingOf)
+        {
+            if (it.second > idx)
+                it.second--;
+        }
+    };
+    // Makes V readable from a register, emitting its pending instruction.
+    auto define = [&](Value* V)
+    {
+        auto it = pendingOf.find(V);
+        if (it != pendingOf.end())
+        {
+            flush(it->second);
+        }
+    };
+    auto addLane = [&](Value* V, uint8_t opcode, uint8_t flags, const Src& src, uint8_t imm)
+    {
+        unsigned idx = 0;
+        while (idx < pending.size() &&
+            (pending[idx].inst.opcode != opcode || pending[idx].inst.flags != flags))
+        {
+            idx++;
+        }
+        if (idx == pending.size())
+        {
+            Pending P = {};
+            P.inst.opcode = opcode;
+            P.inst.flags = flags;
+            pending.push_back(P);
+        }
+        Pending& P = pending[idx];
+        unsigned lane = P.inst.numLanes++;
+        P.srcs[lane] = src;
+        P.lanes[lane] = V;
+        P.inst.immMask |= imm << lane;
+        pendingOf[V] = idx;
+        if (P.inst.numLanes == MaxLanes)
+        {
+            flush(idx);
+        }
+    };
+    auto encodeSrc = [&](Value* V, uint32_t& src, uint8_t& imm, uint8_t immBit)
+    {
+        if (ConstantFP* C = dyn_cast<ConstantFP>(V))
+        {
+            if (!C->getType()->isFloatTy())
+                return false;
+            src = (uint32_t)C->getValueAPF().bitcastToAPInt().getZExtValue();
+            imm |= immBit;
+            return true;
+        }
+        if (ConstantInt* C = dyn_cast<ConstantInt>(V))
+        {
+            if (C->getBitWidth() > 32)
+                return false;
+            src = (uint32_t)(int)C->getSExtValue();
+            imm |= immBit;
+            return true;
+        }
+        define(V);
+        auto it = regOf.find(V);
+        if (it == regOf.end())
+            return false;
+        src = it->second;
+        return true;
+    };
+    auto isScalar32 = [](Type* Ty)
+    {
+        return Ty->isFloatTy() || Ty->isIntegerTy(32);
+    };
+
+    BasicBlock* BB = &M->getFunctionList().begin()->getEntryBlock();
+    for (auto II = BB->begin(), IE = BB->end(); II != IE; ++II)
+    {
+        Instruction* inst = &(*II);
+        Src src = {};
+        uint8_t imm = 0;
+        unsigned texId = 0, lod = 0;
+        bool isUAV = false;
+
+        if (isa<AllocaInst>(inst) || isa<ReturnInst>(inst))
+        {
+            continue;
+        }
+        else if (LoadInst* ld = dyn_cast<LoadInst>(inst))
+        {
+            if (!isScalar32(ld->getType()))
+                return false;
+            bool directBuf;
+            unsigned bufId;
+            IGC::DecodeAS4GFXResource(ld->getPointerAddressSpace(), directBuf, bufId);
+            src.src0 = bufId;
+            src.src1 = (uint32_t)IGC::getConstantBufferLoadOffset(ld);
+            addLane(ld, OP_LOAD_CB, ld->getType()->isFloatTy() ? RESULT_FLOAT : 0, src, 0);
+        }
+        else if (isResInfo(dyn_cast<GenIntrinsicInst>(inst), texId, lod, isUAV))
+        {
+            if (lod & RESINFO_UAV_BIT)
+                return false;
+            Inst ci = {};
+            ci.opcode = OP_RESINFO;
+            ci.numLanes = 1;
+            ci.dst = (uint16_t)numRegs;
+            src.src0 = texId;
+            src.src1 = lod | (isUAV ? RESINFO_UAV_BIT : 0);
+            regOf[inst] = numRegs;
+            numRegs += 4;
+            emit(ci, &src);
+        }
+        else if (ExtractElementInst* extract = dyn_cast<ExtractElementInst>(inst))
+        {
+            // resinfo channels are already in consecutive registers
+            ConstantInt* idx = dyn_cast<ConstantInt>(extract->getIndexOperand());
+            auto it = regOf.find(extract->getVectorOperand());
+            if (!idx || idx->getZExtValue() >= 4 || it == regOf.end())
+                return false;
+            regOf[extract] = it->second + (uint32_t)idx->getZExtValue();
+        }
+        else if (StoreInst* st = dyn_cast<StoreInst>(inst))
+        {
+            if (!encodeSrc(st->getValueOperand(), src.src0, imm, SRC0_IMM))
+                return false;
+            addLane(st, OP_OUTPUT, 0, src, imm | SRC1_IMM);
+        }
+        else
+        {
+            Opcode op;
+            Value* negSrc = nullptr;
+            if (!isScalar32(inst->getType()) || !getCBOpcode(inst, op, negSrc))
+                return false;
+            if (!encodeSrc(negSrc ? negSrc : inst->getOperand(0), src.src0, imm, SRC0_IMM))
+                return false;
+            if (!hasSecondCBSource(op))
+                imm |= SRC1_IMM;
+            else if (!encodeSrc(inst->getOperand(1), src.src1, imm, SRC1_IMM))
+                return false;
+            addLane(inst, op, inst->getType()->isFloatTy() ? RESULT_FLOAT : 0, src, imm);
+        }
+
+        if (numRegs > UINT16_MAX)
+            return false;
+    }
+    while (!pending.empty())
+    {
+        flush(0);
+    }
+    if (numRegs > UINT16_MAX)
+        return false;
+
+    Header header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.numRegs = (uint16_t)numRegs;
+    header.numInsts = numInsts;
+
+    code.clear();
+    code.append((const char*)&header, (const char*)&header + sizeof(header));
+    code.append(records.begin(), records.end());
+    return true;
+}
+
 bool GenUpdateCB::runOnFunction(Function& F)
 {
     m_ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
@@ -524,21 +809,33 @@ bool GenUpdateCB::runOnFunction(Function& F)
 
         if (m_ConstantBufferReplaceShaderPatterns)
         {
-            // write the minishader Module to memory
-            llvm::SmallVector<char, 4> bitcodeSV;
-            llvm::raw_svector_ostream bitcodeSS(bitcodeSV);
-            IGCLLVM::WriteBitcodeToFile(m_ConstantBufferReplaceShaderPatterns, bitcodeSS);
-
             IGC::Debug::DumpName name = IGC::Debug::GetLLDumpName(m_ctx, "gencb");
             IGC::Debug::DumpLLVMIRText(m_ConstantBufferReplaceShaderPatterns,
                 IGC::Debug::Dump(name, IGC::Debug::DumpType::PASS_IR_TEXT));
 
-            size_t bufferSize = bitcodeSS.str().size();
+            // write the minishader to memory, preferring the compact bytecode
+            // and falling back to LLVM bitcode if it cannot be encoded
+            llvm::SmallVector<char, 256> patternSV;
+            if (EncodeBytecode(m_ConstantBufferReplaceShaderPatterns, patternSV))
+            {
+                if (IGC_IS_FLAG_ENABLED(VerifyGenUpdateCBBytecode))
+                {
+                    VerifyBytecode(m_ConstantBufferReplaceShaderPatterns, patternSV, counter);
+                }
+            }
+            else
+            {
+                patternSV.clear();
+                llvm::raw_svector_ostream bitcodeSS(patternSV);
+                IGCLLVM::WriteBitcodeToFile(m_ConstantBufferReplaceShaderPatterns, bitcodeSS);
+            }
+
+            size_t bufferSize = patternSV.size();
             void* CBPatterns = aligned_malloc(bufferSize, 16);
 
             iSTD::MemCopy(
                 CBPatterns,
-                const_cast<char*>(bitcodeSS.str().data()),
+                patternSV.data(),
                 bufferSize);
 
             // return
@@ -558,7 +855,7 @@ namespace IGC
         float f;
         int i;
         uint u;
-    } ftod0, ftod1, ftodTemp;
+    } ftodTemp;
 
     uint lookupValue(Value* op, DenseMap<Value*, uint>& CalculatedValue)
     {
@@ -604,54 +901,183 @@ namespace IGC
         return un.f;
     }
 
-    static inline uint32_t ftou_ftz(float f)
+    static inline uint32_t ftou(float f)
     {
         union
         {
             float f;
             uint32_t u;
         } un;
-        un.f = denormToZeroF(f);
+        un.f = f;
         return un.u;
     }
 
-    void FoldDerivedConstant(
-        char* bitcode, uint bitcodeSize,
-        void* CBptr[15], std::function<void(uint[4], uint, uint, bool)> getResInfoCB,
-        uint* pNewCB)
+    static inline uint32_t ftou_ftz(float f)
     {
-        // load module from memory
-        llvm::Module* M = NULL;
+        return ftou(denormToZeroF(f));
+    }
 
-        llvm::StringRef bitRef(bitcode, bitcodeSize);
-        std::unique_ptr<llvm::MemoryBuffer> bitcodeMem =
-            llvm::MemoryBuffer::getMemBuffer(bitRef, "", /* Null Term  = */ false);
+    template<typename LaneOp>
+    static inline void forEachLane(const uint32_t* a, const uint32_t* b, uint32_t* r, LaneOp laneOp)
+    {
+        for (unsigned c = 0; c < CBBytecode::MaxLanes; c++)
+        {
+            r[c] = laneOp(a[c], b[c]);
+        }
+    }
 
-        bool isBitCode = llvm::isBitcode(
-            (const unsigned char*)bitcodeMem->getBufferStart(),
-            (const unsigned char*)bitcodeMem->getBufferEnd());
+    // Semantics shared by the bytecode and the LLVM module evaluators. Every
+    // lane is computed, whether the instruction uses it or not, so that the
+    // loops have a fixed trip count the host compiler can vectorize.
+    static void evaluateCBLanes(CBBytecode::Opcode op, const uint32_t* a, const uint32_t* b, uint32_t* r)
+    {
+        using namespace CBBytecode;
 
-        LLVMContextWrapper context;
-        if (isBitCode)
+        switch (op)
         {
-            llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                llvm::parseBitcodeFile(bitcodeMem->getMemBufferRef(), context);
+        case OP_FNEG:  forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(-utof(x)); }); break;
+        case OP_ADD:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x + y; }); break;
+        case OP_FADD:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return ftou(utof(x) + utof(y)); }); break;
+        case OP_SUB:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x - y; }); break;
+        case OP_FSUB:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return ftou(utof(x) - utof(y)); }); break;
+        case OP_MUL:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x * y; }); break;
+        case OP_FMUL:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return ftou(utof(x) * utof(y)); }); break;
+        case OP_UDIV:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return y ? x / y : 0; }); break;
+        case OP_SDIV:
+            forEachLane(a, b, r, [](uint32_t x, uint32_t y) {
+                int32_t ix = (int32_t)x, iy = (int32_t)y;
+                return iy == 0 ? 0 : (iy == -1 ? 0u - x : (uint32_t)(ix / iy));
+            });
+            break;
+        case OP_FDIV:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return ftou(utof(x) / utof(y)); }); break;
+        case OP_UREM:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return y ? x % y : 0; }); break;
+        case OP_SREM:
+            forEachLane(a, b, r, [](uint32_t x, uint32_t y) {
+                int32_t ix = (int32_t)x, iy = (int32_t)y;
+                return (iy == 0 || iy == -1) ? 0 : (uint32_t)(ix % iy);
+            });
+            break;
+        case OP_SHL:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x << (y & 31); }); break;
+        case OP_LSHR:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x >> (y & 31); }); break;
+        case OP_ASHR:  forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return (uint32_t)((int32_t)x >> (y & 31)); }); break;
+        case OP_AND:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x & y; }); break;
+        case OP_OR:    forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x | y; }); break;
+        case OP_XOR:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return x ^ y; }); break;
+        case OP_COS:   forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(cosf(utof(x))); }); break;
+        case OP_SIN:   forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(sinf(utof(x))); }); break;
+        case OP_LOG:   forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(log2f(utof(x))); }); break;
+        case OP_EXP:   forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(powf(2.0f, utof(x))); }); break;
+        case OP_SQRT:  forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(sqrtf(utof(x))); }); break;
+        case OP_FLOOR: forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(floorf(utof(x))); }); break;
+        case OP_CEIL:  forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(ceilf(utof(x))); }); break;
+        case OP_FABS:  forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(fabsf(utof(x))); }); break;
+        case OP_POW:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return ftou(powf(utof(x), utof(y))); }); break;
+        // cannot use std::max since:
+        //   std::max(Nan, x) = Nan
+        //   std::max(x, NaN) = x
+        //   fmax(Nan, x) = x
+        //   fmax(x, Nan) = x
+        case OP_MAX:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return ftou(fmaxf(utof(x), utof(y))); }); break;
+        case OP_MIN:   forEachLane(a, b, r, [](uint32_t x, uint32_t y) { return ftou(fminf(utof(x), utof(y))); }); break;
+        case OP_RSQ:   forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(1.0f / sqrtf(utof(x))); }); break;
+        case OP_FSAT:  forEachLane(a, b, r, [](uint32_t x, uint32_t) { return ftou(fminf(1.0f, fmaxf(0.0f, utof(x)))); }); break;
+        default:
+            IGC_ASSERT(0);
+            forEachLane(a, b, r, [](uint32_t x, uint32_t) { return 0u; });
+            break;
+        }
+    }
 
-            if (llvm::Error EC = ModuleOrErr.takeError())
+    static uint32_t evaluateCBOp(CBBytecode::Opcode op, uint32_t a, uint32_t b)
+    {
+        uint32_t a4[CBBytecode::MaxLanes] = { a };
+        uint32_t b4[CBBytecode::MaxLanes] = { b };
+        uint32_t r4[CBBytecode::MaxLanes];
+        evaluateCBLanes(op, a4, b4, r4);
+        return r4[0];
+    }
+
+    static void FoldDerivedConstantBytecode(
+        const char* code, uint codeSize,
+        void* CBptr[15], const std::function<void(uint[4], uint, uint, bool)>& getResInfoCB,
+        uint* pNewCB)
+    {
+        using namespace CBBytecode;
+
+        Header header;
+        memcpy_s(&header, sizeof(header), code, sizeof(header));
+        IGC_ASSERT(header.magic == Magic && header.version == Version);
+
+        SmallVector<uint32_t, 256> regs(header.numRegs, 0);
+        const char* instPtr = code + sizeof(Header);
+        const char* codeEnd = code + codeSize;
+        uint newCBIndex = 0;
+
+        for (uint32_t i = 0; i < header.numInsts; i++)
+        {
+            Inst inst;
+            Src srcs[MaxLanes];
+            memcpy_s(&inst, sizeof(inst), instPtr, sizeof(inst));
+            instPtr += sizeof(inst);
+            const unsigned numLanes = inst.numLanes;
+            IGC_ASSERT(numLanes >= 1 && numLanes <= MaxLanes);
+            IGC_ASSERT(instPtr + numLanes * sizeof(Src) <= codeEnd);
+            memcpy_s(srcs, sizeof(srcs), instPtr, numLanes * sizeof(Src));
+            instPtr += numLanes * sizeof(Src);
+
+            uint32_t result[MaxLanes] = {};
+            switch (inst.opcode)
             {
-                IGC_ASSERT(false && "parsing bitcode failed");
+            case OP_LOAD_CB:
+                for (unsigned c = 0; c < numLanes; c++)
+                {
+                    memcpy_s(&result[c], sizeof(result[c]),
+                        (char*)CBptr[srcs[c].src0] + srcs[c].src1, sizeof(result[c]));
+                }
+                break;
+            case OP_RESINFO:
+            {
+                unsigned res[4];
+                getResInfoCB(res, srcs[0].src0, srcs[0].src1 & ~RESINFO_UAV_BIT,
+                    (srcs[0].src1 & RESINFO_UAV_BIT) != 0);
+                for (unsigned c = 0; c < 4; c++)
+                {
+                    regs[inst.dst + c] = res[c];
+                }
+                continue;
             }
-            else
+            case OP_OUTPUT:
+                for (unsigned c = 0; c < numLanes; c++)
+                {
+                    pNewCB[newCBIndex++] = (inst.immMask & (SRC0_IMM << c)) ?
+                        srcs[c].src0 : regs[srcs[c].src0];
+                }
+                continue;
+            default:
             {
-                M = ModuleOrErr.get().release();
+                uint32_t a[MaxLanes] = {}, b[MaxLanes] = {};
+                for (unsigned c = 0; c < numLanes; c++)
+                {
+                    a[c] = (inst.immMask & (SRC0_IMM << c)) ? srcs[c].src0 : regs[srcs[c].src0];
+                    b[c] = (inst.immMask & (SRC1_IMM << c)) ? srcs[c].src1 : regs[srcs[c].src1];
+                }
+                evaluateCBLanes((Opcode)inst.opcode, a, b, result);
+                break;
+            }
+            }
+
+            for (unsigned c = 0; c < numLanes; c++)
+            {
+                regs[inst.dst + c] = (inst.flags & RESULT_FLOAT) ? ftou_ftz(utof(result[c])) : result[c];
             }
         }
-        else
-        {
-            IGC_ASSERT(false && "parsing bitcode failed");
-        }
+    }
 
-        // start constant folding
+    static void FoldDerivedConstantModule(
+        llvm::Module* M,
+        void* CBptr[15], const std::function<void(uint[4], uint, uint, bool)>& getResInfoCB,
+        uint* pNewCB)
+    {
         struct ResInfoResult {
             unsigned info[4];
             ResInfoResult() { info[0] = info[1] = info[2] = info[3] = 0; }
@@ -699,145 +1125,287 @@ namespace IGC
             }
             else if (dyn_cast<StoreInst>(inst))
             {
-                pNewCB[newCBIndex] = (uint)(CalculatedValue[inst->getOperand(0)]);
+                pNewCB[newCBIndex] = lookupValue(inst->getOperand(0), CalculatedValue);
                 newCBIndex++;
             }
             else
             {
-                ftod0.u = lookupValue(inst->getOperand(0), CalculatedValue);
-
-                if (CallInst * callI = dyn_cast<CallInst>(inst))
+                CBBytecode::Opcode op;
+                Value* negSrc = nullptr;
+                if (!getCBOpcode(inst, op, negSrc))
                 {
-                    switch (GetOpCode(callI))
-                    {
-                    case llvm_cos:
-                        ftodTemp.f = cosf(ftod0.f);
-                        break;
-                    case llvm_sin:
-                        ftodTemp.f = sinf(ftod0.f);
-                        break;
-                    case llvm_log:
-                        ftodTemp.f = log10f(ftod0.f) / log10f(2.0f);
-                        break;
-                    case llvm_exp:
-                        ftodTemp.f = powf(2.0f, ftod0.f);
-                        break;
-                    case llvm_sqrt:
-                        ftodTemp.f = sqrtf(ftod0.f);
-                        break;
-                    case llvm_floor:
-                        ftodTemp.f = floorf(ftod0.f);
-                        break;
-                    case llvm_ceil:
-                        ftodTemp.f = ceilf(ftod0.f);
-                        break;
-                    case llvm_fabs:
-                        ftodTemp.f = fabs(ftod0.f);
-                        break;
-                    case llvm_pow:
-                        ftod1.u = lookupValue(inst->getOperand(1), CalculatedValue);
-                        ftodTemp.f = powf(ftod0.f, ftod1.f);
-                        break;
-                    case llvm_max:
-                        ftod1.u = lookupValue(inst->getOperand(1), CalculatedValue);
-                        // cannot use std::max since:
-                        //   std::max(Nan, x) = Nan
-                        //   std::max(x, NaN) = x
-                        //   fmax(Nan, x) = x
-                        //   fmax(x, Nan) = x
-                        ftodTemp.f = fmaxf(ftod0.f, ftod1.f);
-                        break;
-                    case llvm_min:
-                        ftod1.u = lookupValue(inst->getOperand(1), CalculatedValue);
-                        ftodTemp.f = fminf(ftod0.f, ftod1.f);
-                        break;
-                    case llvm_rsq:
-                        ftodTemp.f = 1.0f / sqrt(ftod0.f);
-                        break;
-                    case llvm_fsat:
-                        ftodTemp.f = fminf(1.0f, fmaxf(0.0f, ftod0.f));
-                        break;
-                    default:
-                        IGC_ASSERT(0);
-                        break;
-                    }
+                    IGC_ASSERT(0);
+                    continue;
                 }
-                else
-                {
-                    ftod1.u = lookupValue(inst->getOperand(1), CalculatedValue);
 
-                    switch (inst->getOpcode())
-                    {
-                    case Instruction::Add:
-                        ftodTemp.i = ftod0.i + ftod1.i;
-                        break;
-                    case Instruction::FAdd:
-                        ftodTemp.f = ftod0.f + ftod1.f;
-                        break;
-                    case Instruction::Sub:
-                        ftodTemp.i = ftod0.i + ftod1.i;
-                        break;
-                    case Instruction::FSub:
-                        if (ftod0.f == 0.0f && isa<ConstantFP>(inst->getOperand(0)))
-                        {
-                            ftodTemp.f = -ftod1.f;
-                        }
-                        else
-                        {
-                            ftodTemp.f = ftod0.f - ftod1.f;
-                        }
-                        break;
-                    case Instruction::Mul:
-                        ftodTemp.i = ftod0.i * ftod1.i;
-                        break;
-                    case Instruction::FMul:
-                        ftodTemp.f = ftod0.f * ftod1.f;
-                        break;
-                    case Instruction::UDiv:
-                        ftodTemp.u = ftod0.u / ftod1.u;
-                        break;
-                    case Instruction::SDiv:
-                        ftodTemp.i = ftod0.i / ftod1.i;
-                        break;
-                    case Instruction::FDiv:
-                        ftodTemp.f = ftod0.f / ftod1.f;
-                        break;
-                    case Instruction::URem:
-                        ftodTemp.u = ftod0.u % ftod1.u;
-                        break;
-                    case Instruction::SRem:
-                        ftodTemp.i = ftod0.i % ftod1.i;
-                        break;
-                    case Instruction::Shl:
-                        ftodTemp.i = ftod0.i << ftod1.i;
-                        break;
-                    case Instruction::LShr:
-                        ftodTemp.u = ftod0.u >> ftod1.u;
-                        break;
-                    case Instruction::AShr:
-                        ftodTemp.i = (ftod0.i < 0) ?
-                            (-1 * (abs(ftod0.i) >> ftod1.i)) :
-                            ((ftod0.i) >> ftod1.i);
-                        break;
-                    case Instruction::And:
-                        ftodTemp.u = ftod0.u & ftod1.u;
-                        break;
-                    case Instruction::Or:
-                        ftodTemp.u = ftod0.u | ftod1.u;
-                        break;
-                    case Instruction::Xor:
-                        ftodTemp.u = ftod0.u ^ ftod1.u;
-                        break;
-                    default:
-                        IGC_ASSERT(0);
-                        break;
-                    }
-                }
+                uint32_t a = lookupValue(negSrc ? negSrc : inst->getOperand(0), CalculatedValue);
+                uint32_t b = hasSecondCBSource(op) ? lookupValue(inst->getOperand(1), CalculatedValue) : 0;
+                uint32_t result = evaluateCBOp(op, a, b);
 
-                if (inst->getType()->isFloatTy()) {
-                    CalculatedValue[inst] = ftou_ftz(ftodTemp.f);
-                }
+                CalculatedValue[inst] = inst->getType()->isFloatTy() ?
+                    ftou_ftz(utof(result)) : result;
+            }
+        }
+    }
+
+    void FoldDerivedConstant(
+        char* bitcode, uint bitcodeSize,
+        void* CBptr[15], std::function<void(uint[4], uint, uint, bool)> getResInfoCB,
+        uint* pNewCB)
+    {
+        // compact bytecode emitted by GenUpdateCB
+        uint32_t magic = 0;
+        if (bitcodeSize >= sizeof(CBBytecode::Header))
+        {
+            memcpy_s(&magic, sizeof(magic), bitcode, sizeof(magic));
+        }
+        if (magic == CBBytecode::Magic)
+        {
+            FoldDerivedConstantBytecode(bitcode, bitcodeSize, CBptr, getResInfoCB, pNewCB);
+            return;
+        }
+
+        // load module from memory
+        std::unique_ptr<llvm::Module> M;
+
+        llvm::StringRef bitRef(bitcode, bitcodeSize);
+        std::unique_ptr<llvm::MemoryBuffer> bitcodeMem =
+            llvm::MemoryBuffer::getMemBuffer(bitRef, "", /* Null Term  = */ false);
+
+        bool isBitCode = llvm::isBitcode(
+            (const unsigned char*)bitcodeMem->getBufferStart(),
+            (const unsigned char*)bitcodeMem->getBufferEnd());
+
+        LLVMContextWrapper context;
+        if (isBitCode)
+        {
+            llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+                llvm::parseBitcodeFile(bitcodeMem->getMemBufferRef(), context);
+
+            if (llvm::Error EC = ModuleOrErr.takeError())
+            {
+                IGC_ASSERT(false && "parsing bitcode failed");
+            }
+            else
+            {
+                M = std::move(ModuleOrErr.get());
+            }
+        }
+        else
+        {
+            IGC_ASSERT(false && "parsing bitcode failed");
+        }
+
+        if (M)
+        {
+            FoldDerivedConstantModule(M.get(), CBptr, getResInfoCB, pNewCB);
+        }
+    }
+}
+
+
+// Deterministic constant buffer contents and resinfo results for folding a
+// mini-shader outside the driver.
+static void fillSyntheticCB(Module* M, std::vector<uint32_t> cbData[15], void* CBptr[15])
+{
+    uint32_t cbSize[15] = {};
+    BasicBlock* BB = &M->getFunctionList().begin()->getEntryBlock();
+    for (auto& I : *BB)
+    {
+        if (LoadInst* ld = dyn_cast<LoadInst>(&I))
+        {
+            bool directBuf;
+            unsigned bufId;
+            IGC::DecodeAS4GFXResource(ld->getPointerAddressSpace(), directBuf, bufId);
+            uint32_t end = (uint32_t)IGC::getConstantBufferLoadOffset(ld) + (uint32_t)sizeof(uint32_t);
+            if (bufId < 15)
+            {
+                cbSize[bufId] = std::max(cbSize[bufId], end);
             }
         }
     }
+
+    for (unsigned bufId = 0; bufId < 15; bufId++)
+    {
+        cbData[bufId].resize(iSTD::Align(cbSize[bufId], sizeof(uint32_t)) / sizeof(uint32_t));
+        for (unsigned i = 0; i < cbData[bufId].size(); i++)
+        {
+            cbData[bufId][i] = ftou(1.0f + 0.25f * (float)(bufId * 64 + i));
+        }
+        CBptr[bufId] = cbData[bufId].data();
+    }
+}
+
+static void getSyntheticResInfo(uint res[4], uint texId, uint lod, bool isUAV)
+{
+    for (uint c = 0; c < 4; c++)
+    {
+        res[c] = ((1024 + texId) >> lod) + c + (isUAV ? 7 : 0);
+    }
+}
+
+// Reference fold of the LLVM mini-shader. It does not share evaluateCBLanes with
+// the driver-side evaluators: instructions and LLVM intrinsics go through
+// LLVM's constant folder, and only the GenISA intrinsics it does not know are
+// computed here. Results the IR leaves undefined (division by zero, shifts by
+// the bit width or more) fold to undef/poison or to nullptr.
+static void FoldDerivedConstantReference(
+    Module* M, void* CBptr[15], SmallVectorImpl<Constant*>& outputs)
+{
+    const DataLayout& DL = M->getDataLayout();
+    Type* int32Ty = Type::getInt32Ty(M->getContext());
+    DenseMap<Value*, Constant*> values;
+
+    auto lookup = [&](Value* V) -> Constant*
+    {
+        if (Constant* C = dyn_cast<Constant>(V))
+            return C;
+        return values.lookup(V);
+    };
+    // the hardware flushes float denormals produced by the mini-shader
+    auto flushDenorm = [](Constant* C) -> Constant*
+    {
+        ConstantFP* CF = dyn_cast_or_null<ConstantFP>(C);
+        if (CF && CF->getValueAPF().isDenormal())
+            return ConstantFP::get(CF->getType(), CF->isNegative() ? -0.0 : 0.0);
+        return C;
+    };
+
+    BasicBlock* BB = &M->getFunctionList().begin()->getEntryBlock();
+    for (auto& I : *BB)
+    {
+        Instruction* inst = &I;
+        unsigned texId = 0, lod = 0;
+        bool isUAV = false;
+
+        if (isa<AllocaInst>(inst) || isa<ReturnInst>(inst))
+        {
+            continue;
+        }
+        else if (LoadInst* ld = dyn_cast<LoadInst>(inst))
+        {
+            bool directBuf;
+            unsigned bufId;
+            IGC::DecodeAS4GFXResource(ld->getPointerAddressSpace(), directBuf, bufId);
+            uint32_t bits = 0;
+            memcpy_s(&bits, sizeof(bits), (char*)CBptr[bufId] + IGC::getConstantBufferLoadOffset(ld), sizeof(bits));
+            values[ld] = flushDenorm(ConstantExpr::getBitCast(ConstantInt::get(int32Ty, bits), ld->getType()));
+        }
+        else if (isResInfo(dyn_cast<GenIntrinsicInst>(inst), texId, lod, isUAV))
+        {
+            uint res[4];
+            getSyntheticResInfo(res, texId, lod, isUAV);
+            uint32_t channels[4] = { res[0], res[1], res[2], res[3] };
+            values[inst] = ConstantExpr::getBitCast(
+                ConstantDataVector::get(M->getContext(), channels), inst->getType());
+        }
+        else if (StoreInst* st = dyn_cast<StoreInst>(inst))
+        {
+            outputs.push_back(lookup(st->getValueOperand()));
+        }
+        else
+        {
+            SmallVector<Constant*, 4> ops;
+            for (Value* op : inst->operands())
+            {
+                ops.push_back(lookup(op));
+            }
+            if (llvm::is_contained(ops, nullptr))
+            {
+                values[inst] = nullptr;
+                continue;
+            }
+
+            Constant* C = nullptr;
+            ConstantFP* src = dyn_cast<ConstantFP>(ops[0]);
+            switch (GetOpCode(inst))
+            {
+            case llvm_rsq:
+                if (src)
+                    C = ConstantFP::get(inst->getType(), 1.0 / sqrt(src->getValueAPF().convertToFloat()));
+                break;
+            case llvm_fsat:
+                if (src)
+                    C = ConstantFP::get(inst->getContext(),
+                        minnum(APFloat(1.0f), maxnum(APFloat(0.0f), src->getValueAPF())));
+                break;
+            default:
+                C = ConstantFoldInstOperands(inst, ops, DL);
+                break;
+            }
+            values[inst] = flushDenorm(C);
+        }
+    }
+}
+
+// Fold the mini-shader with synthetic constant buffers and resinfo results
+// through the encoded bytecode and through LLVM's constant folder, and check
+// that they agree. Transcendental functions are folded in double precision by
+// LLVM and in single precision by the driver, so float results only have to
+// match to a relative 1e-5.
+void GenUpdateCB::VerifyBytecode(Module* M, const SmallVectorImpl<char>& code, uint numOutputs)
+{
+    std::vector<uint32_t> cbData[15];
+    void* CBptr[15] = {};
+    fillSyntheticCB(M, cbData, CBptr);
+
+    std::vector<uint> fromCode(numOutputs, 0);
+    SmallVector<Constant*, 16> expected;
+    FoldDerivedConstant(const_cast<char*>(code.data()), code.size(), CBptr, getSyntheticResInfo, fromCode.data());
+    FoldDerivedConstantReference(M, CBptr, expected);
+    IGC_ASSERT(expected.size() == numOutputs);
+
+    for (uint i = 0; i < numOutputs && i < expected.size(); i++)
+    {
+        Constant* C = expected[i];
+        bool match = true;
+        if (ConstantInt* CI = dyn_cast_or_null<ConstantInt>(C))
+        {
+            match = (uint32_t)CI->getZExtValue() == fromCode[i];
+        }
+        else if (ConstantFP* CF = dyn_cast_or_null<ConstantFP>(C))
+        {
+            float ref = CF->getValueAPF().convertToFloat();
+            float got = utof(fromCode[i]);
+            match = ref == got || (std::isnan(ref) && std::isnan(got)) ||
+                fabsf(ref - got) <= 1e-5f * std::max(fabsf(ref), fabsf(got));
+        }
+        IGC_ASSERT_MESSAGE(match, "GenUpdateCB bytecode does not match LLVM constant folding");
+    }
+}
+
+bool GenUpdateCBEvaluate::runOnModule(Module& M)
+{
+    // encode the module as GenUpdateCB would ship it
+    SmallVector<char, 256> code;
+    if (!GenUpdateCB::EncodeBytecode(&M, code))
+    {
+        code.clear();
+        raw_svector_ostream bitcodeSS(code);
+        IGCLLVM::WriteBitcodeToFile(&M, bitcodeSS);
+    }
+
+    SmallVector<StoreInst*, 16> outputs;
+    BasicBlock* BB = &M.getFunctionList().begin()->getEntryBlock();
+    for (auto& I : *BB)
+    {
+        if (StoreInst* st = dyn_cast<StoreInst>(&I))
+        {
+            outputs.push_back(st);
+        }
+    }
+
+    std::vector<uint32_t> cbData[15];
+    void* CBptr[15] = {};
+    fillSyntheticCB(&M, cbData, CBptr);
+    std::vector<uint> folded(outputs.size(), 0);
+    FoldDerivedConstant(code.data(), code.size(), CBptr, getSyntheticResInfo, folded.data());
+
+    Type* int32Ty = Type::getInt32Ty(M.getContext());
+    for (unsigned i = 0; i < outputs.size(); i++)
+    {
+        Type* ty = outputs[i]->getValueOperand()->getType();
+        outputs[i]->setOperand(0, ConstantExpr::getBitCast(ConstantInt::get(int32Ty, folded[i]), ty));
+    }
+    return !outputs.empty();
 }
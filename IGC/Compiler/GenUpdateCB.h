@@ -39,9 +39,75 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 
 void initializeGenUpdateCBPass(llvm::PassRegistry&);
+void initializeGenUpdateCBEvaluatePass(llvm::PassRegistry&);
 
 namespace IGC
 {
+    // Compact encoding of the CB mini-shader that FoldDerivedConstant() can
+    // evaluate without parsing LLVM bitcode.  The stream is a Header followed
+    // by numInsts Inst records, each followed by numLanes Src records.  Every
+    // value lives in a 32-bit register.  An Inst applies its opcode to up to
+    // MaxLanes independent lanes, lane c writing register dst + c, so the
+    // evaluator dispatches once per vec4 of scalar operations.  Register
+    // indices and immediates share the src fields and are told apart by the
+    // per-lane SRC*_IMM bits of immMask.
+    namespace CBBytecode
+    {
+        const uint32_t Magic = 0x43424243; // "CBBC"
+        const uint16_t Version = 2;
+        const unsigned MaxLanes = 4;
+
+        enum Opcode : uint8_t
+        {
+            OP_LOAD_CB,     // dst = CB[src0] at byte offset src1
+            OP_RESINFO,     // dst..dst+3 = resinfo(tex src0, lod src1 & ~UAV_BIT), one lane
+            OP_OUTPUT,      // pNewCB[next] = src0
+            OP_FNEG,
+            OP_ADD, OP_FADD, OP_SUB, OP_FSUB, OP_MUL, OP_FMUL,
+            OP_UDIV, OP_SDIV, OP_FDIV, OP_UREM, OP_SREM,
+            OP_SHL, OP_LSHR, OP_ASHR, OP_AND, OP_OR, OP_XOR,
+            OP_COS, OP_SIN, OP_LOG, OP_EXP, OP_SQRT, OP_FLOOR, OP_CEIL,
+            OP_FABS, OP_POW, OP_MAX, OP_MIN, OP_RSQ, OP_FSAT,
+        };
+
+        enum Flags : uint8_t
+        {
+            RESULT_FLOAT = 1 << 0, // flush denormal results to zero
+        };
+
+        // Shifted left by the lane index
+        enum ImmMask : uint8_t
+        {
+            SRC0_IMM = 1 << 0,
+            SRC1_IMM = 1 << MaxLanes,
+        };
+
+        const uint32_t RESINFO_UAV_BIT = 1u << 31;
+
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t numRegs;
+            uint32_t numInsts;
+        };
+
+        struct Inst
+        {
+            uint8_t  opcode;
+            uint8_t  flags;
+            uint8_t  numLanes;
+            uint8_t  immMask;
+            uint16_t dst;
+            uint16_t reserved;
+        };
+
+        struct Src
+        {
+            uint32_t src0;
+            uint32_t src1;
+        };
+    }
 
     class GenUpdateCB : public llvm::FunctionPass
     {
@@ -59,6 +125,11 @@ namespace IGC
             AU.addRequired<CodeGenContextWrapper>();
             AU.addRequired<llvm::DominatorTreeWrapperPass>();
         }
+
+        // Lower the CB mini-shader module M to CBBytecode.
+        static bool EncodeBytecode(llvm::Module* M, llvm::SmallVectorImpl<char>& code);
+        // Check the bytecode against LLVM's constant folding of M.
+        static void VerifyBytecode(llvm::Module* M, const llvm::SmallVectorImpl<char>& code, uint numOutputs);
     private:
         bool isConstantBufferLoad(llvm::LoadInst* inst, unsigned& bufId);
 
@@ -81,6 +152,21 @@ namespace IGC
         uint m_ConstantBufferUsageMask = 0;
         uint m_maxCBcases = 128;
     };
+
+    // Test hook for igc_opt: treats the module as a CB mini-shader, folds it
+    // through FoldDerivedConstant the way the driver does, and replaces every
+    // stored value with the folded result.
+    class GenUpdateCBEvaluate : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+        GenUpdateCBEvaluate() : llvm::ModulePass(ID)
+        {
+            initializeGenUpdateCBEvaluatePass(*llvm::PassRegistry::getPassRegistry());
+        }
+        virtual llvm::StringRef getPassName() const { return "GenUpdateCBEvaluate"; }
+        virtual bool runOnModule(llvm::Module& M);
+    };
 }
 
 #endif
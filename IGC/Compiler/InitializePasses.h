@@ -65,12 +65,14 @@ void initializeGenSpecificPatternPass(llvm::PassRegistry&);
 void initializeGreedyLiveRangeReductionPass(llvm::PassRegistry&);
 void initializeIGCIndirectICBPropagaionPass(llvm::PassRegistry&);
 void initializeGenUpdateCBPass(llvm::PassRegistry&);
+void initializeGenUpdateCBEvaluatePass(llvm::PassRegistry&);
 void initializeGenStrengthReductionPass(llvm::PassRegistry&);
 void initializeNanHandlingPass(llvm::PassRegistry&);
 void initializeFlattenSmallSwitchPass(llvm::PassRegistry&);
 void initializeGenXFunctionGroupAnalysisPass(llvm::PassRegistry&);
 void initializeGenXCodeGenModulePass(llvm::PassRegistry&);
 void initializeEstimateFunctionSizePass(llvm::PassRegistry&);
+void initializeDeduplicateFunctionsPass(llvm::PassRegistry&);
 void initializeSubroutineInlinerPass(llvm::PassRegistry&);
 void initializeHandleLoadStoreInstructionsPass(llvm::PassRegistry&);
 void initializeIGCConstPropPass(llvm::PassRegistry&);
@@ -102,6 +104,7 @@ void initializeScalarizerCodeGenPass(llvm::PassRegistry&);
 void initializeReduceLocalPointersPass(llvm::PassRegistry&);
 void initializeReplaceUnsupportedIntrinsicsPass(llvm::PassRegistry&);
 void initializePreCompiledFuncImportPass(llvm::PassRegistry&);
+void initializePrintKernelFingerprintsPass(llvm::PassRegistry&);
 void initializePurgeMetaDataUtilsPass(llvm::PassRegistry&);
 void initializeResolveAggregateArgumentsPass(llvm::PassRegistry&);
 void initializeResolveOCLAtomicsPass(llvm::PassRegistry&);
@@ -110,7 +113,9 @@ void initializeScalarizeFunctionPass(llvm::PassRegistry&);
 void initializeSimd32ProfitabilityAnalysisPass(llvm::PassRegistry&);
 void initializeSetFastMathFlagsPass(llvm::PassRegistry&);
 void initializeSPIRMetaDataTranslationPass(llvm::PassRegistry&);
+void initializeSerializeModuleMetaDataPass(llvm::PassRegistry&);
 void initializeSubGroupFuncsResolutionPass(llvm::PassRegistry&);
+void initializeSpecializeSPIRVConstantsPass(llvm::PassRegistry&);
 void initializeIndirectCallOptimizationPass(llvm::PassRegistry&);
 void initializeVectorPreProcessPass(llvm::PassRegistry&);
 void initializeVectorProcessPass(llvm::PassRegistry&);
@@ -60,22 +60,20 @@ bool PurgeMetaDataUtils::runOnModule(Module& M)
     CodeGenContext* pContext = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
     IGCMD::MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
 
-    auto shouldRemoveFunction = [=](llvm::Module* M, void* ptr)
+    // Metadata may still refer to functions that were removed already, so
+    // look keys up against the functions that are actually in the module.
+    // Scanning the function list per entry is quadratic in the number of
+    // kernels.
+    SmallPtrSet<llvm::Function*, 32> ModuleFuncs;
+    for (auto& G : M)
     {
-        llvm::Function* F = nullptr;
-
-        // Function may have been removed already.
-        for (auto& G : M->getFunctionList())
-        {
-            if (&G == ptr)
-            {
-                F = &G;
-                break;
-            }
-        }
+        ModuleFuncs.insert(&G);
+    }
 
+    auto shouldRemoveFunction = [&](llvm::Function* F)
+    {
         // Already deleted, or not used non-kernels.
-        if (F == nullptr)
+        if (!ModuleFuncs.count(F))
         {
             return true;
         }
@@ -97,6 +95,7 @@ bool PurgeMetaDataUtils::runOnModule(Module& M)
                 return false;
             }
 
+            ModuleFuncs.erase(F);
             F->eraseFromParent();
             return true;
         }
@@ -111,7 +110,7 @@ bool PurgeMetaDataUtils::runOnModule(Module& M)
     auto checkFuncRange = [&](auto beginIt, auto endIt) {
         for (auto it = beginIt, e = endIt; it != e; ++it)
         {
-            if (shouldRemoveFunction(pContext->getModule(), it->first))
+            if (shouldRemoveFunction(it->first))
             {
                 ToBeDeleted.insert(it->first);
             }
@@ -42,6 +42,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/Optimizer/PreCompiledFuncImport.hpp"
 #include "Compiler/Optimizer/PreCompiledFuncLibrary.cpp"
 #include "Probe/Assertion.h"
+#include <mutex>
 // No Support to double emulation.
 const unsigned char igcbuiltin_emu_dp_add_sub[] = { 0 };
 const unsigned char igcbuiltin_emu_dp_fma_mul[] = { 0 };
@@ -161,6 +162,39 @@ const LibraryModuleInfo PreCompiledFuncImport::m_libModInfos[NUM_LIBMODS] =
     /* LIBMOD_SP_DIV      */   { igcbuiltin_emu_sp_div, sizeof(igcbuiltin_emu_sp_div) }
 };
 
+// The library modules are immutable, so the layout of their bitcode (the
+// module block and the per-function body offsets) is scanned once per process
+// and shared by all compilations. Each compilation then only materializes the
+// function bodies it links in.
+static llvm::BitcodeModule* getLibraryBitcodeModule(
+    const LibraryModuleInfo& LibInfo, int LibModID)
+{
+    static std::mutex CacheMutex;
+    static llvm::Optional<llvm::BitcodeModule>
+        Cache[PreCompiledFuncImport::NUM_LIBMODS];
+
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    if (!Cache[LibModID])
+    {
+        StringRef BitRef((const char*)LibInfo.Mod, LibInfo.ModSize);
+        llvm::Expected<std::vector<llvm::BitcodeModule>> BMsOrErr =
+            llvm::getBitcodeModuleList(MemoryBufferRef(BitRef, ""));
+        if (llvm::Error EC = BMsOrErr.takeError())
+        {
+            llvm::consumeError(std::move(EC));
+            IGC_ASSERT(false && "llvm getBitcodeModuleList - FAILED to parse bitcode");
+            return nullptr;
+        }
+        if (BMsOrErr->size() != 1)
+        {
+            IGC_ASSERT(false && "expect a single module per library");
+            return nullptr;
+        }
+        Cache[LibModID].emplace(BMsOrErr->front());
+    }
+    return Cache[LibModID].getPointer();
+}
+
 // This function scans intructions before emulation. It converts double-related
 // operations (intrinsics, instructions) into ones that can be emulated. It has:
 //   1. Intrinsics
@@ -351,7 +385,6 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
 
     for (int i = 0; i < NUM_LIBMODS; ++i) {
         m_libModuleToBeImported[i] = false;
-        m_libModuleAlreadyImported[i] = false;
     }
 
     SmallSet<Function*, 32> origFunctions;
@@ -377,29 +410,26 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
 
         if (m_changed)
         {
-            llvm::Linker ld(M);
             for (int i = 0; i < NUM_LIBMODS; ++i)
             {
                 if (!m_libModuleToBeImported[i]) {
                     continue;
                 }
 
-                if (m_libModuleAlreadyImported[i])
+                llvm::BitcodeModule* pLibBitcode =
+                    getLibraryBitcodeModule(m_libModInfos[i], i);
+                if (!pLibBitcode)
                     continue;
 
-                const char* pLibraryModule = (const char*)m_libModInfos[i].Mod;
-                uint32_t libSize = m_libModInfos[i].ModSize;
-
-                // Load the module we want to compile and link it to existing module
-                //StringRef BitRef((char*)preCompiledFunctionLibrary, preCompiledFunctionLibrarySize);
-                StringRef BitRef(pLibraryModule, libSize);
-                //llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                //    llvm::getLazyBitcodeModule(MemoryBufferRef(BitRef.str(), ""), M.getContext());
+                // Load the module lazily: only the prototypes are read here, the
+                // function bodies are materialized by the linker on demand.
                 llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    llvm::parseBitcodeFile(MemoryBufferRef(BitRef.str(), ""), M.getContext());
+                    pLibBitcode->getLazyModule(M.getContext(), false, false);
                 if (llvm::Error EC = ModuleOrErr.takeError())
                 {
-                    IGC_ASSERT(false && "llvm getLazyBitcodeModule - FAILED to parse bitcode");
+                    llvm::consumeError(std::move(EC));
+                    IGC_ASSERT(false && "llvm getLazyModule - FAILED to parse bitcode");
+                    continue;
                 }
                 std::unique_ptr<llvm::Module> m_pBuiltinModule = std::move(*ModuleOrErr);
                 IGC_ASSERT(m_pBuiltinModule && "llvm version mismatch - could not load llvm module");
@@ -409,14 +439,15 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
                 m_pBuiltinModule->setDataLayout(M.getDataLayout());
                 m_pBuiltinModule->setTargetTriple(M.getTargetTriple());
 
-                // Linking the two modules
+                // Linking the two modules. Only the functions declared in M (and
+                // what they use) are imported; a library module needed again in
+                // the second iteration just adds the newly declared ones.
                 llvm::Linker ld(M);
 
-                if (ld.linkInModule(std::move(m_pBuiltinModule)))
+                if (ld.linkInModule(std::move(m_pBuiltinModule), llvm::Linker::LinkOnlyNeeded))
                 {
                     IGC_ASSERT(false && "Error linking the two modules");
                 }
-                m_libModuleAlreadyImported[i] = true;
                 m_pBuiltinModule = nullptr;
             }
         }
@@ -0,0 +1,74 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "Compiler/SerializeModuleMetaData.h"
+#include "Compiler/IGCPassSupport.h"
+#include "common/MDFrameWork.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CommandLine.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+static cl::opt<bool> ReadableModuleMetaData(
+    "igc-readable-module-metadata", cl::init(false), cl::Hidden,
+    cl::desc("Write ModuleMetaData one MDNode per field instead of as a blob"));
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-serialize-module-metadata"
+#define PASS_DESCRIPTION "Rewrite ModuleMetaData in the blob or the readable form"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(SerializeModuleMetaData, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_END(SerializeModuleMetaData, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+#undef PASS_ANALYSIS
+#undef PASS_CFG_ONLY
+#undef PASS_DESCRIPTION
+#undef PASS_FLAG
+
+char SerializeModuleMetaData::ID = 0;
+
+SerializeModuleMetaData::SerializeModuleMetaData() : ModulePass(ID)
+{
+    initializeSerializeModuleMetaDataPass(*PassRegistry::getPassRegistry());
+}
+
+bool SerializeModuleMetaData::runOnModule(llvm::Module &M)
+{
+    ModuleMetaData modMD;
+    if (!deserialize(modMD, &M))
+    {
+        M.getContext().emitError("ModuleMetaData blob was written by a different compiler "
+            "(header or layout mismatch)");
+        return false;
+    }
+    serialize(modMD, &M, ReadableModuleMetaData);
+    return true;
+}
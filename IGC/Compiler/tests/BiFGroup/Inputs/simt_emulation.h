@@ -0,0 +1,333 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Host emulation of the sub-group and work-group builtins used by
+// BiFModule/Implementation/include/group_collectives.cl.
+//
+// Every work-item runs on its own thread. Sub-group builtins rendezvous with
+// the other work-items of the same sub-group that are currently active, so
+// shuffles and ballots see exactly the values the channels hold at that point
+// of the program; work-group barriers rendezvous with the whole work-group.
+
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+typedef unsigned char  uchar;
+typedef signed char    schar;
+typedef unsigned short ushort;
+typedef unsigned int   uint;
+typedef uint64_t       ulong;
+typedef int64_t        slong;
+
+struct uint3 { uint s0, s1, s2; };
+struct uint4 { uint s0, s1, s2, s3; };
+
+enum { CrossDevice = 0, Device = 1, Workgroup = 2, Subgroup = 3, Invocation = 4 };
+enum { AcquireRelease = 0x8, SubgroupMemory = 0x80, WorkgroupMemory = 0x100 };
+enum
+{
+    GroupOperationReduce = 0,
+    GroupOperationInclusiveScan = 1,
+    GroupOperationExclusiveScan = 2,
+    GroupOperationClusteredReduce = 3
+};
+
+namespace simt
+{
+    const uint kMaxLanes = 32;
+    typedef std::array<uint64_t, kMaxLanes> LaneValues;
+
+    // Lets a known set of threads swap one value each and wait for each other.
+    class Rendezvous
+    {
+    public:
+        LaneValues exchange(uint group, uint mask, uint lane, uint participants, uint64_t value)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            Slot& slot = m_slots[std::make_pair(group, mask)];
+            uint64_t generation = slot.generation;
+            slot.pending[lane % kMaxLanes] = value;
+            if (++slot.arrived == participants)
+            {
+                slot.arrived = 0;
+                slot.published = slot.pending;
+                slot.generation++;
+                m_cv.notify_all();
+            }
+            else
+            {
+                m_cv.wait(lock, [&] { return slot.generation != generation; });
+            }
+            return slot.published;
+        }
+
+    private:
+        struct Slot
+        {
+            LaneValues pending = {};
+            LaneValues published = {};
+            uint arrived = 0;
+            uint64_t generation = 0;
+        };
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::map<std::pair<uint, uint>, Slot> m_slots;
+    };
+
+    struct WorkItem
+    {
+        Rendezvous* rendezvous;
+        uint wgSize;
+        uint numsg;
+        uint sgmax;
+        uint sgid;
+        uint sglid;
+        uint sgsize;
+        // Channels of this sub-group executing the current instruction.
+        uint active;
+    };
+
+    inline thread_local WorkItem tl;
+    alignas(16) inline unsigned char slm[64 * 1024];
+
+    inline uint popcount(uint v)
+    {
+        uint n = 0;
+        for (; v; v &= v - 1)
+            n++;
+        return n;
+    }
+    inline uint laneMask(uint n) { return n >= 32 ? 0xFFFFFFFFu : ((1u << n) - 1); }
+
+    template <typename T>
+    uint64_t toBits(T v)
+    {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(T));
+        return bits;
+    }
+
+    template <typename T>
+    T fromBits(uint64_t bits)
+    {
+        T v;
+        std::memcpy(&v, &bits, sizeof(T));
+        return v;
+    }
+
+    template <typename T>
+    LaneValues exchange(T v)
+    {
+        return tl.rendezvous->exchange(tl.sgid, tl.active, tl.sglid, popcount(tl.active), toBits(v));
+    }
+
+    // Runs body on every work-item of a work-group of wgSize items, split in
+    // sub-groups of at most sgmax channels.
+    inline void runWorkGroup(uint wgSize, uint sgmax, const std::function<void(uint)>& body)
+    {
+        Rendezvous rendezvous;
+        uint numsg = (wgSize + sgmax - 1) / sgmax;
+        std::vector<std::thread> threads;
+        for (uint lid = 0; lid < wgSize; lid++)
+        {
+            threads.emplace_back([&, lid] {
+                uint sgid = lid / sgmax;
+                uint sgsize = sgid + 1 < numsg ? sgmax : wgSize - sgid * sgmax;
+                tl = WorkItem{ &rendezvous, wgSize, numsg, sgmax, sgid, lid % sgmax, sgsize, laneMask(sgsize) };
+                body(lid);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // Runs body on the channels of activeMask in a single sub-group of sgsize
+    // channels, as if the other channels had branched around the call.
+    inline void runSubGroup(uint sgsize, uint sgmax, uint activeMask, const std::function<void(uint)>& body)
+    {
+        Rendezvous rendezvous;
+        std::vector<std::thread> threads;
+        for (uint lane = 0; lane < sgsize; lane++)
+        {
+            if ((activeMask & (1u << lane)) == 0)
+                continue;
+            threads.emplace_back([&, lane] {
+                tl = WorkItem{ &rendezvous, sgsize, 1, sgmax, 0, lane, sgsize, activeMask };
+                body(lane);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+    }
+} // namespace simt
+
+#define GET_MEMPOOL_PTR(_ptr, _type, _allocAllWorkgroups, _additionalElems) \
+    _type* _ptr = (_type*)simt::slm;
+
+inline uint __builtin_spirv_BuiltInSubgroupId() { return simt::tl.sgid; }
+inline uint __builtin_spirv_BuiltInNumSubgroups() { return simt::tl.numsg; }
+inline uint __builtin_spirv_BuiltInSubgroupLocalInvocationId() { return simt::tl.sglid; }
+inline uint __builtin_spirv_BuiltInSubgroupMaxSize() { return simt::tl.sgmax; }
+inline uint __builtin_spirv_BuiltInSubgroupSize() { return simt::tl.sgsize; }
+
+inline uint __builtin_spirv_OpenCL_clz_i32(uint v)
+{
+    uint n = 0;
+    for (uint bit = 1u << 31; bit && !(v & bit); bit >>= 1)
+        n++;
+    return n;
+}
+
+inline uint __builtin_spirv_OpenCL_ctz_i32(uint v)
+{
+    uint n = 0;
+    for (uint bit = 1; bit && !(v & bit); bit <<= 1)
+        n++;
+    return n;
+}
+inline uint __builtin_spirv_OpenCL_popcount_i32(uint v) { return simt::popcount(v); }
+
+inline void __builtin_spirv_OpControlBarrier_i32_i32_i32(uint scope, uint, uint)
+{
+    if (scope == Workgroup)
+        simt::tl.rendezvous->exchange(~0u, 0, 0, simt::tl.wgSize, 0);
+    else
+        simt::exchange(0);
+}
+
+template <typename T>
+T intel_sub_group_shuffle(T x, uint c)
+{
+    simt::LaneValues values = simt::exchange(x);
+    return c < simt::kMaxLanes ? simt::fromBits<T>(values[c]) : T();
+}
+
+template <typename T>
+T sub_group_shuffle(T x, uint c)
+{
+    return intel_sub_group_shuffle(x, c);
+}
+
+template <typename T>
+T intel_sub_group_shuffle_up(T prev, T cur, uint delta)
+{
+    simt::LaneValues prevValues = simt::exchange(prev);
+    simt::LaneValues curValues = simt::exchange(cur);
+    uint sglid = simt::tl.sglid;
+    if (delta <= sglid)
+        return simt::fromBits<T>(curValues[sglid - delta]);
+    uint c = simt::tl.sgmax + sglid - delta;
+    return c < simt::kMaxLanes ? simt::fromBits<T>(prevValues[c]) : T();
+}
+
+inline uint __builtin_IB_WaveBallot(bool p)
+{
+    simt::LaneValues values = simt::exchange(p);
+    uint ballot = 0;
+    for (uint i = 0; i < simt::kMaxLanes; i++)
+    {
+        if ((simt::tl.active & (1u << i)) && values[i])
+            ballot |= 1u << i;
+    }
+    return ballot;
+}
+
+// The only divergent region in the collectives is guarded by an inverse
+// ballot: the channels it selects are the ones that execute the guarded block.
+inline uint __builtin_spirv_OpGroupNonUniformInverseBallot_i32_v4i32(uint, uint ballot)
+{
+    bool selected = (ballot & (1u << simt::tl.sglid)) != 0;
+    if (selected)
+        simt::tl.active = ballot;
+    return selected;
+}
+
+// GCC does not mangle functions named __builtin_*, so the broadcasts for the
+// different types of one width cannot be template instantiations; they are
+// macros that expand to the shuffle instead.
+#define __builtin_spirv_OpGroupBroadcast_i32_i1_v3i32(scope, x, localId)  intel_sub_group_shuffle(x, (localId).s0)
+#define __builtin_spirv_OpGroupBroadcast_i32_i8_v3i32(scope, x, localId)  intel_sub_group_shuffle(x, (localId).s0)
+#define __builtin_spirv_OpGroupBroadcast_i32_i16_v3i32(scope, x, localId) intel_sub_group_shuffle(x, (localId).s0)
+#define __builtin_spirv_OpGroupBroadcast_i32_i32_v3i32(scope, x, localId) intel_sub_group_shuffle(x, (localId).s0)
+#define __builtin_spirv_OpGroupBroadcast_i32_i64_v3i32(scope, x, localId) intel_sub_group_shuffle(x, (localId).s0)
+#define __builtin_spirv_OpGroupBroadcast_i32_f32_v3i32(scope, x, localId) intel_sub_group_shuffle(x, (localId).s0)
+#define __builtin_spirv_OpGroupBroadcast_i32_f64_v3i32(scope, x, localId) intel_sub_group_shuffle(x, (localId).s0)
+
+namespace simt
+{
+    // Stand-ins for the native sub-group reduce and exclusive scan that
+    // GenISA_WaveAll and GenISA_WavePrefix provide on the device.
+    template <typename T, typename Op>
+    T nativeReduce(Op op, T identity, T x)
+    {
+        LaneValues values = exchange(x);
+        T result = identity;
+        for (uint i = 0; i < kMaxLanes; i++)
+        {
+            if (tl.active & (1u << i))
+                result = op(result, fromBits<T>(values[i]));
+        }
+        return result;
+    }
+
+    template <typename T, typename Op>
+    T nativeExclusiveScan(Op op, T identity, T x)
+    {
+        LaneValues values = exchange(x);
+        T result = identity;
+        for (uint i = 0; i < tl.sglid; i++)
+        {
+            if (tl.active & (1u << i))
+                result = op(result, fromBits<T>(values[i]));
+        }
+        return result;
+    }
+} // namespace simt
+
+template <typename T> T __intel_add(T a, T b) { return (T)(a + b); }
+template <typename T> T __intel_mul(T a, T b) { return (T)(a * b); }
+template <typename T> T __intel_and(T a, T b) { return (T)(a & b); }
+template <typename T> T __intel_or(T a, T b)  { return (T)(a | b); }
+template <typename T> T __intel_xor(T a, T b) { return (T)(a ^ b); }
+template <typename T> T __intel_min(T a, T b) { return b < a ? b : a; }
+template <typename T> T __intel_max(T a, T b) { return a < b ? b : a; }
+inline float  __intel_min(float a, float b)   { return std::fmin(a, b); }
+inline float  __intel_max(float a, float b)   { return std::fmax(a, b); }
+inline double __intel_min(double a, double b) { return std::fmin(a, b); }
+inline double __intel_max(double a, double b) { return std::fmax(a, b); }
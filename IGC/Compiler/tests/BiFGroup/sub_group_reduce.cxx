@@ -0,0 +1,302 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Sub-group reduce emulation (DEFN_SUB_GROUP_REDUCE), its non-uniform variant
+// and clustered reduce, for every type and operation of the non-uniform
+// arithmetic builtins. Sub-groups include power-of-two, non-power-of-two and
+// partial ones, and non-uniform calls run with only some channels active.
+// half is not covered, as the host has no portable half type.
+//
+// RUN: %host_cxx -std=c++17 -pthread -I %S/Inputs -I %S/../../../BiFModule/Implementation %s -o %t
+// RUN: %t | FileCheck %s
+
+#include "simt_emulation.h"
+#include "include/group_collectives.cl"
+
+#include <cstdio>
+#include <type_traits>
+
+// CHECK: reduce sgsize=1 simd=8: 47 ok
+// CHECK: reduce sgsize=2 simd=8: 47 ok
+// CHECK: reduce sgsize=8 simd=8: 47 ok
+// CHECK: reduce sgsize=16 simd=16: 47 ok
+// CHECK: reduce sgsize=32 simd=32: 47 ok
+// CHECK: reduce sgsize=4 simd=16: 47 ok
+// CHECK: reduce sgsize=3 simd=8: 47 ok
+// CHECK: reduce sgsize=5 simd=8: 47 ok
+// CHECK: reduce sgsize=7 simd=8: 47 ok
+// CHECK: reduce sgsize=12 simd=16: 47 ok
+// CHECK: reduce sgsize=24 simd=32: 47 ok
+// CHECK: reduce sgsize=31 simd=32: 47 ok
+
+// CHECK: non-uniform sgsize=8 active=0xff: 47 ok
+// CHECK: non-uniform sgsize=16 active=0xffff: 47 ok
+// CHECK: non-uniform sgsize=32 active=0xffffffff: 47 ok
+// CHECK: non-uniform sgsize=12 active=0xfff: 47 ok
+// CHECK: non-uniform sgsize=16 active=0x1: 47 ok
+// CHECK: non-uniform sgsize=16 active=0x8000: 47 ok
+// CHECK: non-uniform sgsize=16 active=0xff: 47 ok
+// CHECK: non-uniform sgsize=16 active=0x5a5a: 47 ok
+// CHECK: non-uniform sgsize=32 active=0xaaaaaaaa: 47 ok
+// CHECK: non-uniform sgsize=32 active=0x7ffffffe: 47 ok
+// CHECK: non-uniform sgsize=7 active=0x55: 47 ok
+
+// CHECK: clustered sgsize=16 active=0xffff cluster=1: 47 ok
+// CHECK: clustered sgsize=16 active=0xffff cluster=2: 47 ok
+// CHECK: clustered sgsize=16 active=0xffff cluster=4: 47 ok
+// CHECK: clustered sgsize=16 active=0xffff cluster=8: 47 ok
+// CHECK: clustered sgsize=16 active=0xffff cluster=16: 47 ok
+// CHECK: clustered sgsize=32 active=0xffffffff cluster=32: 47 ok
+// CHECK: clustered sgsize=8 active=0xff cluster=4: 47 ok
+// CHECK: clustered sgsize=12 active=0xfff cluster=4: 47 ok
+// CHECK: clustered sgsize=24 active=0xffffff cluster=8: 47 ok
+// CHECK: clustered sgsize=16 active=0xff cluster=4: 47 ok
+// CHECK: clustered sgsize=16 active=0xf0f0 cluster=4: 47 ok
+// CHECK: clustered sgsize=16 active=0xff00 cluster=2: 47 ok
+// CHECK: clustered sgsize=32 active=0xffff00 cluster=8: 47 ok
+// CHECK: clustered sgsize=32 active=0x33333333 cluster=2: 47 ok
+// CHECK-NOT: mismatch
+
+enum InputKind { SmallInput, MulInput, AndInput, OrInput, XorInput };
+
+// Per-channel inputs that keep every reduction exact, whatever the order the
+// channels are combined in, and that make results depend on every channel.
+template <typename T>
+static T makeInput(InputKind kind, uint lane)
+{
+    const uint bits = std::is_same<T, bool>::value ? 1 : 8 * sizeof(T);
+    const ulong bit = 1ull << ((lane * 5) % bits);
+    switch (kind)
+    {
+    case MulInput:
+    {
+        static const double floatFactors[] = { 2.0, 1.0, -1.0, 0.5 };
+        static const int intFactors[] = { 3, 1, 2, 5 };
+        return std::is_floating_point<T>::value ? (T)floatFactors[lane % 4] : (T)intFactors[lane % 4];
+    }
+    case AndInput: return std::is_same<T, bool>::value ? (T)(lane % 7 != 3) : (T)~bit;
+    case OrInput:  return std::is_same<T, bool>::value ? (T)(lane % 5 == 2) : (T)bit;
+    case XorInput: return std::is_same<T, bool>::value ? (T)(lane % 3 == 1) : (T)(0x9E3779B97F4A7C15ull * (lane + 1) >> (lane % 8));
+    default:       return (T)((int)((lane * 7 + 3) % 23) - 11);
+    }
+}
+
+template <typename T>
+struct ReduceTest
+{
+    const char* name;
+    InputKind kind;
+    T identity;
+    T (*op)(T, T);
+    T (*reduce)(T);
+    T (*reduceNonUniform)(T);
+    T (*clusteredReduce)(T, uint);
+
+    // Reduces the inputs of the active channels in [first, first + count).
+    T expected(uint first, uint count, uint activeMask) const
+    {
+        T result = identity;
+        for (uint lane = first; lane < first + count; lane++)
+        {
+            if (activeMask & (1u << lane))
+                result = op(result, makeInput<T>(kind, lane));
+        }
+        return result;
+    }
+
+    // mode 0: uniform reduce, 1: non-uniform reduce, 2: clustered reduce
+    bool check(int mode, uint sgsize, uint sgmax, uint activeMask, uint clusterSize) const
+    {
+        std::vector<uint64_t> got(sgsize);
+        simt::runSubGroup(sgsize, sgmax, activeMask, [&](uint lane) {
+            T x = makeInput<T>(kind, lane);
+            got[lane] = simt::toBits(mode == 0 ? reduce(x) :
+                mode == 1 ? reduceNonUniform(x) : clusteredReduce(x, clusterSize));
+        });
+
+        for (uint lane = 0; lane < sgsize; lane++)
+        {
+            if (!(activeMask & (1u << lane)))
+                continue;
+            T want = mode == 2 ?
+                expected(lane / clusterSize * clusterSize, clusterSize, activeMask) :
+                expected(0, sgsize, activeMask);
+            if (got[lane] != simt::toBits(want))
+            {
+                printf("mismatch: %s mode=%d sgsize=%u active=0x%x cluster=%u lane=%u\n",
+                    name, mode, sgsize, activeMask, clusterSize, lane);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#define DEFN_SUB_GROUP_REDUCE_TEST(name, type, type_abbr, op, identity, kind)                   \
+static type op_##name(type a, type b) { return op(a, b); }                                   \
+static type reduce_##name(type X)                                                            \
+DEFN_SUB_GROUP_REDUCE(type, type_abbr, op, identity, X)                                      \
+static type reduce_non_uniform_##name(type X)                                                \
+{                                                                                            \
+    DEFN_SUB_GROUP_REDUCE_NON_UNIFORM(type, type_abbr, op, identity, X)                      \
+    return X;                                                                                \
+}                                                                                            \
+static type clustered_reduce_##name(type X, uint ClusterSize)                                \
+{                                                                                            \
+    DEFN_SUB_GROUP_CLUSTERED_REDUCE(type, type_abbr, op, identity, X, ClusterSize)           \
+    return X;                                                                                \
+}                                                                                            \
+static bool check_##name(int mode, uint sgsize, uint sgmax, uint activeMask, uint clusterSize) \
+{                                                                                            \
+    static const ReduceTest<type> test = { #name, kind, (type)identity, op_##name,           \
+        reduce_##name, reduce_non_uniform_##name, clustered_reduce_##name };                 \
+    return test.check(mode, sgsize, sgmax, activeMask, clusterSize);                         \
+}
+
+DEFN_SUB_GROUP_REDUCE_TEST(iadd_i8,  uchar,  i8,  __intel_add, 0, SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(iadd_i16, ushort, i16, __intel_add, 0, SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(iadd_i32, uint,   i32, __intel_add, 0, SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(iadd_i64, ulong,  i64, __intel_add, 0, SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fadd_f32, float,  f32, __intel_add, 0, SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fadd_f64, double, f64, __intel_add, 0, SmallInput)
+
+DEFN_SUB_GROUP_REDUCE_TEST(smin_i8,  schar,  i8,  __intel_min, SCHAR_MAX,  SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umin_i8,  uchar,  i8,  __intel_min, UCHAR_MAX,  SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(smin_i16, short,  i16, __intel_min, SHRT_MAX,   SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umin_i16, ushort, i16, __intel_min, USHRT_MAX,  SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(smin_i32, int,    i32, __intel_min, INT_MAX,    SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umin_i32, uint,   i32, __intel_min, UINT_MAX,   SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(smin_i64, slong,  i64, __intel_min, LLONG_MAX,  SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umin_i64, ulong,  i64, __intel_min, ULLONG_MAX, SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fmin_f32, float,  f32, __intel_min, INFINITY,   SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fmin_f64, double, f64, __intel_min, INFINITY,   SmallInput)
+
+DEFN_SUB_GROUP_REDUCE_TEST(smax_i8,  schar,  i8,  __intel_max, SCHAR_MIN,  SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umax_i8,  uchar,  i8,  __intel_max, 0,          SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(smax_i16, short,  i16, __intel_max, SHRT_MIN,   SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umax_i16, ushort, i16, __intel_max, 0,          SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(smax_i32, int,    i32, __intel_max, INT_MIN,    SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umax_i32, uint,   i32, __intel_max, 0,          SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(smax_i64, slong,  i64, __intel_max, LLONG_MIN,  SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(umax_i64, ulong,  i64, __intel_max, 0,          SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fmax_f32, float,  f32, __intel_max, -INFINITY,  SmallInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fmax_f64, double, f64, __intel_max, -INFINITY,  SmallInput)
+
+DEFN_SUB_GROUP_REDUCE_TEST(imul_i8,  uchar,  i8,  __intel_mul, 1, MulInput)
+DEFN_SUB_GROUP_REDUCE_TEST(imul_i16, ushort, i16, __intel_mul, 1, MulInput)
+DEFN_SUB_GROUP_REDUCE_TEST(imul_i32, uint,   i32, __intel_mul, 1, MulInput)
+DEFN_SUB_GROUP_REDUCE_TEST(imul_i64, ulong,  i64, __intel_mul, 1, MulInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fmul_f32, float,  f32, __intel_mul, 1, MulInput)
+DEFN_SUB_GROUP_REDUCE_TEST(fmul_f64, double, f64, __intel_mul, 1, MulInput)
+
+DEFN_SUB_GROUP_REDUCE_TEST(and_i8,  uchar,  i8,  __intel_and, 0xFF,               AndInput)
+DEFN_SUB_GROUP_REDUCE_TEST(and_i16, ushort, i16, __intel_and, 0xFFFF,             AndInput)
+DEFN_SUB_GROUP_REDUCE_TEST(and_i32, uint,   i32, __intel_and, 0xFFFFFFFF,         AndInput)
+DEFN_SUB_GROUP_REDUCE_TEST(and_i64, ulong,  i64, __intel_and, 0xFFFFFFFFFFFFFFFF, AndInput)
+DEFN_SUB_GROUP_REDUCE_TEST(or_i8,   uchar,  i8,  __intel_or,  0, OrInput)
+DEFN_SUB_GROUP_REDUCE_TEST(or_i16,  ushort, i16, __intel_or,  0, OrInput)
+DEFN_SUB_GROUP_REDUCE_TEST(or_i32,  uint,   i32, __intel_or,  0, OrInput)
+DEFN_SUB_GROUP_REDUCE_TEST(or_i64,  ulong,  i64, __intel_or,  0, OrInput)
+DEFN_SUB_GROUP_REDUCE_TEST(xor_i8,  uchar,  i8,  __intel_xor, 0, XorInput)
+DEFN_SUB_GROUP_REDUCE_TEST(xor_i16, ushort, i16, __intel_xor, 0, XorInput)
+DEFN_SUB_GROUP_REDUCE_TEST(xor_i32, uint,   i32, __intel_xor, 0, XorInput)
+DEFN_SUB_GROUP_REDUCE_TEST(xor_i64, ulong,  i64, __intel_xor, 0, XorInput)
+
+DEFN_SUB_GROUP_REDUCE_TEST(logical_and, bool, i1, __intel_and, 1, AndInput)
+DEFN_SUB_GROUP_REDUCE_TEST(logical_or,  bool, i1, __intel_or,  0, OrInput)
+DEFN_SUB_GROUP_REDUCE_TEST(logical_xor, bool, i1, __intel_xor, 0, XorInput)
+
+static bool (* const checks[])(int, uint, uint, uint, uint) = {
+    check_iadd_i8, check_iadd_i16, check_iadd_i32, check_iadd_i64, check_fadd_f32, check_fadd_f64,
+    check_smin_i8, check_umin_i8, check_smin_i16, check_umin_i16, check_smin_i32, check_umin_i32,
+    check_smin_i64, check_umin_i64, check_fmin_f32, check_fmin_f64,
+    check_smax_i8, check_umax_i8, check_smax_i16, check_umax_i16, check_smax_i32, check_umax_i32,
+    check_smax_i64, check_umax_i64, check_fmax_f32, check_fmax_f64,
+    check_imul_i8, check_imul_i16, check_imul_i32, check_imul_i64, check_fmul_f32, check_fmul_f64,
+    check_and_i8, check_and_i16, check_and_i32, check_and_i64,
+    check_or_i8, check_or_i16, check_or_i32, check_or_i64,
+    check_xor_i8, check_xor_i16, check_xor_i32, check_xor_i64,
+    check_logical_and, check_logical_or, check_logical_xor,
+};
+static const int numChecks = (int)(sizeof(checks) / sizeof(checks[0]));
+
+static int runChecks(int mode, uint sgsize, uint sgmax, uint activeMask, uint clusterSize)
+{
+    int passed = 0;
+    for (auto check : checks)
+        passed += check(mode, sgsize, sgmax, activeMask, clusterSize);
+    return passed;
+}
+
+int main()
+{
+    int failures = 0;
+
+    // { sub-group size, SIMD width }; a size below the SIMD width is the
+    // trailing partial sub-group of a work-group
+    static const uint sizes[][2] = {
+        { 1, 8 }, { 2, 8 }, { 8, 8 }, { 16, 16 }, { 32, 32 }, { 4, 16 },
+        { 3, 8 }, { 5, 8 }, { 7, 8 }, { 12, 16 }, { 24, 32 }, { 31, 32 },
+    };
+    for (const auto& size : sizes)
+    {
+        int passed = runChecks(0, size[0], size[1], simt::laneMask(size[0]), 0);
+        printf("reduce sgsize=%u simd=%u: %d ok\n", size[0], size[1], passed);
+        failures += numChecks - passed;
+    }
+
+    // { sub-group size, active channels }
+    static const uint nonUniform[][2] = {
+        { 8, 0xFF }, { 16, 0xFFFF }, { 32, 0xFFFFFFFF }, { 12, 0xFFF },
+        { 16, 0x1 }, { 16, 0x8000 }, { 16, 0xFF }, { 16, 0x5A5A },
+        { 32, 0xAAAAAAAA }, { 32, 0x7FFFFFFE }, { 7, 0x55 },
+    };
+    for (const auto& config : nonUniform)
+    {
+        int passed = runChecks(1, config[0], config[0], config[1], 0);
+        printf("non-uniform sgsize=%u active=0x%x: %d ok\n", config[0], config[1], passed);
+        failures += numChecks - passed;
+    }
+
+    // { sub-group size, active channels, cluster size }. Partially active
+    // sub-groups form clusters from consecutive active channels, so the masks
+    // only activate whole aligned clusters.
+    static const uint clustered[][3] = {
+        { 16, 0xFFFF, 1 }, { 16, 0xFFFF, 2 }, { 16, 0xFFFF, 4 }, { 16, 0xFFFF, 8 },
+        { 16, 0xFFFF, 16 }, { 32, 0xFFFFFFFF, 32 }, { 8, 0xFF, 4 }, { 12, 0xFFF, 4 },
+        { 24, 0xFFFFFF, 8 }, { 16, 0xFF, 4 }, { 16, 0xF0F0, 4 }, { 16, 0xFF00, 2 },
+        { 32, 0xFFFF00, 8 }, { 32, 0x33333333, 2 },
+    };
+    for (const auto& config : clustered)
+    {
+        int passed = runChecks(2, config[0], config[0], config[1], config[2]);
+        printf("clustered sgsize=%u active=0x%x cluster=%u: %d ok\n",
+            config[0], config[1], config[2], passed);
+        failures += numChecks - passed;
+    }
+
+    return failures != 0;
+}
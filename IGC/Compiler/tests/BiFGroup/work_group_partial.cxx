@@ -0,0 +1,164 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Work-group reduce and scans, including work-groups whose size is not a
+// multiple of the SIMD width, so the trailing sub-group has fewer channels
+// than there are sub-group partials to fold.
+//
+// RUN: %host_cxx -std=c++17 -pthread -I %S/Inputs -I %S/../../../BiFModule/Implementation %s -o %t
+// RUN: %t | FileCheck %s
+
+#include "simt_emulation.h"
+#include "include/group_collectives.cl"
+
+#include <cstdio>
+
+// CHECK: wg=64 simd=16: 26 ok
+// CHECK: wg=7 simd=16: 26 ok
+// CHECK: wg=33 simd=16: 26 ok
+// CHECK: wg=25 simd=8: 26 ok
+// CHECK: wg=66 simd=32: 26 ok
+// CHECK: wg=100 simd=32: 26 ok
+// CHECK: wg=255 simd=16: 26 ok
+// CHECK-NOT: mismatch
+
+template <typename T, typename Op>
+static bool checkWorkGroup(
+    const char* name, uint wgSize, uint sgmax, Op op, T identity,
+    T (*reduce)(T), T (*scanIncl)(T), T (*scanExcl)(T))
+{
+    std::vector<T> input(wgSize), gotReduce(wgSize), gotIncl(wgSize), gotExcl(wgSize);
+    for (uint lid = 0; lid < wgSize; lid++)
+        input[lid] = (T)((int)((lid * 7 + 3) % 23) - 11);
+
+    simt::runWorkGroup(wgSize, sgmax, [&](uint lid) {
+        gotReduce[lid] = reduce(input[lid]);
+        gotIncl[lid] = scanIncl(input[lid]);
+        gotExcl[lid] = scanExcl(input[lid]);
+    });
+
+    T total = identity;
+    for (T v : input)
+        total = op(total, v);
+
+    bool ok = true;
+    T prefix = identity;
+    for (uint lid = 0; lid < wgSize; lid++)
+    {
+        T excl = prefix;
+        prefix = op(prefix, input[lid]);
+        if (simt::toBits(gotReduce[lid]) != simt::toBits(total) ||
+            simt::toBits(gotIncl[lid]) != simt::toBits(prefix) ||
+            simt::toBits(gotExcl[lid]) != simt::toBits(excl))
+        {
+            printf("mismatch: %s wg=%u simd=%u lid=%u\n", name, wgSize, sgmax, lid);
+            ok = false;
+            break;
+        }
+    }
+    return ok;
+}
+
+// sg_func mirrors the native branch of __intel_sub_group_<func>_<type>.
+#define DEFN_WORK_GROUP_TEST(name, type, op, identity)                                   \
+static type sg_##name(uint Operation, type X)                                            \
+{                                                                                        \
+    auto fn = [](type a, type b) { return op(a, b); };                                   \
+    if (Operation == GroupOperationReduce)                                               \
+        return simt::nativeReduce<type>(fn, identity, X);                                \
+    type excl = simt::nativeExclusiveScan<type>(fn, identity, X);                        \
+    return Operation == GroupOperationInclusiveScan ? op(X, excl) : excl;                \
+}                                                                                        \
+static type wg_reduce_##name(type X)                                                     \
+DEFN_WORK_GROUP_REDUCE(type, op, identity, X, sg_##name)                                 \
+static type wg_scan_incl_##name(type X)                                                  \
+DEFN_WORK_GROUP_SCAN_INCL(type, op, identity, X, sg_##name)                              \
+static type wg_scan_excl_##name(type X)                                                  \
+DEFN_WORK_GROUP_SCAN_EXCL(type, op, identity, X, sg_##name)                              \
+static bool check_##name(uint wgSize, uint sgmax)                                        \
+{                                                                                        \
+    return checkWorkGroup<type>(#name, wgSize, sgmax,                                    \
+        [](type a, type b) { return op(a, b); }, (type)identity,                         \
+        wg_reduce_##name, wg_scan_incl_##name, wg_scan_excl_##name);                     \
+}
+
+DEFN_WORK_GROUP_TEST(add_uchar,  uchar,  __intel_add, 0)
+DEFN_WORK_GROUP_TEST(add_ushort, ushort, __intel_add, 0)
+DEFN_WORK_GROUP_TEST(add_uint,   uint,   __intel_add, 0)
+DEFN_WORK_GROUP_TEST(add_ulong,  ulong,  __intel_add, 0)
+DEFN_WORK_GROUP_TEST(add_float,  float,  __intel_add, 0)
+DEFN_WORK_GROUP_TEST(add_double, double, __intel_add, 0)
+
+DEFN_WORK_GROUP_TEST(min_uchar,  uchar,  __intel_min, UCHAR_MAX)
+DEFN_WORK_GROUP_TEST(min_ushort, ushort, __intel_min, USHRT_MAX)
+DEFN_WORK_GROUP_TEST(min_uint,   uint,   __intel_min, UINT_MAX)
+DEFN_WORK_GROUP_TEST(min_ulong,  ulong,  __intel_min, ULLONG_MAX)
+DEFN_WORK_GROUP_TEST(min_char,   schar,  __intel_min, SCHAR_MAX)
+DEFN_WORK_GROUP_TEST(min_short,  short,  __intel_min, SHRT_MAX)
+DEFN_WORK_GROUP_TEST(min_int,    int,    __intel_min, INT_MAX)
+DEFN_WORK_GROUP_TEST(min_long,   slong,  __intel_min, LLONG_MAX)
+DEFN_WORK_GROUP_TEST(min_float,  float,  __intel_min, INFINITY)
+DEFN_WORK_GROUP_TEST(min_double, double, __intel_min, INFINITY)
+
+DEFN_WORK_GROUP_TEST(max_uchar,  uchar,  __intel_max, 0)
+DEFN_WORK_GROUP_TEST(max_ushort, ushort, __intel_max, 0)
+DEFN_WORK_GROUP_TEST(max_uint,   uint,   __intel_max, 0)
+DEFN_WORK_GROUP_TEST(max_ulong,  ulong,  __intel_max, 0)
+DEFN_WORK_GROUP_TEST(max_char,   schar,  __intel_max, SCHAR_MIN)
+DEFN_WORK_GROUP_TEST(max_short,  short,  __intel_max, SHRT_MIN)
+DEFN_WORK_GROUP_TEST(max_int,    int,    __intel_max, INT_MIN)
+DEFN_WORK_GROUP_TEST(max_long,   slong,  __intel_max, LLONG_MIN)
+DEFN_WORK_GROUP_TEST(max_float,  float,  __intel_max, -INFINITY)
+DEFN_WORK_GROUP_TEST(max_double, double, __intel_max, -INFINITY)
+
+int main()
+{
+    static bool (* const checks[])(uint, uint) = {
+        check_add_uchar, check_add_ushort, check_add_uint, check_add_ulong,
+        check_add_float, check_add_double,
+        check_min_uchar, check_min_ushort, check_min_uint, check_min_ulong,
+        check_min_char, check_min_short, check_min_int, check_min_long,
+        check_min_float, check_min_double,
+        check_max_uchar, check_max_ushort, check_max_uint, check_max_ulong,
+        check_max_char, check_max_short, check_max_int, check_max_long,
+        check_max_float, check_max_double,
+    };
+    // { work-group size, SIMD width }
+    static const uint configs[][2] = {
+        { 64, 16 }, { 7, 16 }, { 33, 16 }, { 25, 8 }, { 66, 32 }, { 100, 32 }, { 255, 16 },
+    };
+
+    int failures = 0;
+    for (const auto& config : configs)
+    {
+        uint passed = 0;
+        for (auto check : checks)
+            passed += check(config[0], config[1]);
+        printf("wg=%u simd=%u: %u ok\n", config[0], config[1], passed);
+        failures += (int)(sizeof(checks) / sizeof(checks[0])) - (int)passed;
+    }
+    return failures != 0;
+}
@@ -0,0 +1,83 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -DeduplicateFunctions -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+; RUN: FileCheck %s --check-prefix=GONE --input-file=%t.ll
+
+; Subroutines whose IR is identical are only merged if AddImplicitArgs gave
+; them the same implicit arguments: the <3 x i32> argument of @size_a and
+; @size_c is the global size (4), the one of @size_b the local size (5).
+
+define internal i32 @size_a(i32 %dim, <3 x i32> %size) {
+  %r = extractelement <3 x i32> %size, i32 %dim
+  ret i32 %r
+}
+
+define internal i32 @size_b(i32 %dim, <3 x i32> %size) {
+  %r = extractelement <3 x i32> %size, i32 %dim
+  ret i32 %r
+}
+
+define internal i32 @size_c(i32 %dim, <3 x i32> %size) {
+  %r = extractelement <3 x i32> %size, i32 %dim
+  ret i32 %r
+}
+
+define spir_kernel void @test(i32 addrspace(1)* %out, i32 %dim, <3 x i32> %globalSize, <3 x i32> %localSize) {
+  %a = call i32 @size_a(i32 %dim, <3 x i32> %globalSize)
+  %b = call i32 @size_b(i32 %dim, <3 x i32> %localSize)
+  %c = call i32 @size_c(i32 %dim, <3 x i32> %globalSize)
+  %ab = add i32 %a, %b
+  %abc = add i32 %ab, %c
+  store i32 %abc, i32 addrspace(1)* %out
+  ret void
+}
+
+!igc.functions = !{!0, !5, !9, !10}
+!0 = !{void (i32 addrspace(1)*, i32, <3 x i32>, <3 x i32>)* @test, !1}
+!1 = !{!2, !3}
+!2 = !{!"function_type", i32 0}
+!3 = !{!"implicit_arg_desc", !4, !11}
+!4 = !{i32 4}
+!5 = !{i32 (i32, <3 x i32>)* @size_a, !6}
+!6 = !{!7, !8}
+!7 = !{!"function_type", i32 2}
+!8 = !{!"implicit_arg_desc", !4}
+!9 = !{i32 (i32, <3 x i32>)* @size_b, !12}
+!10 = !{i32 (i32, <3 x i32>)* @size_c, !6}
+!11 = !{i32 5}
+!12 = !{!7, !13}
+!13 = !{!"implicit_arg_desc", !11}
+
+; CHECK-LABEL: define internal i32 @size_a
+; CHECK-LABEL: define internal i32 @size_b
+; CHECK-NOT: define internal i32 @size_c
+; CHECK-LABEL: define spir_kernel void @test
+; CHECK: %a = call i32 @size_a(i32 %dim, <3 x i32> %globalSize)
+; CHECK: %b = call i32 @size_b(i32 %dim, <3 x i32> %localSize)
+; CHECK: %c = call i32 @size_a(i32 %dim, <3 x i32> %globalSize)
+
+; GONE-NOT: @size_c
@@ -0,0 +1,94 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -DeduplicateFunctions -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+; RUN: FileCheck %s --check-prefix=GONE --input-file=%t.ll
+
+; Identical internal subroutines are merged into the first one, and callers
+; that become identical once their callees are merged are merged as well.
+
+define internal i32 @add_one_a(i32 %x) {
+  %r = add i32 %x, 1
+  ret i32 %r
+}
+
+define internal i32 @add_one_b(i32 %x) {
+  %r = add i32 %x, 1
+  ret i32 %r
+}
+
+define internal i32 @add_two(i32 %x) {
+  %r = add i32 %x, 2
+  ret i32 %r
+}
+
+define internal i32 @twice_a(i32 %x) {
+  %a = call i32 @add_one_a(i32 %x)
+  %b = call i32 @add_one_a(i32 %a)
+  ret i32 %b
+}
+
+define internal i32 @twice_b(i32 %x) {
+  %a = call i32 @add_one_b(i32 %x)
+  %b = call i32 @add_one_b(i32 %a)
+  ret i32 %b
+}
+
+define spir_kernel void @test(i32 addrspace(1)* %out, i32 %x) {
+  %a = call i32 @add_one_a(i32 %x)
+  %b = call i32 @add_one_b(i32 %a)
+  %c = call i32 @add_two(i32 %b)
+  %d = call i32 @twice_a(i32 %c)
+  %e = call i32 @twice_b(i32 %d)
+  store i32 %e, i32 addrspace(1)* %out
+  ret void
+}
+
+!igc.functions = !{!0, !3, !4, !5, !6, !7}
+!0 = !{void (i32 addrspace(1)*, i32)* @test, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{i32 (i32)* @add_one_a, !8}
+!4 = !{i32 (i32)* @add_one_b, !8}
+!5 = !{i32 (i32)* @add_two, !8}
+!6 = !{i32 (i32)* @twice_a, !8}
+!7 = !{i32 (i32)* @twice_b, !8}
+!8 = !{!9}
+!9 = !{!"function_type", i32 2}
+
+; CHECK-LABEL: define internal i32 @twice_a
+; CHECK: call i32 @add_one_a(i32 %x)
+; CHECK: call i32 @add_one_a(i32 %a)
+; CHECK-LABEL: define spir_kernel void @test
+; CHECK: %a = call i32 @add_one_a(i32 %x)
+; CHECK: %b = call i32 @add_one_a(i32 %a)
+; CHECK: %c = call i32 @add_two(i32 %b)
+; CHECK: %d = call i32 @twice_a(i32 %c)
+; CHECK: %e = call i32 @twice_a(i32 %d)
+
+; Neither the merged functions nor their metadata are left behind.
+; GONE-NOT: @add_one_b
+; GONE-NOT: @twice_b
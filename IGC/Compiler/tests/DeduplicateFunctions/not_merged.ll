@@ -0,0 +1,145 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -DeduplicateFunctions -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; Functions whose identity can be observed are left alone even when their
+; bodies are identical: kernels, subroutines with debug info, subroutines
+; whose address is taken or that are marked IndirectlyCalled, and subroutines
+; that are visible outside the module.
+
+define internal i32 @dbg_a(i32 %x) !dbg !20 {
+  %r = mul i32 %x, 3
+  ret i32 %r
+}
+
+define internal i32 @dbg_b(i32 %x) !dbg !23 {
+  %r = mul i32 %x, 3
+  ret i32 %r
+}
+
+define internal i32 @addr_a(i32 %x) {
+  %r = mul i32 %x, 5
+  ret i32 %r
+}
+
+define internal i32 @addr_b(i32 %x) {
+  %r = mul i32 %x, 5
+  ret i32 %r
+}
+
+define internal i32 @indirect_a(i32 %x) #0 {
+  %r = mul i32 %x, 7
+  ret i32 %r
+}
+
+define internal i32 @indirect_b(i32 %x) #0 {
+  %r = mul i32 %x, 7
+  ret i32 %r
+}
+
+define i32 @external_a(i32 %x) {
+  %r = mul i32 %x, 11
+  ret i32 %r
+}
+
+define i32 @external_b(i32 %x) {
+  %r = mul i32 %x, 11
+  ret i32 %r
+}
+
+define spir_kernel void @kernel_a(i32 addrspace(1)* %out, i32 (i32)* addrspace(1)* %fptr, i32 %x) {
+  %a = call i32 @dbg_a(i32 %x)
+  %b = call i32 @dbg_b(i32 %a)
+  %c = call i32 @addr_a(i32 %b)
+  %d = call i32 @addr_b(i32 %c)
+  %e = call i32 @indirect_a(i32 %d)
+  %f = call i32 @indirect_b(i32 %e)
+  %g = call i32 @external_a(i32 %f)
+  %h = call i32 @external_b(i32 %g)
+  store i32 %h, i32 addrspace(1)* %out
+  store i32 (i32)* @addr_a, i32 (i32)* addrspace(1)* %fptr
+  ret void
+}
+
+define spir_kernel void @kernel_b(i32 addrspace(1)* %out, i32 (i32)* addrspace(1)* %fptr, i32 %x) {
+  %a = call i32 @dbg_a(i32 %x)
+  %b = call i32 @dbg_b(i32 %a)
+  %c = call i32 @addr_a(i32 %b)
+  %d = call i32 @addr_b(i32 %c)
+  %e = call i32 @indirect_a(i32 %d)
+  %f = call i32 @indirect_b(i32 %e)
+  %g = call i32 @external_a(i32 %f)
+  %h = call i32 @external_b(i32 %g)
+  store i32 %h, i32 addrspace(1)* %out
+  store i32 (i32)* @addr_a, i32 (i32)* addrspace(1)* %fptr
+  ret void
+}
+
+attributes #0 = { "IndirectlyCalled" }
+
+!llvm.dbg.cu = !{!17}
+!llvm.module.flags = !{!16}
+!igc.functions = !{!0, !3, !4, !5, !6, !7, !8, !9, !10, !11}
+!0 = !{void (i32 addrspace(1)*, i32 (i32)* addrspace(1)*, i32)* @kernel_a, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{void (i32 addrspace(1)*, i32 (i32)* addrspace(1)*, i32)* @kernel_b, !1}
+!4 = !{i32 (i32)* @dbg_a, !13}
+!5 = !{i32 (i32)* @dbg_b, !13}
+!6 = !{i32 (i32)* @addr_a, !13}
+!7 = !{i32 (i32)* @addr_b, !13}
+!8 = !{i32 (i32)* @indirect_a, !13}
+!9 = !{i32 (i32)* @indirect_b, !13}
+!10 = !{i32 (i32)* @external_a, !13}
+!11 = !{i32 (i32)* @external_b, !13}
+!13 = !{!14}
+!14 = !{!"function_type", i32 2}
+!16 = !{i32 2, !"Debug Info Version", i32 3}
+!17 = distinct !DICompileUnit(language: DW_LANG_C99, file: !18, isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug)
+!18 = !DIFile(filename: "dedup.cl", directory: "/")
+!19 = !DISubroutineType(types: !{})
+!20 = distinct !DISubprogram(name: "dbg_a", scope: !18, file: !18, line: 1, type: !19, scopeLine: 1, unit: !17)
+!23 = distinct !DISubprogram(name: "dbg_b", scope: !18, file: !18, line: 5, type: !19, scopeLine: 5, unit: !17)
+
+; CHECK-LABEL: define internal i32 @dbg_a
+; CHECK-LABEL: define internal i32 @dbg_b
+; CHECK-LABEL: define internal i32 @addr_a
+; CHECK-LABEL: define internal i32 @addr_b
+; CHECK-LABEL: define internal i32 @indirect_a
+; CHECK-LABEL: define internal i32 @indirect_b
+; CHECK-LABEL: define i32 @external_a
+; CHECK-LABEL: define i32 @external_b
+; CHECK-LABEL: define spir_kernel void @kernel_a
+; CHECK: %a = call i32 @dbg_a(i32 %x)
+; CHECK: %b = call i32 @dbg_b(i32 %a)
+; CHECK: %c = call i32 @addr_a(i32 %b)
+; CHECK: %d = call i32 @addr_b(i32 %c)
+; CHECK: %e = call i32 @indirect_a(i32 %d)
+; CHECK: %f = call i32 @indirect_b(i32 %e)
+; CHECK: %g = call i32 @external_a(i32 %f)
+; CHECK: %h = call i32 @external_b(i32 %g)
+; CHECK-LABEL: define spir_kernel void @kernel_b
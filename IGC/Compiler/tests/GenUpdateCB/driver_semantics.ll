@@ -0,0 +1,98 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -GenUpdateCBEvaluate -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; Folds that LLVM leaves undefined or does not know, pinned to what the driver
+; computes: division by zero yields 0, shift amounts wrap at 32 like the
+; hardware shifts, denormal float results are flushed to zero, and the GenISA
+; rsq and fsat intrinsics are evaluated.
+
+define void @CBEntry() {
+entry:
+  %udiv0.out = alloca i32, align 4
+  %sdiv0.out = alloca i32, align 4
+  %urem0.out = alloca i32, align 4
+  %srem0.out = alloca i32, align 4
+  %sdivmin.out = alloca i32, align 4
+  %sremmin.out = alloca i32, align 4
+  %shl.out = alloca i32, align 4
+  %lshr.out = alloca i32, align 4
+  %ashr.out = alloca i32, align 4
+  %denorm.out = alloca float, align 4
+  %negdenorm.out = alloca float, align 4
+  %rsq.out = alloca float, align 4
+  %sathi.out = alloca float, align 4
+  %satlo.out = alloca float, align 4
+  %udiv0 = udiv i32 7, 0
+  store i32 %udiv0, i32* %udiv0.out, align 4
+  %sdiv0 = sdiv i32 7, 0
+  store i32 %sdiv0, i32* %sdiv0.out, align 4
+  %urem0 = urem i32 7, 0
+  store i32 %urem0, i32* %urem0.out, align 4
+  %srem0 = srem i32 7, 0
+  store i32 %srem0, i32* %srem0.out, align 4
+  %sdivmin = sdiv i32 -2147483648, -1
+  store i32 %sdivmin, i32* %sdivmin.out, align 4
+  %sremmin = srem i32 -2147483648, -1
+  store i32 %sremmin, i32* %sremmin.out, align 4
+  %shl = shl i32 1, 33
+  store i32 %shl, i32* %shl.out, align 4
+  %lshr = lshr i32 -1, 32
+  store i32 %lshr, i32* %lshr.out, align 4
+  %ashr = ashr i32 -16, 36
+  store i32 %ashr, i32* %ashr.out, align 4
+  %denorm = fmul float 0x3810000000000000, 5.000000e-01
+  store float %denorm, float* %denorm.out, align 4
+  %negdenorm = fmul float 0xB810000000000000, 5.000000e-01
+  store float %negdenorm, float* %negdenorm.out, align 4
+  %rsq = call float @llvm.genx.GenISA.rsq.f32(float 4.000000e+00)
+  store float %rsq, float* %rsq.out, align 4
+  %sathi = call float @llvm.genx.GenISA.fsat.f32(float 1.500000e+00)
+  store float %sathi, float* %sathi.out, align 4
+  %satlo = call float @llvm.genx.GenISA.fsat.f32(float -5.000000e-01)
+  store float %satlo, float* %satlo.out, align 4
+  ret void
+}
+
+declare float @llvm.genx.GenISA.rsq.f32(float)
+declare float @llvm.genx.GenISA.fsat.f32(float)
+
+; CHECK-LABEL: define void @CBEntry()
+; CHECK: store i32 0, i32* %udiv0.out
+; CHECK: store i32 0, i32* %sdiv0.out
+; CHECK: store i32 0, i32* %urem0.out
+; CHECK: store i32 0, i32* %srem0.out
+; CHECK: store i32 -2147483648, i32* %sdivmin.out
+; CHECK: store i32 0, i32* %sremmin.out
+; CHECK: store i32 2, i32* %shl.out
+; CHECK: store i32 -1, i32* %lshr.out
+; CHECK: store i32 -1, i32* %ashr.out
+; CHECK: store float 0.000000e+00, float* %denorm.out
+; CHECK: store float -0.000000e+00, float* %negdenorm.out
+; CHECK: store float 5.000000e-01, float* %rsq.out
+; CHECK: store float 1.000000e+00, float* %sathi.out
+; CHECK: store float 0.000000e+00, float* %satlo.out
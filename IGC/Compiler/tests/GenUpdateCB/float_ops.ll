@@ -0,0 +1,115 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -GenUpdateCBEvaluate -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+; RUN: opt -instsimplify -S %s -o %t.llvm.ll
+; RUN: FileCheck %s --input-file=%t.llvm.ll
+
+; Float mini-shader folds must match LLVM's constant folder: the same
+; module is folded by the driver-side evaluator and by instsimplify.
+
+define void @CBEntry() {
+entry:
+  %fadd.out = alloca float, align 4
+  %fsub.out = alloca float, align 4
+  %fmul.out = alloca float, align 4
+  %fdiv.out = alloca float, align 4
+  %fneg.out = alloca float, align 4
+  %floor.out = alloca float, align 4
+  %ceil.out = alloca float, align 4
+  %fabs.out = alloca float, align 4
+  %sqrt.out = alloca float, align 4
+  %max.out = alloca float, align 4
+  %min.out = alloca float, align 4
+  %pow.out = alloca float, align 4
+  %exp.out = alloca float, align 4
+  %log.out = alloca float, align 4
+  %cos.out = alloca float, align 4
+  %sin.out = alloca float, align 4
+  %fadd = fadd float 1.500000e+00, 2.250000e+00
+  store float %fadd, float* %fadd.out, align 4
+  %fsub = fsub float %fadd, 5.000000e+00
+  store float %fsub, float* %fsub.out, align 4
+  %fmul = fmul float %fsub, -4.000000e+00
+  store float %fmul, float* %fmul.out, align 4
+  %fdiv = fdiv float 1.000000e+00, 3.000000e+00
+  store float %fdiv, float* %fdiv.out, align 4
+  %fneg = fsub float 0.000000e+00, %fdiv
+  store float %fneg, float* %fneg.out, align 4
+  %floor = call float @llvm.floor.f32(float -2.500000e+00)
+  store float %floor, float* %floor.out, align 4
+  %ceil = call float @llvm.ceil.f32(float -2.500000e+00)
+  store float %ceil, float* %ceil.out, align 4
+  %fabs = call float @llvm.fabs.f32(float %fsub)
+  store float %fabs, float* %fabs.out, align 4
+  %sqrt = call float @llvm.sqrt.f32(float 2.250000e+00)
+  store float %sqrt, float* %sqrt.out, align 4
+  %max = call float @llvm.maxnum.f32(float 0x7FF8000000000000, float 2.000000e+00)
+  store float %max, float* %max.out, align 4
+  %min = call float @llvm.minnum.f32(float %fsub, float %fmul)
+  store float %min, float* %min.out, align 4
+  %pow = call float @llvm.pow.f32(float 2.000000e+00, float 1.000000e+01)
+  store float %pow, float* %pow.out, align 4
+  %exp = call float @llvm.exp2.f32(float 3.000000e+00)
+  store float %exp, float* %exp.out, align 4
+  %log = call float @llvm.log2.f32(float 1.024000e+03)
+  store float %log, float* %log.out, align 4
+  %cos = call float @llvm.cos.f32(float 0.000000e+00)
+  store float %cos, float* %cos.out, align 4
+  %sin = call float @llvm.sin.f32(float 0.000000e+00)
+  store float %sin, float* %sin.out, align 4
+  ret void
+}
+
+declare float @llvm.floor.f32(float)
+declare float @llvm.ceil.f32(float)
+declare float @llvm.fabs.f32(float)
+declare float @llvm.sqrt.f32(float)
+declare float @llvm.maxnum.f32(float, float)
+declare float @llvm.minnum.f32(float, float)
+declare float @llvm.pow.f32(float, float)
+declare float @llvm.exp2.f32(float)
+declare float @llvm.log2.f32(float)
+declare float @llvm.cos.f32(float)
+declare float @llvm.sin.f32(float)
+
+; CHECK-LABEL: define void @CBEntry()
+; CHECK: store float 3.750000e+00, float* %fadd.out
+; CHECK: store float -1.250000e+00, float* %fsub.out
+; CHECK: store float 5.000000e+00, float* %fmul.out
+; CHECK: store float 0x3FD5555560000000, float* %fdiv.out
+; CHECK: store float 0xBFD5555560000000, float* %fneg.out
+; CHECK: store float -3.000000e+00, float* %floor.out
+; CHECK: store float -2.000000e+00, float* %ceil.out
+; CHECK: store float 1.250000e+00, float* %fabs.out
+; CHECK: store float 1.500000e+00, float* %sqrt.out
+; CHECK: store float 2.000000e+00, float* %max.out
+; CHECK: store float -1.250000e+00, float* %min.out
+; CHECK: store float 1.024000e+03, float* %pow.out
+; CHECK: store float 8.000000e+00, float* %exp.out
+; CHECK: store float 1.000000e+01, float* %log.out
+; CHECK: store float 1.000000e+00, float* %cos.out
+; CHECK: store float 0.000000e+00, float* %sin.out
@@ -0,0 +1,95 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -GenUpdateCBEvaluate -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+; RUN: opt -instsimplify -S %s -o %t.llvm.ll
+; RUN: FileCheck %s --input-file=%t.llvm.ll
+
+; Integer mini-shader folds must match LLVM's constant folder: the same
+; module is folded by the driver-side evaluator and by instsimplify.
+
+define void @CBEntry() {
+entry:
+  %sub.out = alloca i32, align 4
+  %add.out = alloca i32, align 4
+  %mul.out = alloca i32, align 4
+  %ashr.out = alloca i32, align 4
+  %ashr2.out = alloca i32, align 4
+  %lshr.out = alloca i32, align 4
+  %shl.out = alloca i32, align 4
+  %udiv.out = alloca i32, align 4
+  %sdiv.out = alloca i32, align 4
+  %urem.out = alloca i32, align 4
+  %srem.out = alloca i32, align 4
+  %and.out = alloca i32, align 4
+  %or.out = alloca i32, align 4
+  %xor.out = alloca i32, align 4
+  %sub = sub i32 5, 12
+  store i32 %sub, i32* %sub.out, align 4
+  %add = add i32 %sub, 100
+  store i32 %add, i32* %add.out, align 4
+  %mul = mul i32 %add, -3
+  store i32 %mul, i32* %mul.out, align 4
+  %ashr = ashr i32 -7, 1
+  store i32 %ashr, i32* %ashr.out, align 4
+  %ashr2 = ashr i32 %mul, 4
+  store i32 %ashr2, i32* %ashr2.out, align 4
+  %lshr = lshr i32 -8, 28
+  store i32 %lshr, i32* %lshr.out, align 4
+  %shl = shl i32 3, 30
+  store i32 %shl, i32* %shl.out, align 4
+  %udiv = udiv i32 -2, 3
+  store i32 %udiv, i32* %udiv.out, align 4
+  %sdiv = sdiv i32 -7, 2
+  store i32 %sdiv, i32* %sdiv.out, align 4
+  %urem = urem i32 -1, 10
+  store i32 %urem, i32* %urem.out, align 4
+  %srem = srem i32 -7, 3
+  store i32 %srem, i32* %srem.out, align 4
+  %and = and i32 %sub, 252
+  store i32 %and, i32* %and.out, align 4
+  %or = or i32 %ashr, 16
+  store i32 %or, i32* %or.out, align 4
+  %xor = xor i32 %sdiv, -1
+  store i32 %xor, i32* %xor.out, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @CBEntry()
+; CHECK: store i32 -7, i32* %sub.out
+; CHECK: store i32 93, i32* %add.out
+; CHECK: store i32 -279, i32* %mul.out
+; CHECK: store i32 -4, i32* %ashr.out
+; CHECK: store i32 -18, i32* %ashr2.out
+; CHECK: store i32 15, i32* %lshr.out
+; CHECK: store i32 -1073741824, i32* %shl.out
+; CHECK: store i32 1431655764, i32* %udiv.out
+; CHECK: store i32 -3, i32* %sdiv.out
+; CHECK: store i32 5, i32* %urem.out
+; CHECK: store i32 -1, i32* %srem.out
+; CHECK: store i32 248, i32* %and.out
+; CHECK: store i32 -4, i32* %or.out
+; CHECK: store i32 2, i32* %xor.out
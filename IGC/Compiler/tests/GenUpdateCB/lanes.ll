@@ -0,0 +1,80 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -GenUpdateCBEvaluate -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+; RUN: opt -instsimplify -S %s -o %t.llvm.ll
+; RUN: FileCheck %s --input-file=%t.llvm.ll
+
+; Independent operations of the same kind share the lanes of one bytecode
+; instruction. An operation that reads a result still waiting for its lanes
+; to fill, and stores of such results, must see the computed value.
+
+define void @CBEntry() {
+entry:
+  %a0.out = alloca float, align 4
+  %a1.out = alloca float, align 4
+  %a2.out = alloca float, align 4
+  %a3.out = alloca float, align 4
+  %a4.out = alloca float, align 4
+  %a5.out = alloca float, align 4
+  %a6.out = alloca float, align 4
+  %m.out = alloca float, align 4
+  %i0.out = alloca i32, align 4
+  %x.out = alloca i32, align 4
+  %a0 = fadd float 1.000000e+00, 2.000000e+00
+  %a1 = fadd float 3.000000e+00, 4.000000e+00
+  %i0 = add i32 7, 1
+  %a2 = fadd float %a0, 5.000000e-01
+  %a3 = fadd float 5.000000e+00, 6.000000e+00
+  %a4 = fadd float 7.000000e+00, 8.000000e+00
+  %a5 = fadd float 9.000000e+00, 1.000000e+00
+  %a6 = fadd float %a2, %a1
+  %m = fmul float %a6, %a5
+  %x = xor i32 %i0, 3
+  store float %m, float* %m.out, align 4
+  store float %a0, float* %a0.out, align 4
+  store float %a1, float* %a1.out, align 4
+  store float %a2, float* %a2.out, align 4
+  store float %a3, float* %a3.out, align 4
+  store float %a4, float* %a4.out, align 4
+  store float %a5, float* %a5.out, align 4
+  store float %a6, float* %a6.out, align 4
+  store i32 %i0, i32* %i0.out, align 4
+  store i32 %x, i32* %x.out, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @CBEntry()
+; CHECK: store float 1.050000e+02, float* %m.out
+; CHECK: store float 3.000000e+00, float* %a0.out
+; CHECK: store float 7.000000e+00, float* %a1.out
+; CHECK: store float 3.500000e+00, float* %a2.out
+; CHECK: store float 1.100000e+01, float* %a3.out
+; CHECK: store float 1.500000e+01, float* %a4.out
+; CHECK: store float 1.000000e+01, float* %a5.out
+; CHECK: store float 1.050000e+01, float* %a6.out
+; CHECK: store i32 8, i32* %i0.out
+; CHECK: store i32 11, i32* %x.out
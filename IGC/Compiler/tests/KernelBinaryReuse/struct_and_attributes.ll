@@ -0,0 +1,69 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-print-kernel-fingerprints %s -o /dev/null > %t.txt
+; RUN: sed -e 's/%%struct.B = type { i64 }/%%struct.B = type { i32 }/' %s | igc_opt -igc-print-kernel-fingerprints -o /dev/null >> %t.txt
+; RUN: sed -e 's/noinline nounwind/noinline nounwind readnone/' %s | igc_opt -igc-print-kernel-fingerprints -o /dev/null >> %t.txt
+; RUN: FileCheck %s --input-file=%t.txt
+; RUN: FileCheck %s --input-file=%t.txt --check-prefix=DIFFER
+
+; The IR text of a function refers to named struct types by name and to
+; function attributes by group number, so their contents are hashed
+; separately. Changing either changes the fingerprint.
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-n8:16:32"
+
+%struct.A = type { i32, %struct.B }
+%struct.B = type { i64 }
+
+define spir_kernel void @kernel(%struct.A addrspace(1)* %p) #0 {
+entry:
+  %f = getelementptr inbounds %struct.A, %struct.A addrspace(1)* %p, i32 0, i32 0
+  %v = load i32, i32 addrspace(1)* %f, align 4
+  %r = call i32 @helper(i32 %v) #1
+  store i32 %r, i32 addrspace(1)* %f, align 4
+  ret void
+}
+
+declare i32 @helper(i32) #1
+
+attributes #0 = { convergent nounwind }
+attributes #1 = { noinline nounwind }
+
+; CHECK-LABEL: kernel kernel
+; CHECK-DAG:   %struct.A = type { i32, %struct.B }
+; CHECK-DAG:   %struct.B = type { i64 }
+; CHECK-DAG:   define spir_kernel void @kernel(%struct.A addrspace(1)* %p) # {
+; CHECK-DAG:   call i32 @helper(i32 %v) #{{$}}
+; CHECK-DAG:   {{^}}convergent nounwind{{$}}
+; CHECK-DAG:   {{^}}noinline nounwind{{$}}
+; CHECK:       fingerprint
+
+; DIFFER:      fingerprint [[ORIG:[0-9a-f]+]]
+; DIFFER-NOT:  fingerprint [[ORIG]]
+; DIFFER:      fingerprint [[BODY:[0-9a-f]+]]
+; DIFFER-NOT:  fingerprint [[ORIG]]
+; DIFFER-NOT:  fingerprint [[BODY]]
+; DIFFER:      fingerprint
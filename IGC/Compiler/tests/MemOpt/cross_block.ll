@@ -0,0 +1,162 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt %s -S -o - -basicaa -igc-memopt | FileCheck %s
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+declare void @llvm.genx.GenISA.threadgroupbarrier()
+
+; Each block is entered only from the previous one, so the loads are hoisted
+; into entry and the stores are sunk into tail.
+
+define void @dominating(i32* %dst, i32* %src) {
+entry:
+  %0 = load i32, i32* %src, align 4
+  br label %next
+
+next:
+  %arrayidx1 = getelementptr inbounds i32, i32* %src, i32 1
+  %1 = load i32, i32* %arrayidx1, align 4
+  %arrayidx2 = getelementptr inbounds i32, i32* %src, i32 2
+  %2 = load i32, i32* %arrayidx2, align 4
+  store i32 %0, i32* %dst, align 4
+  %arrayidx3 = getelementptr inbounds i32, i32* %dst, i32 1
+  store i32 %1, i32* %arrayidx3, align 4
+  br label %tail
+
+tail:
+  %arrayidx4 = getelementptr inbounds i32, i32* %dst, i32 2
+  store i32 %2, i32* %arrayidx4, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @dominating
+; CHECK: entry:
+; CHECK: load <3 x i32>
+; CHECK: next:
+; CHECK-NOT: load
+; CHECK-NOT: store
+; CHECK: tail:
+; CHECK: store <3 x i32>
+; CHECK-NEXT: ret void
+
+
+; '%p' may alias '%src', so the load from '%src + 4' cannot be hoisted above
+; the store.
+
+define i32 @aliasing_store(i32* %p, i32* %src) {
+entry:
+  %a = load i32, i32* %src, align 4
+  br label %next
+
+next:
+  store i32 0, i32* %p, align 4
+  %arrayidx1 = getelementptr inbounds i32, i32* %src, i32 1
+  %b = load i32, i32* %arrayidx1, align 4
+  %sum = add i32 %a, %b
+  ret i32 %sum
+}
+
+; CHECK-LABEL: define i32 @aliasing_store
+; CHECK: entry:
+; CHECK-NEXT: %a = load i32, i32* %src, align 4
+; CHECK: next:
+; CHECK-NEXT: store i32 0, i32* %p, align 4
+; CHECK: %b = load i32, i32* %arrayidx1, align 4
+; CHECK-NOT: load
+; CHECK: ret i32
+
+
+; The store to '%dst' cannot be sunk past the barrier.
+
+define void @barrier(i32* noalias %dst) {
+entry:
+  store i32 1, i32* %dst, align 4
+  br label %next
+
+next:
+  call void @llvm.genx.GenISA.threadgroupbarrier()
+  %arrayidx1 = getelementptr inbounds i32, i32* %dst, i32 1
+  store i32 2, i32* %arrayidx1, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @barrier
+; CHECK: entry:
+; CHECK-NEXT: store i32 1, i32* %dst, align 4
+; CHECK: next:
+; CHECK-NEXT: call void @llvm.genx.GenISA.threadgroupbarrier()
+; CHECK: store i32 2, i32* %arrayidx1, align 4
+; CHECK-NEXT: ret void
+
+
+; 'then' does not dominate 'join', so its load cannot take the one in 'join'
+; and its store cannot be sunk into 'join'.
+
+define i32 @not_dominating_load(i1 %c, i32* %src) {
+entry:
+  br i1 %c, label %then, label %join
+
+then:
+  %a = load i32, i32* %src, align 4
+  br label %join
+
+join:
+  %phi = phi i32 [ %a, %then ], [ 0, %entry ]
+  %arrayidx1 = getelementptr inbounds i32, i32* %src, i32 1
+  %b = load i32, i32* %arrayidx1, align 4
+  %sum = add i32 %phi, %b
+  ret i32 %sum
+}
+
+; CHECK-LABEL: define i32 @not_dominating_load
+; CHECK: then:
+; CHECK-NEXT: %a = load i32, i32* %src, align 4
+; CHECK: join:
+; CHECK: %b = load i32, i32* %arrayidx1, align 4
+; CHECK-NOT: load
+; CHECK: ret i32
+
+define void @not_dominating_store(i1 %c, i32* noalias %dst) {
+entry:
+  br i1 %c, label %then, label %join
+
+then:
+  store i32 1, i32* %dst, align 4
+  br label %join
+
+join:
+  %arrayidx1 = getelementptr inbounds i32, i32* %dst, i32 1
+  store i32 2, i32* %arrayidx1, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @not_dominating_store
+; CHECK: then:
+; CHECK-NEXT: store i32 1, i32* %dst, align 4
+; CHECK: join:
+; CHECK: store i32 2, i32* %arrayidx1, align 4
+; CHECK-NEXT: ret void
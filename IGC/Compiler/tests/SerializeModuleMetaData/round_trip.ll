@@ -0,0 +1,156 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-serialize-module-metadata -S %s -o %t.blob.ll
+; RUN: FileCheck %s --check-prefix=BLOB --input-file=%t.blob.ll
+; RUN: igc_opt -igc-serialize-module-metadata -igc-readable-module-metadata -S %t.blob.ll -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; Populated ModuleMetaData goes from the readable form to the blob and back.
+; The fields below cover each kind of value the blob encodes: bools, signed
+; and unsigned integers, floats, strings, enums, bytes, nested structs,
+; vectors, arrays, maps keyed by values and by structs, and references to
+; functions and globals.
+
+@lds = internal addrspace(3) global [16 x i32] undef
+@gv = addrspace(1) global i32 0
+
+define spir_kernel void @k(i32 addrspace(1)* %p) {
+  ret void
+}
+
+; BLOB: !IGCMetadata = !{[[ROOT:![0-9]+]]}
+; BLOB: [[ROOT]] = !{!"ModuleMDBlob", !"IGMD{{.*}}", [[VALUES:![0-9]+]]}
+; BLOB: [[VALUES]] = !{void (i32 addrspace(1)*)* @k, [16 x i32] addrspace(3)* @lds, i32 addrspace(1)* @gv}
+; BLOB-NOT: !"ModuleMD"
+
+; CHECK: !IGCMetadata = !{[[ROOT:![0-9]+]]}
+; CHECK: [[ROOT]] = !{!"ModuleMD",
+; CHECK-DAG: !{!"isPrecise", i1 true}
+; CHECK-DAG: !{!"FastRelaxedMath", i1 true}
+; CHECK-DAG: !{!"CompileTimeBudgetMs", i32 250}
+; CHECK-DAG: !{!"UseScratchSpacePrivateMemory", i1 false}
+; CHECK-DAG: !{!"FuncMDMap[0]", void (i32 addrspace(1)*)* @k}
+; CHECK-DAG: !{!"m_Offset", i32 64}
+; CHECK-DAG: !{!"m_Var", [16 x i32] addrspace(3)* @lds}
+; CHECK-DAG: !{!"dim0", i32 2}
+; CHECK-DAG: !{!"dim2", i32 1}
+; CHECK-DAG: !{!"bufferLocationIndex", i32 3}
+; CHECK-DAG: !{!"isEmulationArg", i1 true}
+; CHECK-DAG: !{!"functionType", !"UserFunction"}
+; CHECK-DAG: !{!"m_Value", i32 17}
+; CHECK-DAG: !{!"BorderColorR", float 5.000000e-01}
+; CHECK-DAG: !{!"privateMemoryPerWI", i32 96}
+; CHECK-DAG: !{!"m_OpenCLArgAddressSpacesVec[0]", i32 1}
+; CHECK-DAG: !{!"m_OpenCLArgTypesVec[0]", !"float4*"}
+; CHECK-DAG: !{!"m_OpenCLArgNamesVec[0]", !"dst"}
+; CHECK-DAG: !{!"bufId", i32 2}
+; CHECK-DAG: !{!"eltId", i32 5}
+; CHECK-DAG: !{!"constantsValue[0]", i32 9}
+; CHECK-DAG: !{!"inlineConstantBufferSlot", i32 -1}
+; CHECK-DAG: !{!"simplePushLoadsMap[0]", i32 12}
+; CHECK-DAG: !{!"simplePushLoadsValue[0]", i32 3}
+; CHECK-DAG: !{!"forcedSIMDSize", i8 16}
+; CHECK-DAG: !{!"inlineDynTexturesMap[0]", i32 7}
+; CHECK-DAG: !{!"inlineDynTexturesValue[0]Vec[3]", i32 4}
+; CHECK-DAG: !{!"dataVec[0]", i32 97}
+; CHECK-DAG: !{!"alignment", i32 16}
+; CHECK-DAG: !{!"BufferVec[1]", i8 127}
+; CHECK-DAG: !{!"BufferVec[2]", i8 -1}
+; CHECK-DAG: !{!"inlineProgramScopeOffsetsMap[0]", i32 addrspace(1)* @gv}
+; CHECK-DAG: !{!"inlineProgramScopeOffsetsValue[0]", i32 128}
+
+!IGCMetadata = !{!0}
+
+!0 = !{!"ModuleMD", !1, !2, !6, !33, !46, !48, !55, !59, !67}
+!1 = !{!"isPrecise", i1 true}
+!2 = !{!"compOpt", !3, !4, !5}
+!3 = !{!"FastRelaxedMath", i1 true}
+!4 = !{!"CompileTimeBudgetMs", i32 250}
+!5 = !{!"UseScratchSpacePrivateMemory", i1 false}
+!6 = !{!"FuncMD", !7, !8}
+!7 = !{!"FuncMDMap[0]", void (i32 addrspace(1)*)* @k}
+!8 = !{!"FuncMDValue[0]", !9, !13, !16, !20, !21, !26, !27, !29, !31}
+!9 = !{!"localOffsets", !10}
+!10 = !{!"localOffsetsVec[0]", !11, !12}
+!11 = !{!"m_Offset", i32 64}
+!12 = !{!"m_Var", [16 x i32] addrspace(3)* @lds}
+!13 = !{!"workGroupWalkOrder", !14, !15}
+!14 = !{!"dim0", i32 2}
+!15 = !{!"dim2", i32 1}
+!16 = !{!"funcArgs", !17}
+!17 = !{!"funcArgsVec[0]", !18, !19}
+!18 = !{!"bufferLocationIndex", i32 3}
+!19 = !{!"isEmulationArg", i1 true}
+!20 = !{!"functionType", !"UserFunction"}
+!21 = !{!"resAllocMD", !22}
+!22 = !{!"inlineSamplersMD", !23}
+!23 = !{!"inlineSamplersMDVec[0]", !24, !25}
+!24 = !{!"m_Value", i32 17}
+!25 = !{!"BorderColorR", float 5.000000e-01}
+!26 = !{!"privateMemoryPerWI", i32 96}
+!27 = !{!"m_OpenCLArgAddressSpaces", !28}
+!28 = !{!"m_OpenCLArgAddressSpacesVec[0]", i32 1}
+!29 = !{!"m_OpenCLArgTypes", !30}
+!30 = !{!"m_OpenCLArgTypesVec[0]", !"float4*"}
+!31 = !{!"m_OpenCLArgNames", !32}
+!32 = !{!"m_OpenCLArgNamesVec[0]", !"dst"}
+!33 = !{!"pushInfo", !34, !40}
+!34 = !{!"constants", !35, !39}
+!35 = !{!"constantsMap[0]", !36, !37, !38}
+!36 = !{!"bufId", i32 2}
+!37 = !{!"eltId", i32 5}
+!38 = !{!"size", i32 4}
+!39 = !{!"constantsValue[0]", i32 9}
+!40 = !{!"simplePushInfoArr", !41, !42}
+!41 = !{!"simplePushInfoArrVec[0]"}
+!42 = !{!"simplePushInfoArrVec[1]", !43}
+!43 = !{!"simplePushLoads", !44, !45}
+!44 = !{!"simplePushLoadsMap[0]", i32 12}
+!45 = !{!"simplePushLoadsValue[0]", i32 3}
+!46 = !{!"csInfo", !47}
+!47 = !{!"forcedSIMDSize", i8 16}
+!48 = !{!"inlineDynTextures", !49, !50}
+!49 = !{!"inlineDynTexturesMap[0]", i32 7}
+!50 = !{!"inlineDynTexturesValue[0]", !51, !52, !53, !54}
+!51 = !{!"inlineDynTexturesValue[0]Vec[0]", i32 1}
+!52 = !{!"inlineDynTexturesValue[0]Vec[1]", i32 2}
+!53 = !{!"inlineDynTexturesValue[0]Vec[2]", i32 3}
+!54 = !{!"inlineDynTexturesValue[0]Vec[3]", i32 4}
+!55 = !{!"immConstant", !56}
+!56 = !{!"data", !57, !58}
+!57 = !{!"dataVec[0]", i32 97}
+!58 = !{!"dataVec[1]", i32 0}
+!59 = !{!"inlineConstantBuffers", !60}
+!60 = !{!"inlineConstantBuffersVec[0]", !61, !62, !63}
+!61 = !{!"alignment", i32 16}
+!62 = !{!"allocSize", i32 3}
+!63 = !{!"Buffer", !64, !65, !66}
+!64 = !{!"BufferVec[0]", i8 0}
+!65 = !{!"BufferVec[1]", i8 127}
+!66 = !{!"BufferVec[2]", i8 -1}
+!67 = !{!"inlineProgramScopeOffsets", !68, !69}
+!68 = !{!"inlineProgramScopeOffsetsMap[0]", i32 addrspace(1)* @gv}
+!69 = !{!"inlineProgramScopeOffsetsValue[0]", i32 128}
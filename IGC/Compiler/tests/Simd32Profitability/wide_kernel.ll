@@ -0,0 +1,71 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; The spill predictor only runs when SIMDPredictorSpillRatio is set. Eight
+; floats are live at once, 32 bytes per lane: 16 GRFs at SIMD16 and 32 GRFs at
+; SIMD32 out of 128. With the ratio at 20% of the GRF file only SIMD32 crosses
+; it, so a kernel allowed to abort on spill skips its SIMD32 compile.
+;
+; RUN: igc_opt -simd32-profit -analyze %s | FileCheck %s --check-prefix=OFF
+; RUN: env IGC_SIMDPredictorSpillRatio=20 igc_opt -simd32-profit -analyze %s | FileCheck %s
+
+; OFF: SIMD16: not estimated
+; OFF: SIMD32: not estimated
+
+; CHECK: SIMD16: 16 of 128 GRFs{{$}}
+; CHECK: SIMD32: 32 of 128 GRFs, predicted to spill
+
+define spir_kernel void @wide(float addrspace(1)* %in, float addrspace(1)* %out) {
+entry:
+  %p1 = getelementptr float, float addrspace(1)* %in, i64 1
+  %p2 = getelementptr float, float addrspace(1)* %in, i64 2
+  %p3 = getelementptr float, float addrspace(1)* %in, i64 3
+  %p4 = getelementptr float, float addrspace(1)* %in, i64 4
+  %p5 = getelementptr float, float addrspace(1)* %in, i64 5
+  %p6 = getelementptr float, float addrspace(1)* %in, i64 6
+  %p7 = getelementptr float, float addrspace(1)* %in, i64 7
+  %v0 = load float, float addrspace(1)* %in
+  %v1 = load float, float addrspace(1)* %p1
+  %v2 = load float, float addrspace(1)* %p2
+  %v3 = load float, float addrspace(1)* %p3
+  %v4 = load float, float addrspace(1)* %p4
+  %v5 = load float, float addrspace(1)* %p5
+  %v6 = load float, float addrspace(1)* %p6
+  %v7 = load float, float addrspace(1)* %p7
+  %s0 = fadd float %v0, %v7
+  %s1 = fadd float %v1, %v6
+  %s2 = fadd float %v2, %v5
+  %s3 = fadd float %v3, %v4
+  %s4 = fadd float %s0, %s3
+  %s5 = fadd float %s1, %s2
+  %s6 = fadd float %s4, %s5
+  store float %s6, float addrspace(1)* %out
+  ret void
+}
+
+!igc.functions = !{!0}
+!0 = !{void (float addrspace(1)*, float addrspace(1)*)* @wide, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
@@ -0,0 +1,74 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=9:16,10:16 -S %s -o %t.ll
+; RUN: FileCheck %s --check-prefix=POW2 --input-file=%t.ll
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=9:7,10:0 -S %s -o %t.odd.ll
+; RUN: FileCheck %s --check-prefix=ODD --input-file=%t.odd.ll
+
+; Masks and compares that constant folding could decide from the address of
+; the placeholder alone: its low bits, whether it is null, and whether two
+; placeholders are equal. They must keep the placeholder until the value is
+; known, whether they come from OpSpecConstantOp or from instructions.
+
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+target triple = "spir64-unknown-unknown"
+
+@spirv.SpecConstant.9 = extern_weak constant i32, align 1, !spirv.SpecId !0
+@spirv.SpecConstant.10 = extern_weak constant i32, align 1, !spirv.SpecId !1
+
+; TILE & (TILE - 1) and TILE & 3, as OpSpecConstantOp results.
+@masks = addrspace(2) constant [2 x i32] [i32 and (i32 ptrtoint (i32* @spirv.SpecConstant.9 to i32), i32 add (i32 ptrtoint (i32* @spirv.SpecConstant.9 to i32), i32 -1)), i32 and (i32 ptrtoint (i32* @spirv.SpecConstant.9 to i32), i32 3)]
+
+; POW2-NOT: spirv.SpecConstant
+; ODD-NOT: spirv.SpecConstant
+
+; POW2: @masks = addrspace(2) constant [2 x i32] zeroinitializer
+; ODD: @masks = addrspace(2) constant [2 x i32] [i32 6, i32 3]
+
+define spir_kernel void @test_masks(i32 addrspace(1)* %out, i1 addrspace(1)* %flags, i32 %x) {
+entry:
+  %low = and i32 %x, and (i32 ptrtoint (i32* @spirv.SpecConstant.9 to i32), i32 7)
+  store i32 %low, i32 addrspace(1)* %out
+  %isZero = icmp eq i32 ptrtoint (i32* @spirv.SpecConstant.10 to i32), 0
+  store i1 %isZero, i1 addrspace(1)* %flags
+  %same = icmp eq i32 ptrtoint (i32* @spirv.SpecConstant.9 to i32), ptrtoint (i32* @spirv.SpecConstant.10 to i32)
+  %flag1 = getelementptr i1, i1 addrspace(1)* %flags, i64 1
+  store i1 %same, i1 addrspace(1)* %flag1
+  ret void
+}
+
+; POW2-LABEL: define spir_kernel void @test_masks
+; POW2: %low = and i32 %x, 0
+; POW2: %isZero = icmp eq i32 16, 0
+; POW2: %same = icmp eq i32 16, 16
+
+; ODD-LABEL: define spir_kernel void @test_masks
+; ODD: %low = and i32 %x, 7
+; ODD: %isZero = icmp eq i32 0, 0
+; ODD: %same = icmp eq i32 7, 0
+
+!0 = !{i32 9, i32 8}
+!1 = !{i32 10, i32 8}
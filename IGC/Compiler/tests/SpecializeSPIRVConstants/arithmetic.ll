@@ -0,0 +1,70 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=0:5,1:0x100000000 -S %s -o %t.ll
+; RUN: FileCheck %s --check-prefix=VALUE --input-file=%t.ll
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=1:3 -S %s -o %t.partial.ll
+; RUN: FileCheck %s --check-prefix=PARTIAL --input-file=%t.partial.ll
+
+; Specialization constants used as instruction operands. The same
+; unspecialized module is specialized twice, as consecutive builds served from
+; the unspecialized IR cache are; SpecId 0 keeps its default in the second one.
+
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+target triple = "spir64-unknown-unknown"
+
+@spirv.SpecConstant.0 = extern_weak constant i32, align 1, !spirv.SpecId !0
+@spirv.SpecConstant.1 = extern_weak constant i64, align 1, !spirv.SpecId !1
+
+; VALUE-NOT: spirv.SpecConstant
+; PARTIAL-NOT: spirv.SpecConstant
+
+define spir_kernel void @test_arith(i32 addrspace(1)* %out, i64 addrspace(1)* %out64, i32 %x) {
+entry:
+  %mul = mul i32 %x, ptrtoint (i32* @spirv.SpecConstant.0 to i32)
+  %add = add i32 %mul, ptrtoint (i32* @spirv.SpecConstant.0 to i32)
+  %cmp = icmp ult i32 %add, ptrtoint (i32* @spirv.SpecConstant.0 to i32)
+  %sel = select i1 %cmp, i32 %add, i32 0
+  store i32 %sel, i32 addrspace(1)* %out
+  %wide = sext i32 %x to i64
+  %sum = add i64 %wide, ptrtoint (i64* @spirv.SpecConstant.1 to i64)
+  store i64 %sum, i64 addrspace(1)* %out64
+  ret void
+}
+
+; VALUE-LABEL: define spir_kernel void @test_arith
+; VALUE: %mul = mul i32 %x, 5
+; VALUE: %add = add i32 %mul, 5
+; VALUE: %cmp = icmp ult i32 %add, 5
+; VALUE: %sum = add i64 %wide, 4294967296
+
+; PARTIAL-LABEL: define spir_kernel void @test_arith
+; PARTIAL: %mul = mul i32 %x, 7
+; PARTIAL: %add = add i32 %mul, 7
+; PARTIAL: %cmp = icmp ult i32 %add, 7
+; PARTIAL: %sum = add i64 %wide, 3
+
+!0 = !{i32 0, i32 7}
+!1 = !{i32 1, i64 -1}
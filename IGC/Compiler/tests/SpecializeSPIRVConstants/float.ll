@@ -0,0 +1,65 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=4:0x40490FDB,5:0x400921FB54442D18 -S %s -o %t.ll
+; RUN: FileCheck %s --check-prefix=VALUE --input-file=%t.ll
+; RUN: igc_opt -igc-specialize-spirv-constants -S %s -o %t.default.ll
+; RUN: FileCheck %s --check-prefix=DEFAULT --input-file=%t.default.ll
+
+; Floating-point specialization constants. Values are passed as the bits of
+; the constant, and OpFConvert of a specialization constant must fold too.
+
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+target triple = "spir64-unknown-unknown"
+
+@spirv.SpecConstant.4 = extern_weak constant float, align 1, !spirv.SpecId !4
+@spirv.SpecConstant.5 = extern_weak constant double, align 1, !spirv.SpecId !5
+
+; VALUE-NOT: spirv.SpecConstant
+; DEFAULT-NOT: spirv.SpecConstant
+
+define spir_kernel void @test_float(float addrspace(1)* %out, double addrspace(1)* %out64, float %x, double %y) {
+entry:
+  %m = fmul float %x, bitcast (i32 ptrtoint (float* @spirv.SpecConstant.4 to i32) to float)
+  store float %m, float addrspace(1)* %out
+  %d = fadd double %y, bitcast (i64 ptrtoint (double* @spirv.SpecConstant.5 to i64) to double)
+  store double %d, double addrspace(1)* %out64
+  %e = fadd double %y, fpext (float bitcast (i32 ptrtoint (float* @spirv.SpecConstant.4 to i32) to float) to double)
+  store double %e, double addrspace(1)* %out64
+  ret void
+}
+
+; VALUE-LABEL: define spir_kernel void @test_float
+; VALUE: %m = fmul float %x, 0x400921FB60000000
+; VALUE: %d = fadd double %y, 0x400921FB54442D18
+; VALUE: %e = fadd double %y, 0x400921FB60000000
+
+; DEFAULT-LABEL: define spir_kernel void @test_float
+; DEFAULT: %m = fmul float %x, 1.000000e+00
+; DEFAULT: %d = fadd double %y, 2.000000e+00
+; DEFAULT: %e = fadd double %y, 1.000000e+00
+
+!4 = !{i32 4, float 1.000000e+00}
+!5 = !{i32 5, double 2.000000e+00}
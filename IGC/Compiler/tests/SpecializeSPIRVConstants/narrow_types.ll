@@ -0,0 +1,68 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=6:0x80,7:2,8:0x12345 -S %s -o %t.ll
+; RUN: FileCheck %s --check-prefix=VALUE --input-file=%t.ll
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=6:1,7:0,8:9 -S %s -o %t.second.ll
+; RUN: FileCheck %s --check-prefix=SECOND --input-file=%t.second.ll
+
+; Specialization constants narrower than 32 bits. Values arrive zero-extended
+; to 64 bits; any non-zero value of a boolean constant is true.
+
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+target triple = "spir64-unknown-unknown"
+
+@spirv.SpecConstant.6 = extern_weak constant i8, align 1, !spirv.SpecId !6
+@spirv.SpecConstant.7 = extern_weak constant i1, align 1, !spirv.SpecId !7
+@spirv.SpecConstant.8 = extern_weak constant i16, align 1, !spirv.SpecId !8
+
+; VALUE-NOT: spirv.SpecConstant
+; SECOND-NOT: spirv.SpecConstant
+
+define spir_kernel void @test_narrow(i32 addrspace(1)* %out, i8 %y, i16 %z, i32 %x) {
+entry:
+  %c = add i8 %y, ptrtoint (i8* @spirv.SpecConstant.6 to i8)
+  %cw = sext i8 %c to i32
+  %h = mul i16 %z, ptrtoint (i16* @spirv.SpecConstant.8 to i16)
+  %hw = zext i16 %h to i32
+  %sum = add i32 %cw, %hw
+  %b = select i1 ptrtoint (i1* @spirv.SpecConstant.7 to i1), i32 %sum, i32 %x
+  store i32 %b, i32 addrspace(1)* %out
+  ret void
+}
+
+; VALUE-LABEL: define spir_kernel void @test_narrow
+; VALUE: %c = add i8 %y, -128
+; VALUE: %h = mul i16 %z, 9029
+; VALUE: %b = select i1 true, i32 %sum, i32 %x
+
+; SECOND-LABEL: define spir_kernel void @test_narrow
+; SECOND: %c = add i8 %y, 1
+; SECOND: %h = mul i16 %z, 9
+; SECOND: %b = select i1 false, i32 %sum, i32 %x
+
+!6 = !{i32 6, i8 -1}
+!7 = !{i32 7, i1 false}
+!8 = !{i32 8, i16 4}
@@ -0,0 +1,73 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-specialize-spirv-constants -igc-spec-constant=2:0xFFF0,3:0x1234 -S %s -o %t.ll
+; RUN: FileCheck %s --check-prefix=VALUE --input-file=%t.ll
+; RUN: igc_opt -igc-specialize-spirv-constants -S %s -o %t.default.ll
+; RUN: FileCheck %s --check-prefix=DEFAULT --input-file=%t.default.ll
+
+; Conversions of specialization constants, as translated from OpSpecConstantOp
+; with OpSConvert/OpUConvert, used both by instructions and by a global
+; initializer. They must fold to plain constants once the value is known.
+
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+target triple = "spir64-unknown-unknown"
+
+@spirv.SpecConstant.2 = extern_weak constant i16, align 1, !spirv.SpecId !2
+@spirv.SpecConstant.3 = extern_weak constant i32, align 1, !spirv.SpecId !3
+@table = addrspace(2) constant [2 x i32] [i32 ptrtoint (i32* @spirv.SpecConstant.3 to i32), i32 sext (i16 ptrtoint (i16* @spirv.SpecConstant.2 to i16) to i32)]
+
+; VALUE-NOT: spirv.SpecConstant
+; VALUE: @table = addrspace(2) constant [2 x i32] [i32 4660, i32 -16]
+; DEFAULT-NOT: spirv.SpecConstant
+; DEFAULT: @table = addrspace(2) constant [2 x i32] [i32 100, i32 -3]
+
+define spir_kernel void @test_convert(i32 addrspace(1)* %out, i64 addrspace(1)* %out64, i8 addrspace(1)* %out8, i32 %x, i8 %y) {
+entry:
+  %s = add i32 %x, sext (i16 ptrtoint (i16* @spirv.SpecConstant.2 to i16) to i32)
+  store i32 %s, i32 addrspace(1)* %out
+  %z = add i32 %x, zext (i16 ptrtoint (i16* @spirv.SpecConstant.2 to i16) to i32)
+  store i32 %z, i32 addrspace(1)* %out
+  %w = add i64 0, sext (i32 ptrtoint (i32* @spirv.SpecConstant.3 to i32) to i64)
+  store i64 %w, i64 addrspace(1)* %out64
+  %t = add i8 %y, trunc (i32 ptrtoint (i32* @spirv.SpecConstant.3 to i32) to i8)
+  store i8 %t, i8 addrspace(1)* %out8
+  ret void
+}
+
+; VALUE-LABEL: define spir_kernel void @test_convert
+; VALUE: %s = add i32 %x, -16
+; VALUE: %z = add i32 %x, 65520
+; VALUE: %w = add i64 0, 4660
+; VALUE: %t = add i8 %y, 52
+
+; DEFAULT-LABEL: define spir_kernel void @test_convert
+; DEFAULT: %s = add i32 %x, -3
+; DEFAULT: %z = add i32 %x, 65533
+; DEFAULT: %w = add i64 0, 100
+; DEFAULT: %t = add i8 %y, 100
+
+!2 = !{i32 2, i16 -3}
+!3 = !{i32 3, i32 100}
@@ -140,7 +140,9 @@ void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
     if (IGC_IS_FLAG_ENABLED(DumpLLVMIR))
     {
         pContext->getMetaDataUtils()->save(*pContext->getLLVMContext());
-        serialize(*(pContext->getModuleMetaData()), pContext->getModule());
+        // Dumps keep the readable form so that they can be inspected and
+        // used for shader override.
+        serialize(*(pContext->getModuleMetaData()), pContext->getModule(), true);
         using namespace IGC::Debug;
         auto name =
             DumpName(IGC::Debug::GetShaderOutputName())
@@ -170,11 +172,21 @@ void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
             fclose(fp);
             errs() << "Override shader: " << fileName << "\n";
             Module* mod = parseIRFile(fileName, Err, *pContext->getLLVMContext()).release();
-            if (mod)
+            ModuleMetaData overrideMD;
+            if (mod && !deserialize(overrideMD, mod))
+            {
+                // Keep compiling the original module rather than one whose
+                // metadata could not be read.
+                std::string str = "ModuleMetaData blob was written by a different compiler.\n";
+                errs() << str;
+                appendToShaderOverrideLogFile(fileName, str.c_str());
+                delete mod;
+            }
+            else if (mod)
             {
                 pContext->deleteModule();
                 pContext->setModule(mod);
-                deserialize(*(pContext->getModuleMetaData()), mod);
+                *(pContext->getModuleMetaData()) = overrideMD;
                 appendToShaderOverrideLogFile(fileName, "OVERRIDEN: ");
             }
             else
@@ -6,12 +6,141 @@
 #include <llvm/ADT/StringRef.h>
 #include <llvm/Support/Casting.h>
 #include <llvm/ADT/StringSwitch.h>
+#include <llvm/ADT/DenseMap.h>
 #include "common/LLVMWarningsPop.hpp"
+#include "common/igc_regkeys.hpp"
 
 #include <iostream>
+#include "Probe/Assertion.h"
 
 using namespace llvm;
 
+// Writer for the compact form of ModuleMetaData: field values in declaration
+// order, integers LEB128 encoded, and LLVM values as indices into a side table
+// of ValueAsMetadata so that they follow RAUW and deletion as in the MDNode
+// form.
+class MDBlobWriter
+{
+public:
+    void writeUnsigned(uint64_t x)
+    {
+        do
+        {
+            unsigned char byte = x & 0x7f;
+            x >>= 7;
+            m_bytes.push_back(x ? (byte | 0x80) : byte);
+        } while (x);
+    }
+
+    void writeSigned(int64_t x)
+    {
+        writeUnsigned(((uint64_t)x << 1) ^ (uint64_t)(x >> 63));
+    }
+
+    void writeBytes(const void* data, size_t size)
+    {
+        m_bytes.append((const char*)data, size);
+    }
+
+    void writeValue(Value* val)
+    {
+        if (val == nullptr)
+        {
+            writeUnsigned(0);
+            return;
+        }
+        auto it = m_valueIds.insert(std::make_pair(val, (unsigned)m_values.size() + 1));
+        if (it.second)
+        {
+            m_values.push_back(ValueAsMetadata::get(val));
+        }
+        writeUnsigned(it.first->second);
+    }
+
+    StringRef bytes() const { return m_bytes; }
+    ArrayRef<Metadata*> values() const { return m_values; }
+
+private:
+    std::string m_bytes;
+    std::vector<Metadata*> m_values;
+    DenseMap<Value*, unsigned> m_valueIds;
+};
+
+class MDBlobReader
+{
+public:
+    MDBlobReader(StringRef bytes, MDNode* values) : m_bytes(bytes), m_values(values) {}
+
+    uint64_t readUnsigned()
+    {
+        uint64_t x = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            if (m_pos >= m_bytes.size())
+            {
+                m_overrun = true;
+                return 0;
+            }
+            unsigned char byte = m_bytes[m_pos++];
+            x |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+        return x;
+    }
+
+    int64_t readSigned()
+    {
+        uint64_t x = readUnsigned();
+        return (int64_t)(x >> 1) ^ -(int64_t)(x & 1);
+    }
+
+    void readBytes(void* data, size_t size)
+    {
+        if (m_pos + size > m_bytes.size())
+        {
+            m_overrun = true;
+            memset(data, 0, size);
+            return;
+        }
+        memcpy(data, m_bytes.data() + m_pos, size);
+        m_pos += size;
+    }
+
+    StringRef readString(size_t size)
+    {
+        if (m_pos + size > m_bytes.size())
+        {
+            m_overrun = true;
+            return StringRef();
+        }
+        StringRef s = m_bytes.substr(m_pos, size);
+        m_pos += size;
+        return s;
+    }
+
+    Value* readValue()
+    {
+        uint64_t id = readUnsigned();
+        if (id == 0 || id > m_values->getNumOperands())
+        {
+            return nullptr;
+        }
+        auto* pVal = dyn_cast_or_null<ValueAsMetadata>(m_values->getOperand((unsigned)id - 1).get());
+        return pVal ? pVal->getValue() : nullptr;
+    }
+
+    bool valid() const { return !m_overrun && m_pos == m_bytes.size(); }
+
+private:
+    StringRef m_bytes;
+    MDNode* m_values;
+    size_t m_pos = 0;
+    bool m_overrun = false;
+};
+
 //(non-autogen)function prototypes
 MDNode* CreateNode(unsigned char i, Module* module, StringRef name);
 MDNode* CreateNode(int i, Module* module, StringRef name);
@@ -53,6 +182,44 @@ void readNode(std::map<Key, Value> &funcMD, MDNode* node);
 template<typename T>
 void readNode(T &t, MDNode* node, StringRef name);
 
+void writeBlob(bool b, MDBlobWriter& writer);
+void writeBlob(char c, MDBlobWriter& writer);
+void writeBlob(unsigned char c, MDBlobWriter& writer);
+void writeBlob(int x, MDBlobWriter& writer);
+void writeBlob(unsigned x, MDBlobWriter& writer);
+void writeBlob(uint64_t x, MDBlobWriter& writer);
+void writeBlob(float f, MDBlobWriter& writer);
+void writeBlob(const std::string &s, MDBlobWriter& writer);
+void writeBlob(Value* val, MDBlobWriter& writer);
+void writeBlob(Function* funcPtr, MDBlobWriter& writer);
+void writeBlob(GlobalVariable* globalVar, MDBlobWriter& writer);
+void writeBlob(StructType* Ty, MDBlobWriter& writer);
+template<typename T>
+void writeBlob(const std::vector<T> &vec, MDBlobWriter& writer);
+template<typename T, size_t s>
+void writeBlob(const std::array<T, s> &arr, MDBlobWriter& writer);
+template<typename Key, typename Value>
+void writeBlob(const std::map<Key, Value> &keyMD, MDBlobWriter& writer);
+
+void readBlob(bool &b, MDBlobReader& reader);
+void readBlob(char &c, MDBlobReader& reader);
+void readBlob(unsigned char &c, MDBlobReader& reader);
+void readBlob(int &x, MDBlobReader& reader);
+void readBlob(unsigned &x, MDBlobReader& reader);
+void readBlob(uint64_t &x, MDBlobReader& reader);
+void readBlob(float &f, MDBlobReader& reader);
+void readBlob(std::string &s, MDBlobReader& reader);
+void readBlob(Value* &val, MDBlobReader& reader);
+void readBlob(Function* &funcPtr, MDBlobReader& reader);
+void readBlob(GlobalVariable* &globalVar, MDBlobReader& reader);
+void readBlob(StructType* &Ty, MDBlobReader& reader);
+template<typename T>
+void readBlob(std::vector<T> &vec, MDBlobReader& reader);
+template<typename T, size_t s>
+void readBlob(std::array<T, s> &arr, MDBlobReader& reader);
+template<typename Key, typename Value>
+void readBlob(std::map<Key, Value> &keyMD, MDBlobReader& reader);
+
 //including auto-generated functions
 #include "MDNodeFunctions.gen"
 namespace IGC
@@ -345,17 +512,232 @@ void readNode(T &t, MDNode* node, StringRef name)
     }
 }
 
-void IGC::deserialize(IGC::ModuleMetaData &deserializeMD, const Module* module)
+void writeBlob(bool b, MDBlobWriter& writer)
+{
+    writer.writeUnsigned(b ? 1 : 0);
+}
+
+void writeBlob(char c, MDBlobWriter& writer)
+{
+    writer.writeBytes(&c, sizeof(c));
+}
+
+void writeBlob(unsigned char c, MDBlobWriter& writer)
+{
+    writer.writeBytes(&c, sizeof(c));
+}
+
+void writeBlob(int x, MDBlobWriter& writer)
+{
+    writer.writeSigned(x);
+}
+
+void writeBlob(unsigned x, MDBlobWriter& writer)
+{
+    writer.writeUnsigned(x);
+}
+
+void writeBlob(uint64_t x, MDBlobWriter& writer)
+{
+    writer.writeUnsigned(x);
+}
+
+void writeBlob(float f, MDBlobWriter& writer)
+{
+    writer.writeBytes(&f, sizeof(f));
+}
+
+void writeBlob(const std::string &s, MDBlobWriter& writer)
+{
+    writer.writeUnsigned(s.size());
+    writer.writeBytes(s.data(), s.size());
+}
+
+void writeBlob(Value* val, MDBlobWriter& writer)
+{
+    writer.writeValue(val);
+}
+
+void writeBlob(Function* funcPtr, MDBlobWriter& writer)
+{
+    writer.writeValue(funcPtr);
+}
+
+void writeBlob(GlobalVariable* globalVar, MDBlobWriter& writer)
+{
+    writer.writeValue(globalVar);
+}
+
+void writeBlob(StructType* Ty, MDBlobWriter& writer)
+{
+    writer.writeValue(Ty ? UndefValue::get(Ty) : nullptr);
+}
+
+template<typename T>
+void writeBlob(const std::vector<T> &vec, MDBlobWriter& writer)
+{
+    writer.writeUnsigned(vec.size());
+    for (auto &it : vec)
+    {
+        writeBlob(it, writer);
+    }
+}
+
+template<typename T, size_t s>
+void writeBlob(const std::array<T, s> &arr, MDBlobWriter& writer)
+{
+    for (auto &it : arr)
+    {
+        writeBlob(it, writer);
+    }
+}
+
+template<typename Key, typename Value>
+void writeBlob(const std::map<Key, Value> &keyMD, MDBlobWriter& writer)
+{
+    writer.writeUnsigned(keyMD.size());
+    for (auto &it : keyMD)
+    {
+        writeBlob(it.first, writer);
+        writeBlob(it.second, writer);
+    }
+}
+
+void readBlob(bool &b, MDBlobReader& reader)
+{
+    b = reader.readUnsigned() != 0;
+}
+
+void readBlob(char &c, MDBlobReader& reader)
+{
+    reader.readBytes(&c, sizeof(c));
+}
+
+void readBlob(unsigned char &c, MDBlobReader& reader)
+{
+    reader.readBytes(&c, sizeof(c));
+}
+
+void readBlob(int &x, MDBlobReader& reader)
+{
+    x = (int)reader.readSigned();
+}
+
+void readBlob(unsigned &x, MDBlobReader& reader)
+{
+    x = (unsigned)reader.readUnsigned();
+}
+
+void readBlob(uint64_t &x, MDBlobReader& reader)
+{
+    x = reader.readUnsigned();
+}
+
+void readBlob(float &f, MDBlobReader& reader)
+{
+    reader.readBytes(&f, sizeof(f));
+}
+
+void readBlob(std::string &s, MDBlobReader& reader)
+{
+    s = reader.readString((size_t)reader.readUnsigned()).str();
+}
+
+void readBlob(Value* &val, MDBlobReader& reader)
+{
+    val = reader.readValue();
+}
+
+void readBlob(Function* &funcPtr, MDBlobReader& reader)
+{
+    funcPtr = cast_or_null<Function>(reader.readValue());
+}
+
+void readBlob(GlobalVariable* &globalVar, MDBlobReader& reader)
+{
+    globalVar = cast_or_null<GlobalVariable>(reader.readValue());
+}
+
+void readBlob(StructType* &Ty, MDBlobReader& reader)
+{
+    Value* v = reader.readValue();
+    Ty = v ? cast<StructType>(v->getType()) : nullptr;
+}
+
+template<typename T>
+void readBlob(std::vector<T> &vec, MDBlobReader& reader)
+{
+    uint64_t size = reader.readUnsigned();
+    for (uint64_t i = 0; i < size; i++)
+    {
+        T vecEle;
+        readBlob(vecEle, reader);
+        vec.push_back(vecEle);
+    }
+}
+
+template<typename T, size_t s>
+void readBlob(std::array<T, s> &arr, MDBlobReader& reader)
+{
+    for (auto &it : arr)
+    {
+        readBlob(it, reader);
+    }
+}
+
+template<typename Key, typename Value>
+void readBlob(std::map<Key, Value> &keyMD, MDBlobReader& reader)
+{
+    uint64_t size = reader.readUnsigned();
+    for (uint64_t i = 0; i < size; i++)
+    {
+        std::pair<Key, Value> p;
+        readBlob(p.first, reader);
+        readBlob(p.second, reader);
+        keyMD.insert(p);
+    }
+}
+
+// Header of the compact form. MDBlobVersion covers the encoding above,
+// MDBlobLayoutVersion the declarations in MDFrameWork.h.
+static const uint32_t MDBlobMagic = 0x444d4749; // "IGMD"
+static const uint32_t MDBlobVersion = 1;
+
+static bool readModuleMDBlob(IGC::ModuleMetaData &deserializeMD, MDNode* moduleRoot)
+{
+    MDBlobReader reader(cast<MDString>(moduleRoot->getOperand(1))->getString(),
+        cast<MDNode>(moduleRoot->getOperand(2)));
+    uint32_t header[3] = {};
+    reader.readBytes(header, sizeof(header));
+    if (header[0] != MDBlobMagic || header[1] != MDBlobVersion || header[2] != MDBlobLayoutVersion)
+    {
+        return false;
+    }
+    readBlob(deserializeMD, reader);
+    return reader.valid();
+}
+
+bool IGC::deserialize(IGC::ModuleMetaData &deserializeMD, const Module* module)
 {
     IGC::ModuleMetaData temp;
     deserializeMD = temp;
     NamedMDNode* root = module->getNamedMetadata("IGCMetadata");
-    if (!root) { return; } //module has not been serialized with IGCMetadata yet
+    if (!root) { return true; } //module has not been serialized with IGCMetadata yet
     MDNode* moduleRoot = root->getOperand(0);
+    if (cast<MDString>(moduleRoot->getOperand(0))->getString() == "ModuleMDBlob")
+    {
+        if (!readModuleMDBlob(deserializeMD, moduleRoot))
+        {
+            deserializeMD = temp;
+            return false;
+        }
+        return true;
+    }
     readNode(deserializeMD, moduleRoot);
+    return true;
 }
 
-void IGC::serialize(const IGC::ModuleMetaData &moduleMD, Module* module)
+void IGC::serialize(const IGC::ModuleMetaData &moduleMD, Module* module, bool readable)
 {
     NamedMDNode* LLVMMetadata = module->getNamedMetadata("IGCMetadata");
     if(LLVMMetadata)
@@ -364,7 +746,35 @@ void IGC::serialize(const IGC::ModuleMetaData &moduleMD, Module* module)
         LLVMMetadata->dropAllReferences();
     }
     LLVMMetadata = module->getOrInsertNamedMetadata("IGCMetadata");
-    auto node = CreateNode(moduleMD, module, "ModuleMD");
+    if (readable)
+    {
+        auto node = CreateNode(moduleMD, module, "ModuleMD");
+        LLVMMetadata->addOperand(node);
+        return;
+    }
+
+    MDBlobWriter writer;
+    const uint32_t header[3] = { MDBlobMagic, MDBlobVersion, MDBlobLayoutVersion };
+    writer.writeBytes(header, sizeof(header));
+    writeBlob(moduleMD, writer);
+    Metadata* v[] =
+    {
+        MDString::get(module->getContext(), "ModuleMDBlob"),
+        MDString::get(module->getContext(), writer.bytes()),
+        MDNode::get(module->getContext(), writer.values()),
+    };
+    MDNode* node = MDNode::get(module->getContext(), v);
     LLVMMetadata->addOperand(node);
+
+    if (IGC_IS_FLAG_ENABLED(VerifyModuleMetaDataBlob))
+    {
+        // MDNodes are uniqued, so the MDNode forms of the original and the
+        // decoded metadata are the same node exactly when they round-trip.
+        IGC::ModuleMetaData decoded;
+        bool success = readModuleMDBlob(decoded, node);
+        IGC_ASSERT_MESSAGE(success, "ModuleMetaData blob could not be decoded");
+        IGC_ASSERT_MESSAGE(CreateNode(moduleMD, module, "ModuleMD") == CreateNode(decoded, module, "ModuleMD"),
+            "ModuleMetaData blob does not round-trip");
+    }
 }
 
@@ -202,6 +202,7 @@ namespace IGC
         bool FastRelaxedMath                            = false;
         bool DashGSpecified                             = false;
         bool FastCompilation                            = false;
+        unsigned CompileTimeBudgetMs                    = 0;
         bool UseScratchSpacePrivateMemory               = true;
         bool RelaxedBuiltins                            = false;
         bool SubgroupIndependentForwardProgressRequired = true;
@@ -365,7 +366,12 @@ namespace IGC
         unsigned int privateMemoryPerWI = 0;
         std::array<uint64_t, NUM_SHADER_RESOURCE_VIEW_SIZE> m_ShaderResourceViewMcsMask{};
     };
-    void serialize(const IGC::ModuleMetaData &moduleMD, llvm::Module* module);
-    void deserialize(IGC::ModuleMetaData &deserializedMD, const llvm::Module* module);
+    // By default ModuleMetaData is written as a compact binary blob; readable
+    // writes one MDNode per field, for IR dumps and tools that inspect it.
+    // deserialize accepts both. It returns false for a blob written by a
+    // different compiler build; deserializedMD then holds defaults that must
+    // not be compiled with.
+    void serialize(const IGC::ModuleMetaData &moduleMD, llvm::Module* module, bool readable = false);
+    bool deserialize(IGC::ModuleMetaData &deserializedMD, const llvm::Module* module);
 
 }
@@ -29,6 +29,7 @@
 import os
 import sys
 import errno
+import zlib
 
 # usage: autogen.py <path_to_MDFrameWork.h> <path_to_MDNodeFuncs.gen>
 __MDFrameWorkFile__ = sys.argv[1]
@@ -168,6 +169,16 @@ def printEnumReadCalls(enumName):
         output.write("        .Case(\""+ item + "\", IGC::"+ item + ")\n")
     output.write("        .Default((IGC::" + enumName + ")(0));\n")
 
+def printWriteBlobCalls(structName):
+    for item in structDataMembers:
+        item = item[:-1]
+        output.write("    writeBlob(" + structName + "Var" + "." + item + ", writer);\n")
+
+def printReadBlobCalls(structName):
+    for item in structDataMembers:
+        item = item[:-1]
+        output.write("    readBlob(" + structName + "Var" + "." + item + ", reader);\n")
+
 def emitCodeBlock(names, declType, fmtFn, extractFn, printFn):
     for item in names:
         foundStruct = False
@@ -227,10 +238,47 @@ def emitStructReadNode():
         return "void readNode( IGC::" + item + " &" + item + "Var," + " MDNode* node)\n"
     emitCodeBlock(structureNames, "struct", fmtFn, extractVars, printReadCalls)
 
+def emitEnumBlob():
+    for item in enumNames:
+        output.write("void writeBlob(IGC::" + item + " " + item + "Var, MDBlobWriter& writer)\n")
+        output.write("{\n")
+        output.write("    writer.writeUnsigned((uint64_t)" + item + "Var);\n")
+        output.write("}\n\n")
+        output.write("void readBlob(IGC::" + item + " &" + item + "Var, MDBlobReader& reader)\n")
+        output.write("{\n")
+        output.write("    " + item + "Var = (IGC::" + item + ")reader.readUnsigned();\n")
+        output.write("}\n\n")
+
+def emitStructWriteBlob():
+    def fmtFn(item):
+        return "void writeBlob(const IGC::" + item + "& " + item + "Var, MDBlobWriter& writer)\n"
+    emitCodeBlock(structureNames, "struct", fmtFn, extractVars, printWriteBlobCalls)
+
+def emitStructReadBlob():
+    def fmtFn(item):
+        return "void readBlob(IGC::" + item + " &" + item + "Var, MDBlobReader& reader)\n"
+    emitCodeBlock(structureNames, "struct", fmtFn, extractVars, printReadBlobCalls)
+
+# The compact form only stores field values in declaration order, so it is
+# stamped with a checksum of the declarations it was written with.
+def emitBlobLayoutVersion():
+    declarations = []
+    with open(__MDFrameWorkFile__, 'r') as file:
+        for line in file:
+            line = line.split("//")[0].strip()
+            if line != '':
+                declarations.append(line)
+    checksum = zlib.crc32(" ".join(declarations).encode()) & 0xffffffff
+    output.write("static const uint32_t MDBlobLayoutVersion = 0x%08x;\n\n" % checksum)
+
 def genCode():
     emitEnumCreateNode()
     emitStructCreateNode()
     emitEnumReadNode()
     emitStructReadNode()
+    emitBlobLayoutVersion()
+    emitEnumBlob()
+    emitStructWriteBlob()
+    emitStructReadBlob()
 
 genCode()
@@ -648,7 +648,13 @@ void BinaryEncodingIGA::DoAll()
         IGAKernel->appendBlock(currBB);
     }
 
-    std::list<std::pair<Instruction*, G4_INST*>> encodedInsts;
+    size_t numG4Insts = 0;
+    for (auto bb : kernel.fg)
+    {
+        numG4Insts += bb->size();
+    }
+    std::vector<std::pair<Instruction*, G4_INST*>> encodedInsts;
+    encodedInsts.reserve(numG4Insts);
     iga::Block *bbNew = nullptr;
     for (auto bb : this->kernel.fg)
     {
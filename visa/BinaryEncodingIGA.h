@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define _BINARYENCODINGIGA_H_
 
 #include <map>
+#include <unordered_map>
 #include "Gen4_IR.hpp"
 #include "iga/IGALibrary/IR/Kernel.hpp"
 #include "iga/IGALibrary/Models/Models.hpp"
@@ -71,7 +72,7 @@ private:
     iga::Instruction *encodeSendInstruction(G4_INST *inst);
     iga::Instruction *encodeSplitSendInstruction(G4_INST *inst);
 
-    std::map<G4_Label*, iga::Block*> labelToBlockMap;
+    std::unordered_map<G4_Label*, iga::Block*> labelToBlockMap;
 
     iga::ExecSize getIGAExecSize(int execSize) const
     {
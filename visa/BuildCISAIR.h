@@ -90,6 +90,7 @@ public:
     // Used for inline asm code generation
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaHeader, const std::string& visaText, const std::string& visaTextFile);
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaFile);
+    VISA_BUILDER_API virtual int ParseVISAInlineAsm(VISAKernel* kernel, const std::string& asmText);
     VISA_BUILDER_API virtual int WriteVISAHeader();
     VISA_BUILDER_API std::stringstream& GetAsmTextStream() { return m_ssIsaAsm; }
     VISA_BUILDER_API std::stringstream& GetAsmTextHeaderStream() { return m_ssIsaAsmHeader; }
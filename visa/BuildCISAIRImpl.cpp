@@ -644,6 +644,7 @@ int CISA_IR_Builder::WriteVISAHeader()
 typedef struct yy_buffer_state * YY_BUFFER_STATE;
 extern int CISAparse(CISA_IR_Builder *builder);
 extern YY_BUFFER_STATE CISA_scan_string(const char* yy_str);
+extern YY_BUFFER_STATE CISA_scan_buffer(char* base, size_t size);
 extern void CISA_delete_buffer(YY_BUFFER_STATE buf);
 
 int CISA_IR_Builder::ParseVISAText(const std::string& visaHeader, const std::string& visaText, const std::string& visaTextFile)
@@ -726,25 +727,74 @@ int CISA_IR_Builder::ParseVISAText(const std::string& visaFile)
 #else
     CISAout = fopen("/dev/null", "w");
 #endif
-    CISAin = fopen(visaFile.c_str(), "r");
-    if (!CISAin)
+    // Read the file in one go and let the scanner work on it in place rather
+    // than refilling its buffer through stdio.
+    FILE* visaIn = fopen(visaFile.c_str(), "r");
+    if (!visaIn)
     {
         assert(0 && "Failed to open file");
+        if (CISAout)
+        {
+            fclose(CISAout);
+            CISAout = nullptr;
+        }
         return VISA_FAILURE;
     }
+    std::vector<char> visaBuf;
+    char chunk[64 * 1024];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), visaIn)) > 0)
+    {
+        visaBuf.insert(visaBuf.end(), chunk, chunk + n);
+    }
+    fclose(visaIn);
+    // flex requires two terminating NULs on a buffer it scans in place
+    visaBuf.push_back('\0');
+    visaBuf.push_back('\0');
 
-    if (CISAparse(this) != 0)
+    YY_BUFFER_STATE fileBuf = CISA_scan_buffer(visaBuf.data(), visaBuf.size());
+    int status = CISAparse(this) != 0 ? VISA_FAILURE : VISA_SUCCESS;
+    CISA_delete_buffer(fileBuf);
+
+    if (CISAout)
     {
-        assert(0 && "Parsing visa text failed");
-        return VISA_FAILURE;
+        fclose(CISAout);
+        CISAout = nullptr;
     }
-    fclose(CISAin);
+    return status;
+#else
+    assert(0 && "Asm parsing not supported on this platform");
+    return VISA_FAILURE;
+#endif
+}
+
+// Parses an inline asm fragment into an already built kernel
+int CISA_IR_Builder::ParseVISAInlineAsm(VISAKernel* kernel, const std::string& asmText)
+{
+#if defined(__linux__) || defined(_WIN64) || defined(_WIN32)
+    assert(m_options.getOption(vISA_DirectInlineAsm) && "inline asm names were not recorded");
+#if defined(_WIN64) || defined(_WIN32)
+    CISAout = fopen("nul", "w");
+#else
+    CISAout = fopen("/dev/null", "w");
+#endif
+
+    // productions append to m_kernel; point it at the function being built
+    VISAKernelImpl* savedKernel = m_kernel;
+    m_kernel = static_cast<VISAKernelImpl*>(kernel);
+
+    YY_BUFFER_STATE asmBuf = CISA_scan_string(asmText.c_str());
+    int status = CISAparse(this) == 0 ? VISA_SUCCESS : VISA_FAILURE;
+    CISA_delete_buffer(asmBuf);
+    m_kernel = savedKernel;
 
     if (CISAout)
     {
         fclose(CISAout);
+        CISAout = nullptr;
     }
-    return VISA_SUCCESS;
+    assert(status == VISA_SUCCESS && "Parsing inline asm failed");
+    return status;
 #else
     assert(0 && "Asm parsing not supported on this platform");
     return VISA_FAILURE;
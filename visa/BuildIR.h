@@ -1262,6 +1262,19 @@ public:
         uint16_t width,
         uint16_t hstride)
     {
+        // Every source operand coming from the vISA builder asks for a region;
+        // answer the canonical ones without scanning the region pool.
+        if (width == 1 && hstride == 0)
+        {
+            switch (vstride)
+            {
+            case 0: return getRegionScalar();
+            case 1: return getRegionStride1();
+            case 2: return getRegionStride2();
+            case 4: return getRegionStride4();
+            default: break;
+            }
+        }
         return rgnpool.createRegion(vstride, width, hstride);
     }
 
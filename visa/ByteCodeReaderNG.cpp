@@ -73,13 +73,10 @@ struct RoutineContainer
         surfaceVarDecls(NULL),   surfaceVarsCount(0),
         labelVarDecls(NULL),     labelVarsCount(0),
         inputVarDecls(NULL),     inputVarsCount(0),
+        stringPool(NULL),
         majorVersion(0),
         minorVersion(0) { }
 
-    ~RoutineContainer()
-    {
-        stringPool.clear();
-    }
     VISA_GenVar**       generalVarDecls; unsigned   generalVarsCount;
     VISA_AddrVar**      addressVarDecls; unsigned   addressVarsCount;
     VISA_PredVar**    predicateVarDecls; unsigned predicateVarsCount;
@@ -88,7 +85,8 @@ struct RoutineContainer
     VISA_LabelOpnd**      labelVarDecls; unsigned     labelVarsCount;
     CISA_GEN_VAR**        inputVarDecls; unsigned     inputVarsCount;
 
-    vector<string> stringPool;
+    // aliases kernel_format_t::strings of the routine being read
+    const char**             stringPool;
 
     CISA_IR_Builder* builder = nullptr;
     VISAKernel*      kernelBuilder = nullptr;
@@ -1205,7 +1203,7 @@ static void readInstructionMisc(unsigned& bytePos, const char* buf, ISA_Opcode o
             bool is3Dot4Plus = versionInt >= getVersionAsInt(3, 4);
             uint32_t filenameIndex = is3Dot4Plus ? readPrimitiveOperandNG<uint32_t>(bytePos, buf) :
                 readPrimitiveOperandNG<uint16_t>(bytePos, buf);
-            const char* filename = container.stringPool[filenameIndex].c_str();
+            const char* filename = container.stringPool[filenameIndex];
             kernelBuilder->AppendVISAMiscFileInst((char*)filename);
             break;
         }
@@ -2156,21 +2154,18 @@ static void readRoutineNG(unsigned& bytePos, const char* buf, vISA::Mem_Manager&
 
     readVarBytes(majorVersion, minorVersion, header.string_count, bytePos, buf);
     header.strings = (const char**)mem.alloc(header.string_count * sizeof(char*));
-    container.stringPool.resize(header.string_count);
     for (unsigned i = 0; i < header.string_count; i++)
     {
-        char* str = (char*)mem.alloc(STRING_LEN);
-        unsigned j = 0;
-        while (buf[bytePos] != '\0' && j < STRING_LEN)
-        {
-            str[j++] = buf[bytePos++];
-        }
-        ASSERT_USER(j < STRING_LEN, "string exceeds the maximum length allowed");
-        str[j] = '\0';
-        bytePos++;
+        // copy each string at its actual length instead of a STRING_LEN slot
+        const char* src = &buf[bytePos];
+        size_t len = strnlen(src, STRING_LEN);
+        ASSERT_USER(len < STRING_LEN, "string exceeds the maximum length allowed");
+        char* str = (char*)mem.alloc(len + 1);
+        memcpy_s(str, len + 1, src, len + 1);
+        bytePos += (unsigned)len + 1;
         header.strings[i] = str;
-        container.stringPool[i] = str;
     }
+    container.stringPool = header.strings;
     readVarBytes(majorVersion, minorVersion, header.name_index, bytePos, buf);
 
     /// read general variables
@@ -2180,33 +2175,55 @@ static void readRoutineNG(unsigned& bytePos, const char* buf, vISA::Mem_Manager&
     container.generalVarDecls = (VISA_GenVar**)mem.alloc(sizeof(VISA_GenVar*) * (header.variable_count + numPreDefinedVars));
     container.generalVarsCount = (header.variable_count + numPreDefinedVars);
 
+    // General variables dominate the declaration section, so decode and
+    // validate the whole table first and then hand it to the builder in one
+    // pass, instead of interleaving field decoding with builder calls.
+    const bool wideVarIDs = getVersionAsInt(majorVersion, minorVersion) >= getVersionAsInt(3, 4);
     for (unsigned i = numPreDefinedVars; i < header.variable_count + numPreDefinedVars; i++)
     {
-        unsigned declID = i;
-        readVarBytes(majorVersion, minorVersion, header.variables[declID].name_index, bytePos, buf);
-        READ_CISA_FIELD(header.variables[declID].bit_properties, uint8_t , bytePos, buf);
-        READ_CISA_FIELD(header.variables[declID].num_elements  , uint16_t, bytePos, buf);
-        readVarBytes(majorVersion, minorVersion, header.variables[declID].alias_index, bytePos, buf);
-        READ_CISA_FIELD(header.variables[declID].alias_offset  , uint16_t, bytePos, buf);
+        var_info_t* var = &header.variables[i];
+        if (wideVarIDs)
+        {
+            READ_CISA_FIELD(var->name_index, uint32_t, bytePos, buf);
+        }
+        else
+        {
+            READ_CISA_FIELD(var->name_index, uint16_t, bytePos, buf);
+        }
+        READ_CISA_FIELD(var->bit_properties, uint8_t , bytePos, buf);
+        READ_CISA_FIELD(var->num_elements  , uint16_t, bytePos, buf);
+        if (wideVarIDs)
+        {
+            READ_CISA_FIELD(var->alias_index, uint32_t, bytePos, buf);
+        }
+        else
+        {
+            READ_CISA_FIELD(var->alias_index, uint16_t, bytePos, buf);
+        }
+        READ_CISA_FIELD(var->alias_offset  , uint16_t, bytePos, buf);
+        READ_CISA_FIELD(var->alias_scope_specifier, uint8_t, bytePos, buf);
+        READ_CISA_FIELD(var->attribute_count, uint8_t, bytePos, buf);
 
-        READ_CISA_FIELD(header.variables[declID].alias_scope_specifier, uint8_t, bytePos, buf);
+        var->attributes = (attribute_info_t*)mem.alloc(sizeof(attribute_info_t) * var->attribute_count);
+        readAttributesNG(majorVersion, minorVersion, bytePos, buf, header, var->attributes, var->attribute_count, mem);
+        var->dcl = NULL;
 
-        READ_CISA_FIELD(header.variables[declID].attribute_count, uint8_t, bytePos, buf);
+        ASSERT_USER(var->name_index < header.string_count, "Invalid name index for general variable");
+        ASSERT_USER(var->alias_index < i, "General variable aliases a variable declared after it");
+        assert(var->alias_scope_specifier == 0 && "file scope variables are no longer supported");
+    }
 
-        header.variables[declID].attributes = (attribute_info_t*)mem.alloc(sizeof(attribute_info_t) * header.variables[declID].attribute_count);
-        readAttributesNG(majorVersion, minorVersion, bytePos, buf, header, header.variables[declID].attributes, header.variables[declID].attribute_count, mem);
-        header.variables[declID].dcl = NULL;
+    for (unsigned i = numPreDefinedVars; i < header.variable_count + numPreDefinedVars; i++)
+    {
+        unsigned declID = i;
 
         /// VISA Builder Call
         var_info_t* var = &header.variables[declID];
         VISA_GenVar* decl = NULL;
         VISA_Type  varType  = (VISA_Type)  ((var->bit_properties     ) & 0xF);
         VISA_Align varAlign = (VISA_Align) ((var->bit_properties >> 4) & 0x7);
-        uint8_t aliasScopeSpecifier = header.variables[declID].alias_scope_specifier;
         int status = VISA_SUCCESS;
 
-        assert(aliasScopeSpecifier == 0 && "file scope variables are no longer supported");
-
         {
             VISA_GenVar* parentDecl = NULL;
             uint16_t aliasOffset = 0;
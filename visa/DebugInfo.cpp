@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "FlowGraph.h"
 #include "BuildIR.h"
 #include <map>
+#include <unordered_set>
 #include "Common_ISA_framework.h"
 #include "VISAKernel.h"
 #include "BitSet.h"
@@ -514,7 +515,7 @@ bool KernelDebugInfo::isMissingVISAId(unsigned int id)
         computeMissingVISAIds();
     }
 
-    return (missingVISAIds.find(id) != missingVISAIds.end());
+    return id < missingVISAIds.size() && missingVISAIds[id];
 }
 
 void KernelDebugInfo::computeMissingVISAIds()
@@ -533,7 +534,7 @@ void KernelDebugInfo::computeMissingVISAIds()
         }
     }
 
-    std::vector<bool> seenVISAIds(maxCISAId+1, false);
+    missingVISAIds.assign(maxCISAId + 1, true);
 
     for (auto bb : getKernel().fg)
     {
@@ -541,19 +542,11 @@ void KernelDebugInfo::computeMissingVISAIds()
         {
             if (inst->getCISAOff() != UNMAPPABLE_VISA_INDEX)
             {
-                seenVISAIds[inst->getCISAOff()] = true;
+                missingVISAIds[inst->getCISAOff()] = false;
             }
         }
     }
 
-    for (unsigned int i = 0, size = seenVISAIds.size(); i < size; i++)
-    {
-        if (!seenVISAIds[i])
-        {
-            missingVISAIds.insert(i);
-        }
-    }
-
     missingVISAIdsComputed = true;
 }
 
@@ -573,6 +566,13 @@ void KernelDebugInfo::generateGenISAToVISAIndex()
     // This is used to emit debug_ranges section in IGC.
     // Inserting entries per Gen ISA offset guarantees
     // all instructions will be present in the vector.
+    size_t numInsts = 0;
+    for (auto bb : kernel->fg)
+    {
+        numInsts += bb->size();
+    }
+    genISAOffsetToVISAIndex.reserve(genISAOffsetToVISAIndex.size() + numInsts);
+
     for (auto bb : kernel->fg)
     {
         for (auto inst : *bb)
@@ -622,9 +622,9 @@ void KernelDebugInfo::generateByteOffsetMapping(std::list<G4_BB*>& stackCallEntr
     // passed - stackCallEntryBBs that holds entryBBs of all stack
     // call functions part of this compilation unit.
 
-    bool done = false;
     unsigned int maxVISAIndex = 0;
     uint64_t maxGenIsaOffset = 0;
+    std::unordered_set<G4_BB*> stackCallEntries(stackCallEntryBBs.begin(), stackCallEntryBBs.end());
     // Now traverse CFG, create pair of CISA byte offset, gen binary offset and push to vector
     for (BB_LIST_ITER bb_it = kernel->fg.begin(), bbEnd = kernel->fg.end(); bb_it != bbEnd; bb_it++)
     {
@@ -632,27 +632,13 @@ void KernelDebugInfo::generateByteOffsetMapping(std::list<G4_BB*>& stackCallEntr
 
         int isaPrevByteOffset = -1;
 
-        if (kernel->fg.builder->getIsKernel())
-        {
-            auto entryBBend = stackCallEntryBBs.end();
-            for(auto entryBBIt = stackCallEntryBBs.begin();
-                entryBBIt != entryBBend;
-                entryBBIt++)
-            {
-                if(bb == (*entryBBIt))
-                {
-                    // Since we are traversing BBs in layout
-                    // order, we will parse all kernel BBs
-                    // first and as soon as we reach entryBB
-                    // of first stack call function, we stop
-                    // processing.
-                    done = true;
-                    break;
-                }
-            }
-        }
-
-        if(done == true)
+        // Since we are traversing BBs in layout
+        // order, we will parse all kernel BBs
+        // first and as soon as we reach entryBB
+        // of first stack call function, we stop
+        // processing.
+        if (kernel->fg.builder->getIsKernel() &&
+            stackCallEntries.count(bb))
         {
             break;
         }
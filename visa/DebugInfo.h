@@ -177,9 +177,9 @@ private:
     // Store reloc_offset of gen binary. This is emitted out to debug info.
     uint32_t reloc_offset;
 
-    // Store set of missing VISA ids as this helps consolidate live-intervals
-    // to save compile time.
-    std::set<unsigned int> missingVISAIds;
+    // Store missing VISA ids, indexed by VISA id, as this helps consolidate
+    // live-intervals to save compile time.
+    std::vector<bool> missingVISAIds;
     bool missingVISAIdsComputed;
 
     std::vector<std::pair<unsigned int, unsigned int>> genISAOffsetToVISAIndex;
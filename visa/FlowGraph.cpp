@@ -6492,121 +6492,80 @@ static bool checkVisitID(FuncInfo* func1, FuncInfo* func2)
 //
 // Find dominators for each function
 //
-void FlowGraph::findDominators(std::map<FuncInfo*, std::set<FuncInfo*>>& domMap)
+//
+// Compute the immediate dominator of each function in the call graph.
+// sortedFuncTable is in reverse topological order with the kernel last, so
+// walking it backwards visits every caller before its callees and one
+// Cooper-Harvey-Kennedy pass is enough; dominators always sit at a larger
+// index than the functions they dominate.
+//
+void FlowGraph::findDominators()
 {
-    std::map<FuncInfo*, std::set<FuncInfo*>> predMap;
-
-    for (auto func : sortedFuncTable)
+    unsigned int funcTableSize = static_cast<unsigned int> (sortedFuncTable.size());
+    std::unordered_map<FuncInfo*, unsigned int> funcIndex;
+    std::vector<std::vector<unsigned int>> callers(funcTableSize);
+    for (unsigned int i = 0; i < funcTableSize; i++)
     {
-        if (func == kernelInfo)
-        {
-            std::set<FuncInfo*> initSet;
-            initSet.insert(kernelInfo);
-            domMap.insert(std::make_pair(kernelInfo, initSet));
-        }
-        else
+        funcIndex[sortedFuncTable[i]] = i;
+    }
+    for (unsigned int i = 0; i < funcTableSize; i++)
+    {
+        for (auto callee : sortedFuncTable[i]->getCallees())
         {
-            std::set<FuncInfo*> initSet;
-            for (auto funcTmp : sortedFuncTable)
-            {
-                initSet.insert(funcTmp);
-            }
-            domMap.insert(std::make_pair(func, initSet));
+            callers[funcIndex[callee]].push_back(i);
         }
+    }
+
+    funcIDoms.assign(funcTableSize, UINT_MAX);
+    if (funcTableSize == 0)
+    {
+        return;
+    }
+    funcIDoms[funcTableSize - 1] = funcTableSize - 1;
 
-        for (auto callee : func->getCallees())
+    for (unsigned int funcID = funcTableSize - 1; funcID-- != 0;)
+    {
+        unsigned int idom = UINT_MAX;
+        for (auto caller : callers[funcID])
         {
-            std::map<FuncInfo*, std::set<FuncInfo*>>::iterator predMapIter = predMap.find(callee);
-            if (predMapIter == predMap.end())
+            if (funcIDoms[caller] == UINT_MAX)
+                continue;
+            if (idom == UINT_MAX)
             {
-                std::set<FuncInfo*> initSet;
-                initSet.insert(func);
-                predMap.insert(std::make_pair(callee, initSet));
+                idom = caller;
+                continue;
             }
-            else
+            unsigned int finger = caller;
+            while (finger != idom)
             {
-                (*predMapIter).second.insert(func);
+                while (finger < idom)
+                    finger = funcIDoms[finger];
+                while (idom < finger)
+                    idom = funcIDoms[idom];
             }
         }
+        funcIDoms[funcID] = idom;
     }
-
-    bool changed = false;
-    do
-    {
-        changed = false;
-
-        unsigned int funcTableSize = static_cast<unsigned int> (sortedFuncTable.size());
-        unsigned int funcID = funcTableSize - 1;
-        do
-        {
-            funcID--;
-            FuncInfo* func = sortedFuncTable[funcID];
-
-            std::map<FuncInfo*, std::set<FuncInfo*>>::iterator predMapIter = predMap.find(func);
-            if (predMapIter != predMap.end())
-            {
-                std::set<FuncInfo*>& domSet = (*domMap.find(func)).second;
-                std::set<FuncInfo*> oldDomSet = domSet;
-                domSet.clear();
-                domSet.insert(func);
-
-                std::vector<unsigned int> funcVec(funcTableSize);
-                for (unsigned int i = 0; i < funcTableSize; i++)
-                {
-                    funcVec[i] = 0;
-                }
-
-                std::set<FuncInfo*>& predSet = (*predMapIter).second;
-                for (auto pred : predSet)
-                {
-                    for (auto predDom : (*domMap.find(pred)).second)
-                    {
-                        unsigned int domID = (predDom->getScopeID() == UINT_MAX) ? funcTableSize - 1 : predDom->getScopeID() - 1;
-                        funcVec[domID]++;
-                    }
-                }
-
-                unsigned int predSetSize = static_cast<unsigned int> (predSet.size());
-                for (unsigned int i = 0; i < funcTableSize; i++)
-                {
-                    if (funcVec[i] == predSetSize)
-                    {
-                        FuncInfo* newFunc = sortedFuncTable[i];
-                        domSet.insert(newFunc);
-                        if (oldDomSet.find(newFunc) == oldDomSet.end())
-                            changed = true;
-                    }
-                }
-
-                if (oldDomSet.size() != domSet.size())
-                {
-                    changed = true;
-                }
-            }
-        } while (funcID != 0);
-
-    } while (changed);
 }
 
 //
 // Check if func1 is a dominator of func2
 //
-static bool checkDominator(FuncInfo* func1, FuncInfo* func2, std::map<FuncInfo*, std::set<FuncInfo*>>& domMap)
+bool FlowGraph::checkDominator(FuncInfo* func1, FuncInfo* func2) const
 {
-    std::map<FuncInfo*, std::set<FuncInfo*>>::iterator domMapIter = domMap.find(func2);
-
-    if (domMapIter != domMap.end())
+    unsigned int funcTableSize = static_cast<unsigned int> (funcIDoms.size());
+    auto getIndex = [funcTableSize](FuncInfo* func)
     {
-        std::set<FuncInfo*> domSet = (*domMapIter).second;
-        std::set<FuncInfo*>::iterator domSetIter = domSet.find(func1);
+        return (func->getScopeID() == UINT_MAX) ? funcTableSize - 1 : func->getScopeID() - 1;
+    };
 
-        if (domSetIter != domSet.end())
-        {
-            return true;
-        }
+    unsigned int domID = getIndex(func1);
+    unsigned int funcID = getIndex(func2);
+    while (funcID < domID)
+    {
+        funcID = funcIDoms[funcID];
     }
-
-    return false;
+    return funcID == domID;
 }
 
 //
@@ -6634,19 +6593,15 @@ unsigned int FlowGraph::resolveVarScope(G4_Declare* dcl, FuncInfo* func)
     {
         // This is safe if the global variable usage is
         // self-contained under the calling function
-        std::map<FuncInfo*, std::set<FuncInfo*>> domMap;
-
-        findDominators(domMap);
-
         FuncInfo* oldFunc = sortedFuncTable[oldID - 1];
 
         if (checkVisitID(func, oldFunc) &&
-            checkDominator(func, oldFunc, domMap))
+            checkDominator(func, oldFunc))
         {
             return newID;
         }
         else if (checkVisitID(oldFunc, func) &&
-            checkDominator(oldFunc, func, domMap))
+            checkDominator(oldFunc, func))
         {
             return oldID;
         }
@@ -6659,9 +6614,9 @@ unsigned int FlowGraph::resolveVarScope(G4_Declare* dcl, FuncInfo* func)
             {
                 FuncInfo* currFunc = sortedFuncTable[funcID];
                 if (checkVisitID(currFunc, func) &&
-                    checkDominator(currFunc, func, domMap) &&
+                    checkDominator(currFunc, func) &&
                     checkVisitID(currFunc, oldFunc) &&
-                    checkDominator(currFunc, oldFunc, domMap))
+                    checkDominator(currFunc, oldFunc))
                 {
                     return currFunc->getScopeID();
                 }
@@ -6753,6 +6708,11 @@ void FlowGraph::markScope()
         id++;
     }
 
+    if (builder->getOption(vISA_EnableGlobalScopeAnalysis))
+    {
+        findDominators();
+    }
+
     for (auto func : sortedFuncTable)
     {
         markVarScope(func->getBBList(), func);
@@ -7482,202 +7442,217 @@ void FuncInfo::dump() const
     std::cerr << "\n";
 }
 
-PostDom::PostDom(G4_Kernel& k) : kernel(k)
+void DomTree::run()
 {
-    auto numBBs = k.fg.size();
-    postDoms.resize(numBBs);
-    immPostDoms.resize(numBBs);
-}
+    unsigned numBBs = 0;
+    for (auto bb : kernel.fg)
+    {
+        numBBs = std::max(numBBs, bb->getId() + 1);
+    }
+    iDoms.assign(numBBs, nullptr);
+    children.assign(numBBs, std::vector<G4_BB*>());
+    rpoIndex.assign(numBBs, UINT_MAX);
+    dfsIn.assign(numBBs, 0);
+    dfsOut.assign(numBBs, 0);
 
-void PostDom::run()
-{
-    exitBB = nullptr;
-    for (auto bb_rit = kernel.fg.rbegin(); bb_rit != kernel.fg.rend(); bb_rit++)
+    root = nullptr;
+    if (postDom)
     {
-        auto bb = *bb_rit;
-        if (bb->size() > 0)
+        for (auto bb_rit = kernel.fg.rbegin(); bb_rit != kernel.fg.rend(); bb_rit++)
         {
-            auto lastInst = bb->back();
-            if (lastInst->isEOT())
+            auto bb = *bb_rit;
+            if (bb->size() > 0 && bb->back()->isEOT())
             {
-                exitBB = bb;
+                root = bb;
                 break;
             }
         }
+        MUST_BE_TRUE(root != nullptr, "Exit BB not found!");
     }
-
-    MUST_BE_TRUE(exitBB != nullptr, "Exit BB not found!");
-
-    postDoms[exitBB->getId()] = { exitBB };
-    std::unordered_set<G4_BB*> allBBs;
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
+    else
     {
-        auto bb = *I;
-        allBBs.insert(bb);
+        root = kernel.fg.getEntryBB();
+        MUST_BE_TRUE(root != nullptr, "Entry BB not found!");
     }
 
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
+    // Post-order walk from the root, done iteratively as unrolled kernels can
+    // have thousands of blocks.
+    std::vector<G4_BB*> rpo;
+    std::vector<bool> visited(numBBs, false);
+    std::vector<std::pair<G4_BB*, BB_LIST_CITER>> stack;
+    visited[root->getId()] = true;
+    stack.emplace_back(root, getSuccs(root).cbegin());
+    while (!stack.empty())
     {
-        auto bb = *I;
-        if (bb != exitBB)
+        G4_BB* bb = stack.back().first;
+        if (stack.back().second != getSuccs(bb).cend())
         {
-            postDoms[bb->getId()] = allBBs;
+            G4_BB* succ = *stack.back().second++;
+            if (!visited[succ->getId()])
+            {
+                visited[succ->getId()] = true;
+                stack.emplace_back(succ, getSuccs(succ).cbegin());
+            }
+        }
+        else
+        {
+            rpo.push_back(bb);
+            stack.pop_back();
         }
     }
+    std::reverse(rpo.begin(), rpo.end());
+    for (unsigned i = 0, size = (unsigned)rpo.size(); i < size; i++)
+    {
+        rpoIndex[rpo[i]->getId()] = i;
+    }
 
-    // Actual post dom computation
-    bool change = true;
-    while (change)
+    iDoms[root->getId()] = root;
+    bool changed = true;
+    while (changed)
     {
-        change = false;
-        for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
+        changed = false;
+        for (unsigned i = 1, size = (unsigned)rpo.size(); i < size; i++)
         {
-            auto bb = *I;
-            if (bb == exitBB)
-                continue;
-
-            std::unordered_set<G4_BB*> tmp = { bb };
-            // Compute intersection of pdom of successors
-            std::unordered_map<G4_BB*, unsigned int> numInstances;
-            for (auto succs : bb->Succs)
+            G4_BB* bb = rpo[i];
+            G4_BB* newIDom = nullptr;
+            for (auto pred : getPreds(bb))
             {
-                auto& pdomSucc = postDoms[succs->getId()];
-                for (auto pdomSuccBB : pdomSucc)
-                {
-                    auto it = numInstances.find(pdomSuccBB);
-                    if (it == numInstances.end())
-                        numInstances.insert(std::make_pair(pdomSuccBB, 1));
-                    else
-                        it->second = it->second + 1;
-                }
+                // skip preds not processed yet and unreachable ones
+                if (iDoms[pred->getId()] == nullptr)
+                    continue;
+                newIDom = newIDom ? intersect(pred, newIDom) : pred;
             }
-
-            // Common BBs appear in numInstances map with second value == bb->Succs count
-            for (auto commonBBs : numInstances)
+            if (iDoms[bb->getId()] != newIDom)
             {
-                if (commonBBs.second == bb->Succs.size())
-                    tmp.insert(commonBBs.first);
+                iDoms[bb->getId()] = newIDom;
+                changed = true;
             }
+        }
+    }
 
-            // Check if postDom set changed for bb in current iter
-            if (tmp.size() != postDoms[bb->getId()].size())
-            {
-                postDoms[bb->getId()] = tmp;
-                change = true;
-                continue;
-            }
-            else
-            {
-                auto& pdomBB = postDoms[bb->getId()];
-                for (auto tmpBB : tmp)
-                {
-                    if (pdomBB.find(tmpBB) == pdomBB.end())
-                    {
-                        postDoms[bb->getId()] = tmp;
-                        change = true;
-                        break;
-                    }
-                    if (change)
-                        break;
-                }
-            }
+    for (auto bb : rpo)
+    {
+        if (bb != root)
+        {
+            children[iDoms[bb->getId()]->getId()].push_back(bb);
         }
     }
 
-    updateImmPostDom();
+    // Number the tree so that bb1 dominates bb2 iff bb2's interval nests in bb1's.
+    unsigned num = 0;
+    std::vector<std::pair<G4_BB*, size_t>> walk;
+    dfsIn[root->getId()] = num++;
+    walk.emplace_back(root, 0);
+    while (!walk.empty())
+    {
+        G4_BB* bb = walk.back().first;
+        auto& kids = children[bb->getId()];
+        if (walk.back().second < kids.size())
+        {
+            G4_BB* kid = kids[walk.back().second++];
+            dfsIn[kid->getId()] = num++;
+            walk.emplace_back(kid, 0);
+        }
+        else
+        {
+            dfsOut[bb->getId()] = num++;
+            walk.pop_back();
+        }
+    }
 }
 
-std::unordered_set<G4_BB*>& PostDom::getPostDom(G4_BB* bb)
+G4_BB* DomTree::intersect(G4_BB* bb1, G4_BB* bb2) const
 {
-    return postDoms[bb->getId()];
+    while (bb1 != bb2)
+    {
+        while (rpoIndex[bb1->getId()] > rpoIndex[bb2->getId()])
+        {
+            bb1 = iDoms[bb1->getId()];
+        }
+        while (rpoIndex[bb2->getId()] > rpoIndex[bb1->getId()])
+        {
+            bb2 = iDoms[bb2->getId()];
+        }
+    }
+    return bb1;
 }
 
-void PostDom::dumpImmDom()
+bool DomTree::dominates(G4_BB* bb1, G4_BB* bb2) const
 {
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
+    if (!isReachable(bb1) || !isReachable(bb2))
     {
-        auto bb = *I;
-        printf("BB%d - ", bb->getId());
-        auto& pdomBBs = immPostDoms[bb->getId()];
-        for (auto pdomBB : pdomBBs)
-        {
-            printf("BB%d", pdomBB->getId());
-            if (pdomBB->getLabel())
-            {
-                printf(" (%s)", pdomBB->getLabel()->getLabel());
-            }
-            printf(", ");
-        }
-        printf("\n");
+        return false;
     }
+    return dfsIn[bb1->getId()] <= dfsIn[bb2->getId()] &&
+        dfsOut[bb2->getId()] <= dfsOut[bb1->getId()];
 }
 
-std::vector<G4_BB*>& PostDom::getImmPostDom(G4_BB* bb)
+G4_BB* DomTree::getCommonDom(G4_BB* bb1, G4_BB* bb2) const
 {
-    return immPostDoms[bb->getId()];
+    if (!isReachable(bb1) || !isReachable(bb2))
+    {
+        return nullptr;
+    }
+    return intersect(bb1, bb2);
 }
 
-void PostDom::updateImmPostDom()
+void DomTree::dump() const
 {
-    // Update immPostDom vector with correct ordering
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
+    for (auto bb : kernel.fg)
     {
-        auto bb = *I;
+        printf("BB%d - ", bb->getId());
+        if (G4_BB* idom = getIDom(bb))
         {
-            auto& postDomBBs = postDoms[bb->getId()];
-            auto& immPostDomBB = immPostDoms[bb->getId()];
-            immPostDomBB.resize(postDomBBs.size());
-            immPostDomBB[0] = bb;
+            printf("%s: BB%d", postDom ? "ipdom" : "idom", idom->getId());
+        }
+        printf("\n");
+    }
+}
 
-            for (auto pdomBB : postDomBBs)
+void PostDom::dumpImmDom() const
+{
+    for (auto bb : kernel.fg)
+    {
+        printf("BB%d - ", bb->getId());
+        for (G4_BB* pdomBB = bb; pdomBB; pdomBB = (pdomBB == root) ? nullptr : getIDom(pdomBB))
+        {
+            printf("BB%d", pdomBB->getId());
+            if (pdomBB->getLabel())
             {
-                if (pdomBB == bb)
-                    continue;
-
-                immPostDomBB[postDomBBs.size() - postDoms[pdomBB->getId()].size()] = pdomBB;
+                printf(" (%s)", pdomBB->getLabel()->getLabel());
             }
+            printf(", ");
         }
+        printf("\n");
     }
 }
 
-G4_BB* PostDom::getCommonImmDom(std::unordered_set<G4_BB*>& bbs)
+G4_BB* PostDom::getCommonImmDom(const std::unordered_set<G4_BB*>& bbs) const
 {
     if (bbs.size() == 0)
         return nullptr;
 
-    unsigned int maxId = (*bbs.begin())->getId();
-
-    auto commonImmDoms = getImmPostDom(*bbs.begin());
+    unsigned int maxId = 0;
+    G4_BB* commonPDom = nullptr;
     for (auto bb : bbs)
     {
-        if (bb->getId() > maxId)
-            maxId = bb->getId();
-
-        auto& postDomBB = postDoms[bb->getId()];
-        for (unsigned int i = 0, size = commonImmDoms.size(); i != size; i++)
-        {
-            if (commonImmDoms[i])
-            {
-                if (postDomBB.find(commonImmDoms[i]) == postDomBB.end())
-                {
-                    commonImmDoms[i] = nullptr;
-                }
-            }
-        }
+        maxId = std::max(maxId, bb->getId());
+        commonPDom = commonPDom ? getCommonDom(commonPDom, bb) : bb;
+        if (!commonPDom)
+            return root;
     }
 
-    // Return first imm dom that is not a BB from bbs set
-    for (unsigned int i = 0, size = commonImmDoms.size(); i != size; i++)
+    // The common post dominators are the ancestors of commonPDom; return the
+    // nearest one that is lexically last and not an empty block.
+    for (G4_BB* pdomBB = commonPDom; pdomBB; pdomBB = (pdomBB == root) ? nullptr : getIDom(pdomBB))
     {
-        if (commonImmDoms[i] &&
-            // Common imm pdom must be lexically last BB
-            commonImmDoms[i]->getId() >= maxId &&
-            ((commonImmDoms[i]->size() > 1 && commonImmDoms[i]->front()->isLabel()) ||
-            (commonImmDoms[i]->size() > 0 && !commonImmDoms[i]->front()->isLabel())))
+        if (pdomBB->getId() >= maxId &&
+            ((pdomBB->size() > 1 && pdomBB->front()->isLabel()) ||
+            (pdomBB->size() > 0 && !pdomBB->front()->isLabel())))
         {
-            return commonImmDoms[i];
+            return pdomBB;
         }
     }
 
-    return exitBB;
+    return root;
 }
@@ -705,6 +705,8 @@ public:
 
     std::vector<FuncInfo*> sortedFuncTable;     // subroutines in reverse topographical order (leaf at top)
                                                 // kernelInfo is the last element with invalid func id
+    std::vector<unsigned> funcIDoms;            // call-graph immediate dominator of each sortedFuncTable entry,
+                                                // as an index into sortedFuncTable
 
     FuncInfo* kernelInfo;                       // the call info for the kernel function
 
@@ -1113,7 +1115,8 @@ public:
 
     void traverseFunc(FuncInfo* func, unsigned int *ptr);
     void topologicalSortCallGraph();
-    void findDominators(std::map<FuncInfo*, std::set<FuncInfo*>>& domMap);
+    void findDominators();
+    bool checkDominator(FuncInfo* func1, FuncInfo* func2) const;
     unsigned int resolveVarScope(G4_Declare* dcl, FuncInfo* func);
     void markVarScope(std::vector<G4_BB*>& BBList, FuncInfo* func);
     void markScope();
@@ -1727,23 +1730,56 @@ public:
     }
 };
 
-class PostDom
+//
+// Dominator (or post-dominator) tree of the G4 CFG. Immediate dominators are
+// computed with the Cooper-Harvey-Kennedy algorithm over a reverse post-order
+// of the blocks, so only one idom per block is stored. Dominance queries are
+// answered in O(1) from the pre/post numbering of a DFS walk of the tree.
+// Post-dominators are rooted at the EOT block. Blocks not reachable from the
+// root have no idom and neither dominate nor are dominated by anything.
+//
+class DomTree
 {
 public:
-    PostDom(G4_Kernel&);
-    std::unordered_set<G4_BB*>& getPostDom(G4_BB*);
-    std::vector<G4_BB*>& getImmPostDom(G4_BB*);
+    DomTree(G4_Kernel& k, bool isPostDom = false) : kernel(k), postDom(isPostDom) {}
     void run();
-    void dumpImmDom();
-    G4_BB* getCommonImmDom(std::unordered_set<G4_BB*>&);
 
-private:
+    G4_BB* getRoot() const { return root; }
+    // The root is its own idom.
+    G4_BB* getIDom(G4_BB* bb) const { return iDoms[bb->getId()]; }
+    const std::vector<G4_BB*>& getChildren(G4_BB* bb) const { return children[bb->getId()]; }
+    bool isReachable(G4_BB* bb) const { return rpoIndex[bb->getId()] != UINT_MAX; }
+    // Return true if bb1 (post-)dominates bb2. A block dominates itself.
+    bool dominates(G4_BB* bb1, G4_BB* bb2) const;
+    // Nearest block that (post-)dominates both bb1 and bb2.
+    G4_BB* getCommonDom(G4_BB* bb1, G4_BB* bb2) const;
+    void dump() const;
+
+protected:
     G4_Kernel& kernel;
-    G4_BB* exitBB = nullptr;
-    std::vector<std::unordered_set<G4_BB*>> postDoms;
-    std::vector<std::vector<G4_BB*>> immPostDoms;
+    const bool postDom;
+    G4_BB* root = nullptr;
 
-    void updateImmPostDom();
+private:
+    std::vector<G4_BB*> iDoms;
+    std::vector<std::vector<G4_BB*>> children;
+    std::vector<unsigned> rpoIndex;     // UINT_MAX for unreachable blocks
+    std::vector<unsigned> dfsIn;
+    std::vector<unsigned> dfsOut;
+
+    const BB_LIST& getSuccs(G4_BB* bb) const { return postDom ? bb->Preds : bb->Succs; }
+    const BB_LIST& getPreds(G4_BB* bb) const { return postDom ? bb->Succs : bb->Preds; }
+    G4_BB* intersect(G4_BB* bb1, G4_BB* bb2) const;
+};
+
+class PostDom : public DomTree
+{
+public:
+    PostDom(G4_Kernel& k) : DomTree(k, true) {}
+    G4_BB* getImmPostDom(G4_BB* bb) const { return getIDom(bb); }
+    bool postDominates(G4_BB* bb1, G4_BB* bb2) const { return dominates(bb1, bb2); }
+    void dumpImmDom() const;
+    G4_BB* getCommonImmDom(const std::unordered_set<G4_BB*>&) const;
 };
 }
 #endif
@@ -1111,34 +1111,6 @@ void SWSB::genSWSBPatchInfo() {
 #endif
 }
 
-void SWSB::getDominators(Dom* dom)
-{
-    //BBVector[bb->getId()]->tokenAssigned = true;
-    bool changed = true;
-
-    while (changed)
-    {
-        changed = false;
-
-        for (size_t i = 0; i < BBVector.size(); i++)
-        {
-            BitSet currDoms = (*BBVector[i]->dominators);
-            if (dom->iDoms[i] != BBVector[i]->getBB())
-            {
-                currDoms |= (*BBVector[dom->iDoms[i]->getId()]->dominators);
-            }
-
-            if (currDoms != (*BBVector[i]->dominators))
-            {
-                changed = true;
-                (*BBVector[i]->dominators) = currDoms;
-            }
-        }
-    }
-
-    return;
-}
-
 //
 //Entry to the software scoreboard generator
 //
@@ -1166,20 +1138,18 @@ void SWSB::SWSBGenerator()
     if (fg.builder->getOptions()->getOption(vISA_GlobalTokenAllocation) ||
         fg.builder->getOptions()->getOption(vISA_DistPropTokenAllocation))
     {
-        Dom dom(kernel, mem);
-        dom.runIDOM();  //We can use dom.runDOM() as well, which compute the dominance first. However, it has issue with function call.
+        domTree.run();
 
         //Build dom tree
         for (size_t i = 0; i < BBVector.size(); i++)
         {
             G4_BB* bb = BBVector[i]->getBB();
-            BBVector[i]->dominators = new (mem)BitSet(BBVector.size(), false);
-            BBVector[i]->dominators->set(i, true);
+            G4_BB* idom = domTree.getIDom(bb);
 
-            if (dom.iDoms[bb->getId()] != bb)
+            if (idom != nullptr && idom != bb)
             {
-                BBVector[dom.iDoms[bb->getId()]->getId()]->domSuccs.push_back(BBVector[i]);
-                BBVector[i]->domPreds.push_back(BBVector[dom.iDoms[bb->getId()]->getId()]);
+                BBVector[idom->getId()]->domSuccs.push_back(BBVector[i]);
+                BBVector[i]->domPreds.push_back(BBVector[idom->getId()]);
             }
         }
 
@@ -1191,9 +1161,8 @@ void SWSB::SWSBGenerator()
             }
         }
 
-        getDominators(&dom);
 #ifdef DEBUG_VERBOSE_ON
-        dumpImmDom(&dom);
+        dumpImmDom();
 #endif
     }
 
@@ -3841,7 +3810,7 @@ void SWSB::tokenEdgePrune(unsigned& prunedEdgeNum,
                                            fg.builder->getOptions()->getOption(vISA_DistPropTokenAllocation)) ||
                                         !((fg.builder->getOptions()->getOption(vISA_GlobalTokenAllocation) ||
                                             fg.builder->getOptions()->getOption(vISA_DistPropTokenAllocation)) &&
-                                          BBVector[node->getBBID()]->dominators->isSet(predNode->getBBID()))))
+                                          domTree.dominates(BBVector[predNode->getBBID()]->getBB(), BBVector[node->getBBID()]->getBB()))))
                                     {
                                         prunedDiffBBEdgeNum++;
 #ifdef DEBUG_VERBOSE_ON
@@ -5149,7 +5118,7 @@ void SWSB::dumpTokenLiveInfo()
             for (size_t k = 0; k < BBVector.size(); k++)
             {
                 if (k != i &&
-                    BBVector[i]->dominators->isSet(k))
+                    domTree.dominates(BBVector[k]->getBB(), BBVector[i]->getBB()))
                 {
                     std::cerr << "#BB" << k << ", ";
                 }
@@ -6154,248 +6123,7 @@ void vISA::singleInstStallSWSB(G4_Kernel* kernel, uint32_t instID, uint32_t endI
     }
 }
 
-G4_BB* Dom::InterSect(G4_BB* bb, int i, int k)
-{
-    G4_BB* finger1 = immDoms[bb->getId()][i];
-    G4_BB* finger2 = immDoms[bb->getId()][k];
-
-    while ((finger1 != finger2) &&
-        (finger1 != nullptr) &&
-        (finger2 != nullptr))
-    {
-        if (finger1->getPreId() == finger2->getPreId())
-        {
-            assert(finger1 == kernel.fg.getEntryBB() || finger2 == kernel.fg.getEntryBB());
-            return kernel.fg.getEntryBB();
-        }
-
-        while ((iDoms[finger1->getId()] != nullptr) &&
-            (finger1->getPreId() > finger2->getPreId()))
-        {
-            finger1 = iDoms[finger1->getId()];
-            immDoms[bb->getId()][i] = finger1;
-        }
-
-        while ((iDoms[finger2->getId()] != nullptr) &&
-            (finger2->getPreId() > finger1->getPreId()))
-        {
-            finger2 = iDoms[finger2->getId()];
-            immDoms[bb->getId()][k] = finger2;
-        }
-
-        if ((iDoms[finger2->getId()] == nullptr) ||
-            (iDoms[finger1->getId()] == nullptr))
-        {
-            break;
-        }
-    }
-
-    if (finger1 == finger2)
-    {
-        return finger1;
-    }
-    else if (finger1->getPreId() > finger2->getPreId())
-    {
-        return finger2;
-    }
-    else
-    {
-        return finger1;
-    }
-}
-
-/*
-* An improvement on the algorithm from "A Simple, Fast Dominance Algorithm"
-* 1. Single pred assginment.
-* 2. To reduce the back trace in the intersect function, a temp buffer for predictor of each nodes is used to record the back trace result.
-*/
-void Dom::runIDOM()
-{
-    iDoms.resize(kernel.fg.size());
-    immDoms.resize(kernel.fg.size());
-
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
-    {
-        auto bb = *I;
-        iDoms[bb->getId()] = nullptr;
-        immDoms[bb->getId()].resize(bb->Preds.size());
-
-        size_t i = 0;
-        for (auto pred : bb->Preds)
-        {
-            immDoms[bb->getId()][i] = pred;
-            i++;
-        }
-    }
-
-    entryBB = kernel.fg.getEntryBB();
-    iDoms[entryBB->getId()] = { entryBB };
-
-    // Actual dom computation
-    bool change = true;
-    while (change)
-    {
-        change = false;
-        for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
-        {
-            auto bb = *I;
-            if (bb == entryBB)
-                continue;
-
-            if (bb->Preds.size() == 1)
-            {
-                if (iDoms[bb->getId()] == nullptr)
-                {
-                    iDoms[bb->getId()] = (*bb->Preds.begin());
-                    change = true;
-                }
-                else
-                {
-                    assert(iDoms[bb->getId()] == (*bb->Preds.begin()));
-                }
-            }
-            else
-            {
-                G4_BB* tmpIdom = nullptr;
-                int i = 0;
-                for (auto pred : bb->Preds)
-                {
-                    if (iDoms[pred->getId()] != nullptr)
-                    {
-                        tmpIdom = pred;
-                        break;
-                    }
-                    i++;
-                }
-
-                if (tmpIdom != nullptr)
-                {
-                    int k = 0;
-                    for (auto pred : bb->Preds)
-                    {
-                        if (k == i)
-                        {
-                            k++;
-                            continue;
-                        }
-
-                        if (iDoms[pred->getId()] != nullptr)
-                        {
-                            tmpIdom = InterSect(bb, i, k);
-                        }
-                        k++;
-                    }
-
-                    if (iDoms[bb->getId()] == nullptr ||
-                        iDoms[bb->getId()] != tmpIdom)
-                    {
-                        iDoms[bb->getId()] = tmpIdom;
-                        change = true;
-                    }
-                }
-            }
-        }
-    }
-
-    return;
-}
-
-void Dom::runDOM()
-{
-    Doms.resize(kernel.fg.size());
-    entryBB = kernel.fg.getEntryBB();
-
-    MUST_BE_TRUE(entryBB != nullptr, "Entry BB not found!");
-
-    Doms[entryBB->getId()] = { entryBB };
-    std::unordered_set<G4_BB*> allBBs;
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
-    {
-        auto bb = *I;
-        allBBs.insert(bb);
-    }
-
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
-    {
-        auto bb = *I;
-        if (bb != entryBB)
-        {
-            Doms[bb->getId()] = allBBs;
-        }
-    }
-
-    // Actual dom computation
-    bool change = true;
-    while (change)
-    {
-        change = false;
-        for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
-        {
-            auto bb = *I;
-            if (bb == entryBB)
-                continue;
-
-            std::unordered_set<G4_BB*> tmp = { bb };
-
-            // Compute intersection of dom of preds
-            std::unordered_map<G4_BB*, unsigned int> numInstances;
-
-            //
-            for (auto preds : bb->Preds)
-            {
-                auto& domPred = Doms[preds->getId()];
-                for (auto domPredBB : domPred)
-                {
-                    auto it = numInstances.find(domPredBB);
-                    if (it == numInstances.end())  //Not found
-                        numInstances.insert(std::make_pair(domPredBB, 1));
-                    else
-                        it->second = it->second + 1;
-                }
-            }
-
-            // Common BBs appear in numInstances map with second value == bb->Preds count
-            for (auto commonBBs : numInstances)
-            {
-                if (commonBBs.second == bb->Preds.size()) //same size means the bb from all preds.
-                    tmp.insert(commonBBs.first);
-            }
-
-            // Check if Dom set changed for bb in current iter
-            if (tmp.size() != Doms[bb->getId()].size())  //Same size
-            {
-                Doms[bb->getId()] = tmp;
-                change = true;
-                continue;
-            }
-            else //Same
-            {
-                auto& domBB = Doms[bb->getId()];
-                for (auto tmpBB : tmp)
-                {
-                    if (domBB.find(tmpBB) == domBB.end()) //Same BB
-                    {
-                        Doms[bb->getId()] = tmp;
-                        change = true;
-                        break;
-                    }
-                    if (change)
-                        break;
-                }
-            }
-        }
-    }
-
-    updateImmDom();
-}
-
-
-std::unordered_set<G4_BB*>& Dom::getDom(G4_BB* bb)
-{
-    return Doms[bb->getId()];
-}
-
-void SWSB::dumpImmDom(Dom* dom)
+void SWSB::dumpImmDom()
 {
     for (auto I = fg.cbegin(), E = fg.cend(); I != E; ++I)
     {
@@ -6410,9 +6138,9 @@ void SWSB::dumpImmDom(Dom* dom)
         {
             printf("BB%d, ", pred->getId());
         }
-        auto& idomBB = dom->iDoms[bb->getId()];
+        auto idomBB = domTree.getIDom(bb);
         assert(idomBB != nullptr);
-        printf("\n\t iDOM: BB%d -- DOM SUCC: ", dom->iDoms[bb->getId()]->getId());
+        printf("\n\t iDOM: BB%d -- DOM SUCC: ", idomBB->getId());
         for (BB_SWSB_LIST_ITER it = BBVector[bb->getId()]->domSuccs.begin(); it != BBVector[bb->getId()]->domSuccs.end(); it++)
         {
             printf("BB%d, ", (*it)->getBB()->getId());
@@ -6421,96 +6149,6 @@ void SWSB::dumpImmDom(Dom* dom)
     }
 }
 
-std::vector<G4_BB*>& Dom::getImmDom(G4_BB* bb)
-{
-    return immDoms[bb->getId()];
-}
-
-void Dom::updateImmDom()
-{
-    BitSet** domBits = (BitSet * *)mem.alloc(sizeof(BitSet*) * kernel.fg.size());
-
-    for (size_t i = 0; i < kernel.fg.size(); i++)
-    {
-        domBits[i] = new (mem)BitSet(unsigned(kernel.fg.size()), false);
-    }
-
-    // Update immDom vector with correct ordering
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
-    {
-        auto bb = *I;
-        auto& DomBBs = Doms[bb->getId()];
-
-        for (auto domBB : DomBBs)
-        {
-            domBits[bb->getId()]->set(domBB->getId(), true);
-        }
-    }
-
-    iDoms.resize(kernel.fg.size());
-    for (auto I = kernel.fg.cbegin(), E = kernel.fg.cend(); I != E; ++I)
-    {
-        auto bb = *I;
-        auto& DomBBs = Doms[bb->getId()];
-        BitSet tmpBits = *domBits[bb->getId()];
-        tmpBits.set(bb->getId(), false);
-        iDoms[bb->getId()] = bb;
-
-        for (auto domBB : DomBBs)
-        {
-            if (domBB == bb)
-                continue;
-
-            if (tmpBits == *domBits[domBB->getId()])
-            {
-                iDoms[bb->getId()] = domBB;
-            }
-        }
-    }
-}
-
-G4_BB* Dom::getCommonImmDom(std::unordered_set<G4_BB*>& bbs)
-{
-    if (bbs.size() == 0)
-        return nullptr;
-
-    unsigned int maxId = (*bbs.begin())->getId();
-
-    auto commonImmDoms = getImmDom(*bbs.begin());
-    for (auto bb : bbs)
-    {
-        if (bb->getId() > maxId)
-            maxId = bb->getId();
-
-        auto& DomBB = Doms[bb->getId()];
-        for (unsigned int i = 0, size = commonImmDoms.size(); i != size; i++)
-        {
-            if (commonImmDoms[i])
-            {
-                if (DomBB.find(commonImmDoms[i]) == DomBB.end())
-                {
-                    commonImmDoms[i] = nullptr;
-                }
-            }
-        }
-    }
-
-    // Return first imm dom that is not a BB from bbs set
-    for (unsigned int i = 0, size = commonImmDoms.size(); i != size; i++)
-    {
-        if (commonImmDoms[i] &&
-            // Common imm pdom must be lexically last BB
-            commonImmDoms[i]->getId() >= maxId &&
-            ((commonImmDoms[i]->size() > 1 && commonImmDoms[i]->front()->isLabel()) ||
-            (commonImmDoms[i]->size() > 0 && !commonImmDoms[i]->front()->isLabel())))
-        {
-            return commonImmDoms[i];
-        }
-    }
-
-    return entryBB;
-}
-
 bool G4_INST::isDFInstruction() const
 {
     G4_Operand* dst = getDst();
@@ -916,8 +916,6 @@ namespace vISA
         SBBitSets *send_kill_scalar;
         BitSet* send_WAW_may_kill;
 
-        BitSet* dominators;
-
         //For token reduction
         BitSet   *liveInTokenNodes;
         BitSet   *liveOutTokenNodes;
@@ -1057,36 +1055,6 @@ namespace vISA
     typedef std::vector<SWSB_LOOP> LOOP_SWSB_VECTOR;
     typedef LOOP_SWSB_VECTOR::iterator LOOP_SWSB_VECTOR_ITER;
 
-    class Dom
-    {
-    public:
-        std::vector<G4_BB*> iDoms;
-        Dom(G4_Kernel& k, vISA::Mem_Manager& m) : kernel(k), mem(m)
-        {
-        }
-
-        ~Dom()
-        {
-        };
-
-        std::unordered_set<G4_BB*>& getDom(G4_BB*);
-        std::vector<G4_BB*>& getImmDom(G4_BB*);
-        G4_BB* getCommonImmDom(std::unordered_set<G4_BB*>& bbs);
-        void runDOM();
-        G4_BB* InterSect(G4_BB* bb, int i, int k);
-        void runIDOM();
-        void dumpImmDom();
-
-    private:
-        vISA::Mem_Manager& mem;
-        G4_Kernel& kernel;
-        G4_BB* entryBB = nullptr;
-        std::vector<std::unordered_set<G4_BB*>> Doms;
-        std::vector<std::vector<G4_BB*>> immDoms;
-
-        void updateImmDom();
-    };
-
     class SWSB_TOKEN_PROFILE {
         uint32_t tokenInstructionCount;
         uint32_t tokenReuseCount;
@@ -1208,6 +1176,7 @@ namespace vISA
         int topIndex;
 
         std::map<G4_Label*, G4_BB_SB*> labelToBlockMap;
+        DomTree domTree;
         BitSet   **allTokenNodesMap;
         SWSB_TOKEN_PROFILE* tokenProfile;
 
@@ -1220,7 +1189,7 @@ namespace vISA
 
         void removePredsEdges(SBNode * node, SBNode * pred);
 
-        void dumpImmDom(Dom* dom);
+        void dumpImmDom();
 
         void setDefaultDistanceAtFirstInstruction();
 
@@ -1292,12 +1261,10 @@ namespace vISA
         // Fast-composite support.
         void genSWSBPatchInfo();
 
-        void getDominators(Dom* dom);
-
 
     public:
         SWSB(G4_Kernel &k, vISA::Mem_Manager& m)
-            : kernel(k), fg(k.fg), mem(m)
+            : kernel(k), fg(k.fg), mem(m), domTree(k)
         {
             globalSendNum = 0;
             syncInstCount = 0;
@@ -225,6 +225,15 @@ public:
     bool setNameIndexMap(const std::string &name, CISA_GEN_VAR *, bool unique = false);
     void pushIndexMapScopeLevel();
     void popIndexMapScopeLevel();
+    // With vISA_DirectInlineAsm, make decl reachable under the name
+    // getVarName() hands out so inline asm text can refer to it.
+    template <typename T> void addInlineAsmName(T *decl)
+    {
+        if (m_options->getOption(vISA_DirectInlineAsm) && !m_options->getOption(vISA_isParseMode))
+        {
+            setNameIndexMap(getVarName(decl), decl, true);
+        }
+    }
 
     unsigned int getIndexFromLabelName(const std::string &label_name);
     VISA_LabelOpnd * getLabelOpndFromLabelName(const std::string &label_name);
@@ -970,7 +979,7 @@ private:
     // maps a variable name to the var pointer
     // unique vars are unique to the entire program
     // general vars must be unique within the same scope, but can be redefined across scopes
-    typedef std::map<std::string, CISA_GEN_VAR *> GenDeclNameToVarMap;
+    typedef std::unordered_map<std::string, CISA_GEN_VAR *> GenDeclNameToVarMap;
     std::vector<GenDeclNameToVarMap> m_GenNamedVarMap;
     GenDeclNameToVarMap m_UniqueNamedVarMap;
     // std::vector<VISAScope> m_GenNamedVarMap;
@@ -669,6 +669,11 @@ int VISAKernelImpl::CISABuildPreDefinedDecls()
                     setNameIndexMap(varName, decl, true);
                 }
             }
+            if (m_options->getOption(vISA_DirectInlineAsm))
+            {
+                setNameIndexMap(getPredefinedVarString(predefId), decl, true);
+                setNameIndexMap(getVarName((VISA_GenVar*)decl), decl, true);
+            }
         }
         addVarInfoToList(decl);
     }
@@ -690,6 +695,10 @@ int VISAKernelImpl::CISABuildPreDefinedDecls()
             decl->stateVar.name_index = addStringPool(std::string(name));
             setNameIndexMap(std::string(name), decl, true);
         }
+        else if (m_options->getOption(vISA_DirectInlineAsm))
+        {
+            setNameIndexMap(vISAPreDefSurf[i].name, decl, true);
+        }
         if (IS_GEN_BOTH_PATH)
         {
             if (i == PREDEFINED_SURFACE_T252)
@@ -728,6 +737,10 @@ void VISAKernelImpl::createBindlessSampler()
         m_bindlessSampler->stateVar.name_index = addStringPool(std::string(name));
         setNameIndexMap(std::string(name), m_bindlessSampler, true);
     }
+    else if (m_options->getOption(vISA_DirectInlineAsm))
+    {
+        setNameIndexMap(BINDLESS_SAMPLER_NAME, m_bindlessSampler, true);
+    }
     if (IS_GEN_BOTH_PATH)
     {
         m_bindlessSampler->stateVar.dcl = m_builder->getBuiltinBindlessSampler();
@@ -960,6 +973,7 @@ int VISAKernelImpl::CreateVISAGenVar(
         }
     }
     decl->index = m_var_info_count++;
+    addInlineAsmName(decl);
 
 #if defined(MEASURE_COMPILATION_TIME) && defined(TIME_BUILDER)
     stopTimer(TIMER_VISA_BUILDER_CREATE_VAR);
@@ -986,6 +1000,7 @@ int VISAKernelImpl::CreateVISAAddrVar(VISA_AddrVar *& decl, const char *varName,
     generateVariableName(decl->type, varName);
 
     decl->index = m_addr_info_count++;
+    addInlineAsmName(decl);
     if (IS_GEN_BOTH_PATH)
     {
         addr->dcl = m_builder->createDeclareNoLookup(
@@ -1042,6 +1057,7 @@ int VISAKernelImpl::CreateVISAPredVar(VISA_PredVar *& decl, const char* varName,
     pred_info_t * pred = &decl->predVar;
 
     decl->index = COMMON_ISA_NUM_PREDEFINED_PRED + this->m_pred_info_count++;
+    addInlineAsmName(decl);
     pred->attribute_count = 0;
     if (IS_GEN_BOTH_PATH)
     {
@@ -1104,9 +1120,11 @@ int VISAKernelImpl::CreateStateVar(CISA_GEN_VAR *&decl, Common_ISA_Var_Class typ
     {
     case SAMPLER_VAR:
         decl->index = this->m_sampler_count++;
+        addInlineAsmName((VISA_SamplerVar*)decl);
         break;
     case SURFACE_VAR:
         decl->index = this->m_surface_count++;
+        addInlineAsmName((VISA_SurfaceVar*)decl);
         break;
     default:
         assert(0);
@@ -1224,6 +1242,12 @@ int VISAKernelImpl::CreateVISALabelVar(VISA_LabelOpnd *& opnd, const char* name,
             }
         }
     }
+    if (!IS_VISA_BOTH_PATH && kind == LABEL_BLOCK && m_options->getOption(vISA_DirectInlineAsm))
+    {
+        // inline asm may branch to labels it defines; the vISA path records
+        // names below, GEN-only has to do it here
+        setLabelNameIndexMap(std::string(name), opnd);
+    }
     if(IS_VISA_BOTH_PATH)
     {
         label_info_t *lbl = (label_info_t *)m_mem.alloc(sizeof(label_info_t));
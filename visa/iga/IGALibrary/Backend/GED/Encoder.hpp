@@ -36,15 +36,13 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../ErrorHandler.hpp"
 #include "../../Timer/Timer.hpp"
 
-#include <list>
 #include <map>
+#include <unordered_map>
 
 
 
 namespace iga
 {
-    typedef list<Block *, std_arena_based_allocator<Block*>> BlockList;
-
     class EncoderBase : protected GEDBitProcessor
     {
     public:
@@ -228,7 +226,7 @@ namespace iga
                 : inst(i), gedInst(gi), bits(bs) { }
         };
         vector<JumpPatch>                         m_needToPatch;
-        std::map<const Block *, int32_t>          m_blockToOffsetMap;
+        std::unordered_map<const Block *, int32_t> m_blockToOffsetMap;
         std::map<const Instruction *, int32_t>    m_instPcs; // maps instruction ID to PC
 
     public:
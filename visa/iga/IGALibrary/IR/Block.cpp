@@ -32,7 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Block.hpp"
 #include "Instruction.hpp"
 
-#include <set>
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -43,8 +43,11 @@ struct BlockInference
 {
     MemManager *allocator;
 
-    std::map<int32_t, Block *> &blockStarts;
-    std::set<int32_t>           instStarts;
+    BlockStarts                &blockStarts;
+    // the block start PCs seen so far (unsorted and possibly duplicated)
+    std::vector<int32_t>        blockPcs;
+    // instruction PCs (sorted before lookup)
+    std::vector<int32_t>        instStarts;
 
     struct ResolvedTarget {
         Loc     loc; // instruction location
@@ -55,18 +58,35 @@ struct BlockInference
     };
     std::vector<ResolvedTarget> resolved;
 
-    BlockInference(std::map<int32_t, Block *> &bs, MemManager *a)
+    // a label operand that gets patched once the blocks are created
+    struct LabelRef {
+        Instruction *inst;
+        int          srcIx;
+        int32_t      targetPc;
+        LabelRef(Instruction *_inst, int _srcIx, int32_t _targetPc)
+            : inst(_inst), srcIx(_srcIx), targetPc(_targetPc) { }
+    };
+    std::vector<LabelRef> labelRefs;
+
+    BlockInference(BlockStarts &bs, MemManager *a)
         : allocator(a), blockStarts(bs) { }
 
-    Block *getBlock(int32_t pc) {
-        auto itr = blockStarts.find(pc);
-        if (itr == blockStarts.end()) {
-            Block *blk      = new (allocator) Block(pc);
-            blockStarts[pc] = blk;
-            return blk;
-        } else {
-            return itr->second;
-        }
+    void addBlockStart(int32_t pc) {
+        blockPcs.push_back(pc);
+    }
+
+    // binary search over the sorted block index
+    Block *getBlock(int32_t pc) const {
+        auto itr = std::lower_bound(
+            blockStarts.begin(),
+            blockStarts.end(),
+            pc,
+            [](const std::pair<int32_t,Block*> &bs, int32_t p) {
+                return bs.first < p;
+            });
+        IGA_ASSERT(itr != blockStarts.end() && itr->first == pc,
+            "BlockInference: missing block start");
+        return itr->second;
     }
 
     void replaceNumericLabel(
@@ -98,23 +118,25 @@ struct BlockInference
             } else {
                 resolved.emplace_back(inst->getLoc(), srcIx, targetPc);
             }
-            src.setLabelSource(getBlock(targetPc), src.getType());
+            addBlockStart(targetPc);
+            labelRefs.emplace_back(inst, srcIx, targetPc);
         }
     }
 
     void run(ErrorHandler &errHandler, int32_t binaryLength, InstList &insts)
     {
         // define start block to ensure at least one block exists
-        (void)getBlock(0);
+        addBlockStart(0);
 
+        instStarts.reserve(insts.size());
         int32_t pc = 0;
         for (Instruction *inst : insts) {
-            instStarts.insert(inst->getPC());
+            instStarts.push_back(inst->getPC());
             int32_t instLen = inst->hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
             if (inst->getOpSpec().isBranching() || inst->isMovWithLabel()) {
                 // all branching instructions can redirect to next instruction
                 // start a new block after this one
-                (void)getBlock(pc + instLen);
+                addBlockStart(pc + instLen);
                 // replace src0
                 replaceNumericLabel(
                     errHandler,
@@ -135,11 +157,25 @@ struct BlockInference
                 }
             } else if (inst->hasInstOpt(InstOpt::EOT)) {
                 // also treat EOT as the end of a BB
-                (void)getBlock(pc + instLen);
+                addBlockStart(pc + instLen);
             }
             pc += instLen;
         }
 
+        // build the sorted block index
+        std::sort(blockPcs.begin(), blockPcs.end());
+        blockPcs.erase(
+            std::unique(blockPcs.begin(), blockPcs.end()), blockPcs.end());
+        blockStarts.reserve(blockPcs.size());
+        for (int32_t blockPc : blockPcs) {
+            blockStarts.emplace_back(blockPc, new (allocator) Block(blockPc));
+        }
+
+        for (const LabelRef &lr : labelRefs) {
+            Operand &src = lr.inst->getSource(lr.srcIx);
+            src.setLabelSource(getBlock(lr.targetPc), src.getType());
+        }
+
         // for each block, we need to append the following instructions
         pc               = 0;
         auto bitr        = blockStarts.begin();
@@ -158,9 +194,11 @@ struct BlockInference
             pc += instLen;
         }
 
+        std::sort(instStarts.begin(), instStarts.end());
         for (const ResolvedTarget &rt : resolved) {
             if (rt.targetPc != binaryLength && // EOF is also a valid target
-                instStarts.find(rt.targetPc) == instStarts.end())
+                !std::binary_search(
+                    instStarts.begin(), instStarts.end(), rt.targetPc))
             {
                 std::stringstream ss;
                 ss << "src" << rt.srcIx <<
@@ -210,12 +248,12 @@ static void traceOperand(const Operand &op) {
 }
 #endif
 
-std::map<int32_t, Block *> Block::inferBlocks(
+BlockStarts Block::inferBlocks(
     ErrorHandler &errHandler,
     MemManager &mem,
     InstList &insts)
 {
-    std::map<int32_t, Block *> blockStarts;
+    BlockStarts blockStarts;
     BlockInference bi(blockStarts, &mem);
     int32_t binaryLength = 0;
     if (!insts.empty()) {
@@ -253,9 +291,9 @@ std::map<int32_t, Block *> Block::inferBlocks(
     return blockStarts;
 }
 
-void Block::insertInstBefore(
+InstList::iterator Block::insertInstBefore(
     InstList::iterator itr,
     Instruction *i)
 {
-    m_instructions.insert(itr, i);
+    return m_instructions.insert(itr, i) + 1;
 }
\ No newline at end of file
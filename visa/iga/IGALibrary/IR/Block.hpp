@@ -35,15 +35,22 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../ErrorHandler.hpp"
 #include "Instruction.hpp"
 
-#include <map>
-#include <list>
+#include <utility>
+#include <vector>
 
 namespace iga
 {
-    typedef std::list<
+    class Block;
+
+    // Instructions are stored contiguously; insertion invalidates iterators
+    // (see Block::insertInstBefore)
+    typedef std::vector<
        iga::Instruction*, std_arena_based_allocator<iga::Instruction*> > InstList;
     typedef InstList::iterator InstListIterator;
 
+    // block start offsets sorted by PC (as returned by Block::inferBlocks)
+    typedef std::vector<std::pair<int32_t,Block*>> BlockStarts;
+
     class Block
     {
     public:
@@ -78,12 +85,16 @@ namespace iga
         int                getID() const { return m_id; }
         const InstList&    getInstList() const { return m_instructions; }
               InstList&    getInstList()       { return m_instructions; }
-        void               insertInstBefore(InstList::iterator iter,
+        // inserts an instruction before 'iter'; since the underlying
+        // storage is a vector, this returns the new iterator to the
+        // element that 'iter' referenced (i.e. the one after 'inst')
+        InstList::iterator insertInstBefore(InstList::iterator iter,
                                             Instruction *inst);
 
         // infers the control flow graph
         // sets the Block* within these instructions
-        static std::map<int32_t,Block*> inferBlocks(
+        // the result is sorted by block PC
+        static BlockStarts inferBlocks(
             ErrorHandler &errHandler,
             MemManager& mem,
             InstList &insts);
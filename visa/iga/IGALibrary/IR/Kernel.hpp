@@ -37,10 +37,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Block.hpp"
 #include "Instruction.hpp"
 
-#include <list>
+#include <vector>
 
 namespace iga {
-    typedef std::list<
+    typedef std::vector<
         iga::Block*, std_arena_based_allocator<iga::Block*>> BlockList;
 
     class Kernel
@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RegDeps.hpp"
 #include "Traversals.hpp"
 #include "BitSet.hpp"
+#include <algorithm>
 #include <iterator>
 using namespace iga;
 
@@ -462,7 +463,7 @@ ret (16|M0)
 
 Right now mov will have false dependense on the first send.
 */
-void SWSBAnalyzer::clearSBIDDependence(InstList::iterator insertPoint, Instruction *lastInst, Block *bb)
+void SWSBAnalyzer::clearSBIDDependence(InstList::iterator &insertPoint, Instruction *lastInst, Block *bb)
 {
     bool sbidInUse = false;
     for (uint32_t i = 0; i < m_SBIDCount; ++i)
@@ -490,16 +491,8 @@ void SWSBAnalyzer::clearSBIDDependence(InstList::iterator insertPoint, Instructi
         auto clearRD = m_kernel.createSyncAllRdInstruction(distanceDependency);
         auto clearWR = m_kernel.createSyncAllWrInstruction(distanceDependency);
 
-        if (insertPoint == bb->getInstList().end())
-        {
-            bb->getInstList().push_back(clearRD);
-            bb->getInstList().push_back(clearWR);
-        }
-        else
-        {
-            bb->insertInstBefore(insertPoint, clearRD);
-            bb->insertInstBefore(insertPoint, clearWR);
-        }
+        insertPoint = bb->insertInstBefore(insertPoint, clearRD);
+        insertPoint = bb->insertInstBefore(insertPoint, clearWR);
     }
 }
 
@@ -553,7 +546,7 @@ void SWSBAnalyzer::clearBuckets(DepSet* input, DepSet* output) {
 }
 
 void SWSBAnalyzer::processActiveSBID(SWSB &distanceDependency, const DepSet* input,
-    Block *bb, InstList::iterator instIter, vector<SBID>& activeSBID)
+    Block *bb, InstList::iterator &instIter, vector<SBID>& activeSBID)
 {
     // If instruction depends on one or more SBIDS, first one goes in to SWSB field
     // for rest we generate wait instructions.
@@ -608,7 +601,7 @@ void SWSBAnalyzer::processActiveSBID(SWSB &distanceDependency, const DepSet* inp
             // add sync for the id
             SWSB sync_swsb(SWSB::DistType::NO_DIST, tType, 0, aSBID.sbid);
             auto nopInst = m_kernel.createSyncNopInstruction(sync_swsb);
-            bb->insertInstBefore(instIter, nopInst);
+            instIter = bb->insertInstBefore(instIter, nopInst);
         }
     }
 
@@ -619,7 +612,7 @@ void SWSBAnalyzer::processActiveSBID(SWSB &distanceDependency, const DepSet* inp
         SWSB sync_swsb(SWSB::DistType::NO_DIST, distanceDependency.tokenType, 0,
                         distanceDependency.sbid);
         auto nopInst = m_kernel.createSyncNopInstruction(sync_swsb);
-        bb->insertInstBefore(instIter, nopInst);
+        instIter = bb->insertInstBefore(instIter, nopInst);
         distanceDependency.tokenType = SWSB::TokenType::NOTOKEN;
         distanceDependency.sbid = 0;
     }
@@ -694,12 +687,15 @@ void SWSBAnalyzer::postProcess()
             }
         }
         // remove the redundant sync.nop (sync.nop with no swsb)
-        instList.remove_if([](const Instruction* inst) {
-            if (inst->getOp() == Op::SYNC_NOP &&
-                (!inst->getSWSB().hasSWSB()))
-                return true;
-            return false;
-        });
+        instList.erase(
+            std::remove_if(instList.begin(), instList.end(),
+                [](const Instruction* inst) {
+                    if (inst->getOp() == Op::SYNC_NOP &&
+                        (!inst->getSWSB().hasSWSB()))
+                        return true;
+                    return false;
+                }),
+            instList.end());
     }
 }
 
@@ -744,8 +740,9 @@ void SWSBAnalyzer::run()
         // resetting things for each bb
         lastBB = bb;
         InstList& instList  = bb->getInstList(); // Don't use auto for over loaded return which has const...
-        const auto instListEnd    = instList.end();
-        for (auto instIter = instList.begin(); instIter != instListEnd; ++instIter)
+        // syncs get inserted while walking, which invalidates the end
+        // iterator; so it must be re-read on each step
+        for (auto instIter = instList.begin(); instIter != instList.end(); ++instIter)
         {
             m_InstIdCounter.global++;
             inst = *instIter;
@@ -880,7 +877,7 @@ void SWSBAnalyzer::run()
                     SWSB tDep(SWSB::DistType::NO_DIST, distanceDependency.tokenType,
                                 0, distanceDependency.sbid);
                     Instruction* tInst = m_kernel.createSyncNopInstruction(tDep);
-                        bb->insertInstBefore(instIter, tInst);
+                        instIter = bb->insertInstBefore(instIter, tInst);
                 }
                 // set the sbid
                 distanceDependency.tokenType = SWSB::TokenType::SET;
@@ -894,7 +891,7 @@ void SWSBAnalyzer::run()
                     SWSB tDep(distanceDependency.distType, SWSB::TokenType::NOTOKEN,
                         distanceDependency.minDist, 0);
                     Instruction* tInst = m_kernel.createSyncNopInstruction(tDep);
-                        bb->insertInstBefore(instIter, tInst);
+                        instIter = bb->insertInstBefore(instIter, tInst);
                     distanceDependency.distType = SWSB::DistType::NO_DIST;
                     distanceDependency.minDist = 0;
                 }
@@ -905,7 +902,7 @@ void SWSBAnalyzer::run()
                     SWSB tDep(SWSB::DistType::NO_DIST, distanceDependency.tokenType,
                         0, distanceDependency.sbid);
                     Instruction* tInst = m_kernel.createSyncNopInstruction(tDep);
-                        bb->insertInstBefore(instIter, tInst);
+                        instIter = bb->insertInstBefore(instIter, tInst);
                 }
 
                 //record the sbid if it's math
@@ -981,7 +978,8 @@ void SWSBAnalyzer::run()
         //          clear read
         //          clear write
         if (blockEndsWithNonBranchInst) {
-            clearSBIDDependence(instList.end(), inst, bb);
+            auto insertPoint = instList.end();
+            clearSBIDDependence(insertPoint, inst, bb);
         }
     } //iterate on basic block
 
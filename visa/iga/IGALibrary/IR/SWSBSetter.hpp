@@ -33,6 +33,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../ErrorHandler.hpp"
 #include "RegDeps.hpp"
 
+#include <list>
+
 namespace iga
 {
     // Bucket represents a GRF and maps to all instructions that access it
@@ -124,13 +126,14 @@ namespace iga
         void processActiveSBID(SWSB &distanceDependency,
                                const DepSet* input,
                                Block *bb,
-                               InstList::iterator iter,
+                               InstList::iterator &iter,
                                vector<SBID>& activeSBID);
 
         // clear dependency of the given dep
         void clearDepBuckets(DepSet &dep);
         // clear all sbid, set ids to all free and insert sync to sync with all pipes
-        void clearSBIDDependence(InstList::iterator iter, Instruction *lastInst, Block *bb);
+        // (iter is updated to stay valid across the insertion)
+        void clearSBIDDependence(InstList::iterator &iter, Instruction *lastInst, Block *bb);
         // clear given input and output dependency in the buckets (for in-order pipes only)
         void clearBuckets(DepSet* input, DepSet* output);
 
@@ -34,6 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Frontend/Formatter.hpp"
 #include "../strings.hpp"
 
+#include <map>
 #include <sstream>
 
 
@@ -831,6 +831,9 @@ public:
     // For inline asm code generation
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaHeader, const std::string& visaText, const std::string& visaTextFile) = 0;
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaFile) = 0;
+    // Parse instructions-only vISA text straight into kernel. Variables are
+    // referenced by getVarName(); requires vISA_DirectInlineAsm.
+    VISA_BUILDER_API virtual int ParseVISAInlineAsm(VISAKernel* kernel, const std::string& asmText) = 0;
     VISA_BUILDER_API virtual int WriteVISAHeader() = 0;
     VISA_BUILDER_API virtual std::stringstream& GetAsmTextStream() = 0;
     VISA_BUILDER_API virtual std::stringstream& GetAsmTextHeaderStream() = 0;
@@ -437,8 +437,6 @@ void* allocCodeBlock(size_t sz)
 
 #ifndef DLL_MODE
 
-extern int CISAparse(CISA_IR_Builder* builder);
-
 void parseWrapper(const char *fileName, int argc, const char *argv[], Options &opt)
 {
     int num_kernels = 0;
@@ -495,12 +493,13 @@ void parseWrapper(const char *fileName, int argc, const char *argv[], Options &o
         }
 
         auto vISAFileName = file_names.front();
-        CISAin = fopen(vISAFileName.c_str(), "r");
-        if (!CISAin)
+        FILE* vISAFile = fopen(vISAFileName.c_str(), "r");
+        if (!vISAFile)
         {
             std::cerr <<  "Cannot open vISA assembly file: " << vISAFileName;
             exit(1);
         }
+        fclose(vISAFile);
 
         std::string::size_type testNameEnd = vISAFileName.find_last_of(".");
         std::string::size_type testNameStart = vISAFileName.find_last_of("\\");
@@ -516,8 +515,7 @@ void parseWrapper(const char *fileName, int argc, const char *argv[], Options &o
             testName = vISAFileName;
 
         CISAdebug = 0;
-        int fail = CISAparse(cisa_builder);
-        fclose(CISAin);
+        int fail = cisa_builder->ParseVISAText(vISAFileName) != VISA_SUCCESS;
         if (fail)
         {
             fprintf(stderr, "Error during parsing: VISAParse() exited with exit code %d\n", fail);